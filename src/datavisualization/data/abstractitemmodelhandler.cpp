@@ -28,13 +28,41 @@
 ****************************************************************************/
 
 #include "abstractitemmodelhandler_p.h"
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QSet>
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+static const int noRoleIndex = -1;
+
+// Resolves a model snapshot in the thread pool and notifies the handler when done
+class ItemModelResolveRunnable : public QRunnable
+{
+public:
+    ItemModelResolveRunnable(const QSharedPointer<ItemModelResolveTask> &task) : m_task(task) {}
+
+    void run()
+    {
+        m_task->resolve();
+        m_task->setFinished();
+        m_task->notifyReceiver();
+    }
+
+private:
+    QSharedPointer<ItemModelResolveTask> m_task;
+};
+
 AbstractItemModelHandler::AbstractItemModelHandler(QObject *parent)
     : QObject(parent),
       resolvePending(0),
-      m_fullReset(true)
+      m_fullReset(true),
+      m_asynchronous(false),
+      m_rowRole(noRoleIndex),
+      m_columnRole(noRoleIndex),
+      m_haveRowPattern(false),
+      m_haveColumnPattern(false)
 {
     m_resolveTimer.setSingleShot(true);
     QObject::connect(&m_resolveTimer, &QTimer::timeout,
@@ -43,6 +71,7 @@ AbstractItemModelHandler::AbstractItemModelHandler(QObject *parent)
 
 AbstractItemModelHandler::~AbstractItemModelHandler()
 {
+    cancelResolve();
 }
 
 void AbstractItemModelHandler::setItemModel(QAbstractItemModel *itemModel)
@@ -54,6 +83,27 @@ void AbstractItemModelHandler::setItemModel(QAbstractItemModel *itemModel)
         m_itemModel = itemModel;
 
         if (!m_itemModel.isNull()) {
+            // Any change invalidates a snapshot that is being resolved. These are connected
+            // first, so that the specific handlers already see the full reset pending.
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::columnsInserted,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::columnsMoved,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::columnsRemoved,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::dataChanged,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::layoutChanged,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::modelReset,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::rowsInserted,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::rowsMoved,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+            QObject::connect(m_itemModel.data(), &QAbstractItemModel::rowsRemoved,
+                             this, &AbstractItemModelHandler::handleModelChangedDuringResolve);
+
             QObject::connect(m_itemModel.data(), &QAbstractItemModel::columnsInserted,
                              this, &AbstractItemModelHandler::handleColumnsInserted);
             QObject::connect(m_itemModel.data(), &QAbstractItemModel::columnsMoved,
@@ -85,6 +135,16 @@ QAbstractItemModel *AbstractItemModelHandler::itemModel() const
     return m_itemModel.data();
 }
 
+void AbstractItemModelHandler::setAsynchronous(bool asynchronous)
+{
+    m_asynchronous = asynchronous;
+}
+
+bool AbstractItemModelHandler::isAsynchronous() const
+{
+    return m_asynchronous;
+}
+
 void AbstractItemModelHandler::handleColumnsInserted(const QModelIndex &parent,
                                                      int start, int end)
 {
@@ -237,4 +297,501 @@ void AbstractItemModelHandler::handlePendingResolve()
     m_fullReset = false;
 }
 
+void AbstractItemModelHandler::handleResolveFinished()
+{
+    // Notifications of cancelled tasks may still be queued, so only take finished current tasks
+    if (m_resolveTask.isNull() || !m_resolveTask->isFinished())
+        return;
+
+    QSharedPointer<ItemModelResolveTask> task = m_resolveTask;
+    m_resolveTask.clear();
+    applyResolveTask(task.data());
+}
+
+void AbstractItemModelHandler::handleModelChangedDuringResolve()
+{
+    // The snapshot being resolved is out of date, so drop it and take a new one
+    if (!m_resolveTask.isNull()) {
+        cancelResolve();
+        m_fullReset = true;
+        if (!m_resolveTimer.isActive())
+            m_resolveTimer.start(0);
+    }
+}
+
+// Takes a snapshot of the model and resolves it, either right away or in the thread pool.
+void AbstractItemModelHandler::resolveModel()
+{
+    cancelResolve();
+
+    QSharedPointer<ItemModelResolveTask> task(createResolveTask());
+    if (task.isNull())
+        return;
+
+    if (m_asynchronous) {
+        // The current data stays in the proxy until the new array is ready
+        task->setReceiver(this);
+        m_resolveTask = task;
+        QThreadPool::globalInstance()->start(new ItemModelResolveRunnable(task));
+    } else {
+        task->resolve();
+        task->setFinished();
+        applyResolveTask(task.data());
+    }
+}
+
+void AbstractItemModelHandler::cancelResolve()
+{
+    if (!m_resolveTask.isNull()) {
+        m_resolveTask->cancel();
+        m_resolveTask.clear();
+    }
+}
+
+// There is no point in applying changes directly if the model is going to be resolved again
+// anyway.
+bool AbstractItemModelHandler::canUpdateProxy() const
+{
+    return !m_resolveTimer.isActive() && isResolvedArrayInUse();
+}
+
+// Returns true if the proxy still holds the array the handler resolved last
+bool AbstractItemModelHandler::isResolvedArrayInUse() const
+{
+    return false;
+}
+
+// Returns false if the item has a category that would have to be generated
+bool AbstractItemModelHandler::mapToProxyItem(const QModelIndex &index, int &proxyItem) const
+{
+    QString rowCategory = index.data(m_rowRole).toString();
+    if (m_haveRowPattern)
+        rowCategory.replace(m_rowPattern, m_rowReplace);
+    QString columnCategory = index.data(m_columnRole).toString();
+    if (m_haveColumnPattern)
+        columnCategory.replace(m_columnPattern, m_columnReplace);
+
+    if ((m_categoryMapping.autoRowCategories() && !m_categoryMapping.hasRowCategory(rowCategory))
+            || (m_categoryMapping.autoColumnCategories()
+                && !m_categoryMapping.hasColumnCategory(columnCategory))) {
+        return false;
+    }
+
+    proxyItem = m_categoryMapping.proxyItem(rowCategory, columnCategory);
+    return true;
+}
+
+// Applies changed model items to the proxy items they map to. Returns false if the change
+// affects the categories, in which case the whole model needs to be resolved.
+bool AbstractItemModelHandler::updateCategoryItems(int startRow, int endRow, int startColumn,
+                                                   int endColumn)
+{
+    if (!canUpdateProxy() || !m_categoryMapping.matchesCategories())
+        return false;
+
+    int modelColumnCount = m_categoryMapping.modelColumnCount();
+    if (endColumn >= modelColumnCount
+            || (endRow + 1) * modelColumnCount > m_categoryMapping.modelItemCount()) {
+        return false;
+    }
+
+    QVector<int> changedItems;
+    bool targetsChanged = false;
+    for (int i = startRow; i <= endRow; i++) {
+        for (int j = startColumn; j <= endColumn; j++) {
+            int proxyItem;
+            if (!mapToProxyItem(m_itemModel->index(i, j), proxyItem))
+                return false;
+            int modelItem = i * modelColumnCount + j;
+            int oldProxyItem = m_categoryMapping.target(modelItem);
+            if (proxyItem != oldProxyItem) {
+                m_categoryMapping.setTarget(modelItem, proxyItem);
+                targetsChanged = true;
+                if (oldProxyItem >= 0)
+                    changedItems.append(oldProxyItem);
+            }
+            if (proxyItem >= 0)
+                changedItems.append(proxyItem);
+        }
+    }
+
+    if (targetsChanged && !m_categoryMapping.matchesCategories(changedItems))
+        return false;
+
+    updateProxyItems(changedItems);
+    return true;
+}
+
+bool AbstractItemModelHandler::insertCategoryItems(int start, int end)
+{
+    if (!canUpdateProxy() || !m_categoryMapping.matchesCategories())
+        return false;
+
+    int count = end - start + 1;
+    int modelColumnCount = m_categoryMapping.modelColumnCount();
+    if (m_itemModel->columnCount() != modelColumnCount
+            || m_categoryMapping.modelItemCount()
+               != (m_itemModel->rowCount() - count) * modelColumnCount) {
+        return false;
+    }
+
+    QVector<int> proxyItems;
+    proxyItems.reserve(count * modelColumnCount);
+    for (int i = start; i <= end; i++) {
+        for (int j = 0; j < modelColumnCount; j++) {
+            int proxyItem;
+            if (!mapToProxyItem(m_itemModel->index(i, j), proxyItem))
+                return false;
+            proxyItems.append(proxyItem);
+        }
+    }
+    m_categoryMapping.insertModelItems(start * modelColumnCount, proxyItems);
+    proxyItems.removeAll(-1);
+
+    if (!m_categoryMapping.matchesCategories(proxyItems))
+        return false;
+
+    updateProxyItems(proxyItems);
+    return true;
+}
+
+bool AbstractItemModelHandler::removeCategoryItems(int start, int end)
+{
+    if (!canUpdateProxy() || !m_categoryMapping.matchesCategories())
+        return false;
+
+    int count = end - start + 1;
+    int modelColumnCount = m_categoryMapping.modelColumnCount();
+    if (m_categoryMapping.modelItemCount()
+            != (m_itemModel->rowCount() + count) * modelColumnCount) {
+        return false;
+    }
+
+    QVector<int> changedItems;
+    m_categoryMapping.removeModelItems(start * modelColumnCount, count * modelColumnCount,
+                                       changedItems);
+
+    if (!m_categoryMapping.matchesCategories(changedItems))
+        return false;
+
+    updateProxyItems(changedItems);
+    return true;
+}
+
+// Recalculates the given proxy items from the model items mapped to them, the same way
+// resolving the whole model would.
+void AbstractItemModelHandler::updateProxyItems(QVector<int> &proxyItems)
+{
+    std::sort(proxyItems.begin(), proxyItems.end());
+    proxyItems.erase(std::unique(proxyItems.begin(), proxyItems.end()), proxyItems.end());
+
+    int proxyColumnCount = m_categoryMapping.proxyColumnCount();
+    foreach (int proxyItem, proxyItems) {
+        updateProxyItem(proxyItem / proxyColumnCount, proxyItem % proxyColumnCount,
+                        m_categoryMapping.sources(proxyItem));
+    }
+}
+
+// Sets the proxy item at the given row and column from the model items it was resolved from,
+// which are given in model order.
+void AbstractItemModelHandler::updateProxyItem(int row, int column, const QVector<int> &sources)
+{
+    Q_UNUSED(row)
+    Q_UNUSED(column)
+    Q_UNUSED(sources)
+}
+
+//  ItemModelResolveTask
+
+ItemModelResolveTask::ItemModelResolveTask()
+    : m_rowCount(0),
+      m_columnCount(0),
+      m_roleCount(0),
+      m_cancelled(0),
+      m_finished(0),
+      m_receiver(0)
+{
+}
+
+ItemModelResolveTask::~ItemModelResolveTask()
+{
+}
+
+// Copies the data of the given roles of all model items. This is the only part of resolving
+// that needs to access the model.
+void ItemModelResolveTask::takeSnapshot(const QAbstractItemModel *model, const QVector<int> &roles)
+{
+    m_rowCount = model->rowCount();
+    m_columnCount = model->columnCount();
+    m_roleCount = roles.size();
+    m_values.resize(m_rowCount * m_columnCount * m_roleCount);
+
+    QVariant *values = m_values.data();
+    const int *roleData = roles.constData();
+    for (int i = 0; i < m_rowCount; i++) {
+        for (int j = 0; j < m_columnCount; j++) {
+            QModelIndex index = model->index(i, j);
+            for (int k = 0; k < m_roleCount; k++)
+                *values++ = index.data(roleData[k]);
+        }
+    }
+}
+
+void ItemModelResolveTask::setReceiver(AbstractItemModelHandler *receiver)
+{
+    QMutexLocker locker(&m_mutex);
+    m_receiver = receiver;
+}
+
+void ItemModelResolveTask::notifyReceiver()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_receiver) {
+        QMetaObject::invokeMethod(m_receiver, "handleResolveFinished",
+                                  Qt::QueuedConnection);
+    }
+}
+
+void ItemModelResolveTask::cancel()
+{
+    m_cancelled.storeRelease(1);
+
+    // The receiver can be going away, so make sure it won't be notified anymore
+    QMutexLocker locker(&m_mutex);
+    m_receiver = 0;
+}
+
+bool ItemModelResolveTask::isCancelled() const
+{
+    return m_cancelled.loadAcquire();
+}
+
+void ItemModelResolveTask::setFinished()
+{
+    m_finished.storeRelease(1);
+}
+
+bool ItemModelResolveTask::isFinished() const
+{
+    return m_finished.loadAcquire();
+}
+
+//  ItemModelCategoryMapping
+
+ItemModelCategoryMapping::ItemModelCategoryMapping()
+    : m_proxyRowCount(0),
+      m_proxyColumnCount(0),
+      m_modelColumnCount(0),
+      m_untargetedCount(0),
+      m_autoRows(false),
+      m_autoColumns(false),
+      m_valid(false)
+{
+}
+
+void ItemModelCategoryMapping::reset(const QStringList &rowCategories,
+                                     const QStringList &columnCategories,
+                                     int modelColumnCount, bool autoRows, bool autoColumns)
+{
+    clear();
+
+    m_autoRows = autoRows;
+    m_autoColumns = autoColumns;
+    m_proxyRowCount = rowCategories.size();
+    m_proxyColumnCount = columnCategories.size();
+    m_modelColumnCount = modelColumnCount;
+    for (int i = 0; i < m_proxyRowCount; i++)
+        m_rowIndexes.insert(rowCategories.at(i), i);
+    for (int i = 0; i < m_proxyColumnCount; i++)
+        m_columnIndexes.insert(columnCategories.at(i), i);
+    m_itemSources.resize(m_proxyRowCount * m_proxyColumnCount);
+
+    // Duplicate categories would map the same model items to several proxy items
+    m_valid = m_rowIndexes.size() == m_proxyRowCount
+            && m_columnIndexes.size() == m_proxyColumnCount;
+}
+
+void ItemModelCategoryMapping::clear()
+{
+    m_rowIndexes.clear();
+    m_columnIndexes.clear();
+    m_proxyRowCount = 0;
+    m_proxyColumnCount = 0;
+    m_modelColumnCount = 0;
+    m_itemTargets.clear();
+    m_itemSources.clear();
+    m_untargetedCount = 0;
+    m_autoRows = false;
+    m_autoColumns = false;
+    m_valid = false;
+}
+
+int ItemModelCategoryMapping::proxyItem(const QString &rowCategory,
+                                        const QString &columnCategory) const
+{
+    int row = m_rowIndexes.value(rowCategory, -1);
+    int column = m_columnIndexes.value(columnCategory, -1);
+    if (row < 0 || column < 0)
+        return -1;
+    return row * m_proxyColumnCount + column;
+}
+
+// Model items must be appended in model order
+void ItemModelCategoryMapping::appendModelItem(int proxyItem)
+{
+    int modelItem = m_itemTargets.size();
+    m_itemTargets.append(proxyItem);
+    if (proxyItem >= 0)
+        m_itemSources[proxyItem].append(modelItem);
+    else
+        m_untargetedCount++;
+}
+
+void ItemModelCategoryMapping::setTarget(int modelItem, int proxyItem)
+{
+    int oldProxyItem = m_itemTargets.at(modelItem);
+    if (oldProxyItem == proxyItem)
+        return;
+
+    if (oldProxyItem >= 0)
+        removeSource(oldProxyItem, modelItem);
+    else
+        m_untargetedCount--;
+    if (proxyItem >= 0)
+        addSource(proxyItem, modelItem);
+    else
+        m_untargetedCount++;
+    m_itemTargets[modelItem] = proxyItem;
+}
+
+void ItemModelCategoryMapping::insertModelItems(int modelItem, const QVector<int> &proxyItems)
+{
+    int count = proxyItems.size();
+    shiftSources(modelItem, count);
+    m_itemTargets.insert(modelItem, count, -1);
+    m_untargetedCount += count;
+    for (int i = 0; i < count; i++)
+        setTarget(modelItem + i, proxyItems.at(i));
+}
+
+// Proxy items that lost sources are appended to affectedItems
+void ItemModelCategoryMapping::removeModelItems(int modelItem, int count,
+                                                QVector<int> &affectedItems)
+{
+    for (int i = modelItem; i < modelItem + count; i++) {
+        int proxyItem = m_itemTargets.at(i);
+        if (proxyItem >= 0) {
+            removeSource(proxyItem, i);
+            affectedItems.append(proxyItem);
+        } else {
+            m_untargetedCount--;
+        }
+    }
+    m_itemTargets.remove(modelItem, count);
+    shiftSources(modelItem + count, -count);
+}
+
+// Auto generated categories are ordered by their first appearance in the model, and a category
+// exists only if some model item has it. Returns false if the mapping no longer agrees with that,
+// in which case the categories need to be generated again.
+// The mapping is expected to have agreed before the sources of the given proxy items changed.
+// Inserting and removing model items never changes the order of the other sources, so only the
+// categories of the changed proxy items and their neighbors need to be checked.
+bool ItemModelCategoryMapping::matchesCategories(const QVector<int> &changedItems) const
+{
+    if (!m_valid)
+        return false;
+    if (!m_autoRows && !m_autoColumns)
+        return true;
+
+    // Model items outside the categories are not tracked, but may affect the generated ones
+    if (m_untargetedCount > 0)
+        return false;
+
+    QSet<int> checkedRows;
+    QSet<int> checkedColumns;
+    foreach (int proxyItem, changedItems) {
+        int row = proxyItem / m_proxyColumnCount;
+        int column = proxyItem % m_proxyColumnCount;
+        if (m_autoRows && !checkedRows.contains(row)) {
+            checkedRows.insert(row);
+            if (!isInOrder(true, row))
+                return false;
+        }
+        if (m_autoColumns && !checkedColumns.contains(column)) {
+            checkedColumns.insert(column);
+            if (!isInOrder(false, column))
+                return false;
+        }
+    }
+    return true;
+}
+
+void ItemModelCategoryMapping::addSource(int proxyItem, int modelItem)
+{
+    QVector<int> &sources = m_itemSources[proxyItem];
+    sources.insert(std::lower_bound(sources.begin(), sources.end(), modelItem), modelItem);
+}
+
+void ItemModelCategoryMapping::removeSource(int proxyItem, int modelItem)
+{
+    QVector<int> &sources = m_itemSources[proxyItem];
+    QVector<int>::iterator it = std::lower_bound(sources.begin(), sources.end(), modelItem);
+    if (it != sources.end() && *it == modelItem)
+        sources.erase(it);
+}
+
+// Adjusts the sources from the given model item onwards after model items have been inserted
+// or removed. The order of the sources does not change.
+void ItemModelCategoryMapping::shiftSources(int fromModelItem, int amount)
+{
+    for (int i = 0; i < m_itemSources.size(); i++) {
+        QVector<int> &sources = m_itemSources[i];
+        // Rows are usually added to or removed from the end, which leaves all sources as they are
+        if (sources.isEmpty() || sources.last() < fromModelItem)
+            continue;
+        QVector<int>::iterator it = std::lower_bound(sources.begin(), sources.end(),
+                                                     fromModelItem);
+        for (; it != sources.end(); ++it)
+            *it += amount;
+    }
+}
+
+int ItemModelCategoryMapping::firstSource(int proxyItem) const
+{
+    const QVector<int> &sources = m_itemSources.at(proxyItem);
+    return sources.isEmpty() ? -1 : sources.first();
+}
+
+// First model item of a row or column category, or -1 if the category has none
+int ItemModelCategoryMapping::firstCategorySource(bool rowCategory, int category) const
+{
+    int itemCount = rowCategory ? m_proxyColumnCount : m_proxyRowCount;
+    int proxyItem = rowCategory ? category * m_proxyColumnCount : category;
+    int step = rowCategory ? 1 : m_proxyColumnCount;
+    int first = -1;
+    for (int i = 0; i < itemCount; i++) {
+        int source = firstSource(proxyItem);
+        if (source >= 0 && (first < 0 || source < first))
+            first = source;
+        proxyItem += step;
+    }
+    return first;
+}
+
+// Checks that a row or column category has model items, and that it first appears after the
+// previous category and before the next one.
+bool ItemModelCategoryMapping::isInOrder(bool rowCategory, int category) const
+{
+    int categoryCount = rowCategory ? m_proxyRowCount : m_proxyColumnCount;
+    int first = firstCategorySource(rowCategory, category);
+    if (first < 0)
+        return false;
+    if (category > 0 && firstCategorySource(rowCategory, category - 1) >= first)
+        return false;
+    if (category < categoryCount - 1 && firstCategorySource(rowCategory, category + 1) <= first)
+        return false;
+    return true;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -42,11 +42,120 @@
 
 #include "datavisualizationglobal_p.h"
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QRegExp>
 #include <QtCore/QPointer>
 #include <QtCore/QTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class AbstractItemModelHandler;
+
+// Resolving an item model is split into taking a snapshot of the model data, which needs to
+// happen in the thread of the model, and turning the snapshot into a proxy array in resolve(),
+// which can happen in any thread.
+class ItemModelResolveTask
+{
+public:
+    ItemModelResolveTask();
+    virtual ~ItemModelResolveTask();
+
+    void takeSnapshot(const QAbstractItemModel *model, const QVector<int> &roles);
+    virtual void resolve() = 0;
+
+    void setReceiver(AbstractItemModelHandler *receiver);
+    void notifyReceiver();
+    void cancel();
+    bool isCancelled() const;
+    void setFinished();
+    bool isFinished() const;
+
+protected:
+    // Snapshot values of the roles given to takeSnapshot(), in the order they were given
+    inline const QVariant &value(int row, int column, int roleIndex) const
+    {
+        return m_values.at((row * m_columnCount + column) * m_roleCount + roleIndex);
+    }
+
+    int m_rowCount;
+    int m_columnCount;
+    int m_roleCount;
+    QVector<QVariant> m_values;
+
+private:
+    QAtomicInt m_cancelled;
+    QAtomicInt m_finished;
+    QMutex m_mutex;
+    AbstractItemModelHandler *m_receiver;
+
+    Q_DISABLE_COPY(ItemModelResolveTask)
+};
+
+// Maps the items of an item model to the proxy items they were resolved into, when proxy rows
+// and columns come from role based categories. Model items are indexed in row-major order and
+// proxy items likewise, so that model changes can be applied to the affected proxy items only.
+class ItemModelCategoryMapping
+{
+public:
+    ItemModelCategoryMapping();
+
+    void reset(const QStringList &rowCategories, const QStringList &columnCategories,
+               int modelColumnCount, bool autoRows, bool autoColumns);
+    void clear();
+    inline bool isValid() const { return m_valid; }
+    inline bool autoRowCategories() const { return m_autoRows; }
+    inline bool autoColumnCategories() const { return m_autoColumns; }
+
+    int proxyItem(const QString &rowCategory, const QString &columnCategory) const;
+    inline bool hasRowCategory(const QString &category) const
+    {
+        return m_rowIndexes.contains(category);
+    }
+    inline bool hasColumnCategory(const QString &category) const
+    {
+        return m_columnIndexes.contains(category);
+    }
+    inline int proxyColumnCount() const { return m_proxyColumnCount; }
+    inline int modelColumnCount() const { return m_modelColumnCount; }
+    inline int modelItemCount() const { return m_itemTargets.size(); }
+    // Proxy item of a model item, -1 if the model item doesn't map to any
+    inline int target(int modelItem) const { return m_itemTargets.at(modelItem); }
+    // Model items resolved into a proxy item, in model order
+    inline const QVector<int> &sources(int proxyItem) const
+    {
+        return m_itemSources.at(proxyItem);
+    }
+
+    void appendModelItem(int proxyItem);
+    void setTarget(int modelItem, int proxyItem);
+    void insertModelItems(int modelItem, const QVector<int> &proxyItems);
+    void removeModelItems(int modelItem, int count, QVector<int> &affectedItems);
+    bool matchesCategories(const QVector<int> &changedItems = QVector<int>()) const;
+
+private:
+    void addSource(int proxyItem, int modelItem);
+    void removeSource(int proxyItem, int modelItem);
+    void shiftSources(int fromModelItem, int amount);
+    int firstSource(int proxyItem) const;
+    int firstCategorySource(bool rowCategory, int category) const;
+    bool isInOrder(bool rowCategory, int category) const;
+
+    QHash<QString, int> m_rowIndexes;
+    QHash<QString, int> m_columnIndexes;
+    int m_proxyRowCount;
+    int m_proxyColumnCount;
+    int m_modelColumnCount;
+    QVector<int> m_itemTargets;
+    QVector<QVector<int> > m_itemSources;
+    int m_untargetedCount;
+    bool m_autoRows;
+    bool m_autoColumns;
+    bool m_valid;
+};
+
 class AbstractItemModelHandler : public QObject
 {
     Q_OBJECT
@@ -56,6 +165,8 @@ public:
 
     virtual void setItemModel(QAbstractItemModel *itemModel);
     virtual QAbstractItemModel *itemModel() const;
+    void setAsynchronous(bool asynchronous);
+    bool isAsynchronous() const;
 
 public Q_SLOTS:
     virtual void handleColumnsInserted(const QModelIndex &parent, int start, int end);
@@ -75,17 +186,53 @@ public Q_SLOTS:
 
     virtual void handleMappingChanged();
     virtual void handlePendingResolve();
+    void handleResolveFinished();
+    void handleModelChangedDuringResolve();
 
 Q_SIGNALS:
     void itemModelChanged(const QAbstractItemModel *itemModel);
 
 protected:
-    virtual void resolveModel() = 0;
+    virtual void resolveModel();
+    // Returns null if there is nothing to resolve, in which case the proxy has been reset already
+    virtual ItemModelResolveTask *createResolveTask() = 0;
+    virtual void applyResolveTask(ItemModelResolveTask *task) = 0;
+    void cancelResolve();
+
+    // Changes can only be applied directly to the array the handler resolved last
+    bool canUpdateProxy() const;
+    virtual bool isResolvedArrayInUse() const;
+
+    // Incremental updates of proxies with role based categories. The subclasses write the
+    // proxy items in updateProxyItem().
+    bool mapToProxyItem(const QModelIndex &index, int &proxyItem) const;
+    bool updateCategoryItems(int startRow, int endRow, int startColumn, int endColumn);
+    bool insertCategoryItems(int start, int end);
+    bool removeCategoryItems(int start, int end);
+    void updateProxyItems(QVector<int> &proxyItems);
+    virtual void updateProxyItem(int row, int column, const QVector<int> &sources);
+    inline QModelIndex sourceIndex(int modelItem) const
+    {
+        int modelColumnCount = m_categoryMapping.modelColumnCount();
+        return m_itemModel->index(modelItem / modelColumnCount, modelItem % modelColumnCount);
+    }
 
     QPointer<QAbstractItemModel> m_itemModel;  // Not owned
     bool resolvePending;
     QTimer m_resolveTimer;
     bool m_fullReset;
+    bool m_asynchronous;
+    QSharedPointer<ItemModelResolveTask> m_resolveTask;
+    // Category roles and patterns are needed for mapping changed items in role category mode
+    int m_rowRole;
+    int m_columnRole;
+    QRegExp m_rowPattern;
+    QRegExp m_columnPattern;
+    QString m_rowReplace;
+    QString m_columnReplace;
+    bool m_haveRowPattern;
+    bool m_haveColumnPattern;
+    ItemModelCategoryMapping m_categoryMapping;
 
 private:
     Q_DISABLE_COPY(AbstractItemModelHandler)
@@ -48,12 +48,14 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+// Render items are never deleted through a base class pointer, so the destructor is not
+// virtual. This keeps a vtable pointer out of every item of large scatter series.
 class AbstractRenderItem
 {
 public:
     AbstractRenderItem();
     AbstractRenderItem(const AbstractRenderItem &other);
-    virtual ~AbstractRenderItem();
+    ~AbstractRenderItem();
 
     // Position in 3D scene
     inline void setTranslation(const QVector3D &translation) { m_translation = translation; }
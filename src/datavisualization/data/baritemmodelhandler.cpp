@@ -55,249 +55,495 @@ void BarItemModelHandler::handleDataChanged(const QModelIndex &topLeft,
 {
     // Do nothing if full reset already pending
     if (!m_fullReset) {
-        if (!m_proxy->useModelCategories()) {
-            // If the data model doesn't directly map rows and columns, we cannot optimize
+        int startRow = qMin(topLeft.row(), bottomRight.row());
+        int endRow = qMax(topLeft.row(), bottomRight.row());
+        int startCol = qMin(topLeft.column(), bottomRight.column());
+        int endCol = qMax(topLeft.column(), bottomRight.column());
+
+        if (m_proxy->useModelCategories()) {
+            updateModelRows(startRow, endRow, startCol, endCol);
+        } else if (!updateCategoryItems(startRow, endRow, startCol, endCol)) {
+            m_categoryMapping.clear();
             AbstractItemModelHandler::handleDataChanged(topLeft, bottomRight, roles);
+        }
+    }
+}
+
+void BarItemModelHandler::handleRowsInserted(const QModelIndex &parent, int start, int end)
+{
+    // Do nothing if full reset already pending
+    if (!m_fullReset) {
+        bool handled = m_proxy->useModelCategories() ? insertModelRows(start, end)
+                                                     : insertCategoryItems(start, end);
+        if (!handled) {
+            m_categoryMapping.clear();
+            AbstractItemModelHandler::handleRowsInserted(parent, start, end);
+        }
+    }
+}
+
+void BarItemModelHandler::handleRowsRemoved(const QModelIndex &parent, int start, int end)
+{
+    // Do nothing if full reset already pending
+    if (!m_fullReset) {
+        bool handled = m_proxy->useModelCategories() ? removeModelRows(start, end)
+                                                     : removeCategoryItems(start, end);
+        if (!handled) {
+            m_categoryMapping.clear();
+            AbstractItemModelHandler::handleRowsRemoved(parent, start, end);
+        }
+    }
+}
+
+bool BarItemModelHandler::isResolvedArrayInUse() const
+{
+    return m_proxyArray && m_proxyArray == m_proxy->array();
+}
+
+void BarItemModelHandler::resolveItem(const QModelIndex &index, QBarDataItem &item) const
+{
+    QVariant valueVar = index.data(m_valueRole);
+    float value;
+    if (m_haveValuePattern)
+        value = valueVar.toString().replace(m_valuePattern, m_valueReplace).toFloat();
+    else
+        value = valueVar.toFloat();
+    item.setValue(value);
+    if (m_rotationRole != noRoleIndex) {
+        QVariant rotationVar = index.data(m_rotationRole);
+        float rotation;
+        if (m_haveRotationPattern) {
+            rotation = rotationVar.toString().replace(m_rotationPattern,
+                                                      m_rotationReplace).toFloat();
         } else {
-            int startRow = qMin(topLeft.row(), bottomRight.row());
-            int endRow = qMax(topLeft.row(), bottomRight.row());
-            int startCol = qMin(topLeft.column(), bottomRight.column());
-            int endCol = qMax(topLeft.column(), bottomRight.column());
-
-            for (int i = startRow; i <= endRow; i++) {
-                for (int j = startCol; j <= endCol; j++) {
-                    QModelIndex index = m_itemModel->index(i, j);
-                    QBarDataItem item;
-                    QVariant valueVar = index.data(m_valueRole);
-                    float value;
-                    if (m_haveValuePattern)
-                        value = valueVar.toString().replace(m_valuePattern, m_valueReplace).toFloat();
-                    else
-                        value = valueVar.toFloat();
-                    item.setValue(value);
-                    if (m_rotationRole != noRoleIndex) {
-                        QVariant rotationVar = index.data(m_rotationRole);
-                        float rotation;
-                        if (m_haveRotationPattern) {
-                            rotation = rotationVar.toString().replace(m_rotationPattern,
-                                                                      m_rotationReplace).toFloat();
-                        } else {
-                            rotation = rotationVar.toFloat();
-                        }
-                        item.setRotation(rotation);
-                    }
-                    m_proxy->setItem(i, j, item);
-                }
+            rotation = rotationVar.toFloat();
+        }
+        item.setRotation(rotation);
+    }
+}
+
+void BarItemModelHandler::updateModelRows(int startRow, int endRow, int startColumn,
+                                          int endColumn)
+{
+    if (startColumn == 0 && endColumn == m_columnCount - 1 && canUpdateProxy()
+            && endRow < m_proxyArray->size()) {
+        // Whole rows changed, so replace them with a single notification
+        QBarDataArray rows;
+        rows.reserve(endRow - startRow + 1);
+        for (int i = startRow; i <= endRow; i++) {
+            QBarDataRow *row = new QBarDataRow(m_columnCount);
+            for (int j = 0; j < m_columnCount; j++)
+                resolveItem(m_itemModel->index(i, j), (*row)[j]);
+            rows.append(row);
+        }
+        m_proxy->setRows(startRow, rows);
+    } else {
+        for (int i = startRow; i <= endRow; i++) {
+            for (int j = startColumn; j <= endColumn; j++) {
+                QBarDataItem item;
+                resolveItem(m_itemModel->index(i, j), item);
+                m_proxy->setItem(i, j, item);
             }
         }
     }
 }
 
-// Resolve entire item model into QBarDataArray.
-void BarItemModelHandler::resolveModel()
+// Model rows map directly to proxy rows, so inserted rows can be inserted as such
+bool BarItemModelHandler::insertModelRows(int start, int end)
+{
+    int count = end - start + 1;
+    if (!canUpdateProxy() || m_columnCount != m_itemModel->columnCount()
+            || m_proxyArray->size() != m_itemModel->rowCount() - count) {
+        return false;
+    }
+
+    QBarDataArray rows;
+    QStringList labels;
+    rows.reserve(count);
+    for (int i = start; i <= end; i++) {
+        QBarDataRow *row = new QBarDataRow(m_columnCount);
+        for (int j = 0; j < m_columnCount; j++)
+            resolveItem(m_itemModel->index(i, j), (*row)[j]);
+        rows.append(row);
+        labels << m_itemModel->headerData(i, Qt::Vertical).toString();
+    }
+    m_proxy->insertRows(start, rows, labels);
+    updateRowLabels(end + 1);
+
+    return true;
+}
+
+bool BarItemModelHandler::removeModelRows(int start, int end)
+{
+    int count = end - start + 1;
+    if (!canUpdateProxy() || m_proxyArray->size() != m_itemModel->rowCount() + count)
+        return false;
+
+    m_proxy->removeRows(start, count);
+    updateRowLabels(start);
+
+    return true;
+}
+
+// Headers of the rows following inserted or removed rows may have changed, e.g. if they are
+// just row numbers.
+void BarItemModelHandler::updateRowLabels(int startRow)
+{
+    QStringList labels = m_proxy->rowLabels();
+    bool changed = false;
+    int rowCount = qMin(labels.size(), m_itemModel->rowCount());
+    for (int i = startRow; i < rowCount; i++) {
+        QString header = m_itemModel->headerData(i, Qt::Vertical).toString();
+        if (labels.at(i) != header) {
+            labels[i] = header;
+            changed = true;
+        }
+    }
+    if (changed)
+        m_proxy->setRowLabels(labels);
+}
+
+void BarItemModelHandler::updateProxyItem(int row, int column, const QVector<int> &sources)
+{
+    QItemModelBarDataProxy::MultiMatchBehavior behavior = m_proxy->multiMatchBehavior();
+    bool cumulative = behavior == QItemModelBarDataProxy::MMBAverage
+            || behavior == QItemModelBarDataProxy::MMBCumulative;
+    bool countMatches = behavior == QItemModelBarDataProxy::MMBAverage;
+    bool takeFirst = behavior == QItemModelBarDataProxy::MMBFirst;
+
+    float value = 0.0f;
+    float rotation = 0.0f;
+    if (!sources.isEmpty()) {
+        int first = cumulative ? 0 : (takeFirst ? 0 : sources.size() - 1);
+        int last = cumulative ? sources.size() - 1 : first;
+        for (int i = first; i <= last; i++) {
+            QBarDataItem item;
+            resolveItem(sourceIndex(sources.at(i)), item);
+            value += item.value();
+            rotation += item.rotation();
+        }
+    }
+    if (countMatches) {
+        value /= float(sources.size());
+        rotation /= float(sources.size());
+    }
+
+    QBarDataItem item;
+    item.setValue(value);
+    if (m_rotationRole != noRoleIndex)
+        item.setRotation(rotation);
+    m_proxy->setItem(row, column, item);
+}
+
+// Take a snapshot of the entire item model for resolving it into QBarDataArray.
+ItemModelResolveTask *BarItemModelHandler::createResolveTask()
 {
     if (m_itemModel.isNull()) {
         m_proxy->resetArray(0);
-        return;
+        return 0;
     }
 
     if (!m_proxy->useModelCategories()
             && (m_proxy->rowRole().isEmpty() || m_proxy->columnRole().isEmpty())) {
         m_proxy->resetArray(0);
-        return;
+        return 0;
     }
 
-    // Value and rotation patterns can be reused on single item changes,
-    // so store them to member variables.
-    QRegExp rowPattern(m_proxy->rowRolePattern());
-    QRegExp colPattern(m_proxy->columnRolePattern());
+    BarItemModelResolveTask *task = new BarItemModelResolveTask;
+
+    // Patterns can be reused on single item changes, so store them to member variables.
+    m_rowPattern = m_proxy->rowRolePattern();
+    m_columnPattern = m_proxy->columnRolePattern();
     m_valuePattern = m_proxy->valueRolePattern();
     m_rotationPattern = m_proxy->rotationRolePattern();
-    QString rowReplace = m_proxy->rowRoleReplace();
-    QString colReplace = m_proxy->columnRoleReplace();
+    m_rowReplace = m_proxy->rowRoleReplace();
+    m_columnReplace = m_proxy->columnRoleReplace();
     m_valueReplace = m_proxy->valueRoleReplace();
     m_rotationReplace = m_proxy->rotationRoleReplace();
-    bool haveRowPattern = !rowPattern.isEmpty() && rowPattern.isValid();
-    bool haveColPattern = !colPattern.isEmpty() && colPattern.isValid();
+    m_haveRowPattern = !m_rowPattern.isEmpty() && m_rowPattern.isValid();
+    m_haveColumnPattern = !m_columnPattern.isEmpty() && m_columnPattern.isValid();
     m_haveValuePattern = !m_valuePattern.isEmpty() && m_valuePattern.isValid();
     m_haveRotationPattern = !m_rotationPattern.isEmpty() && m_rotationPattern.isValid();
-
-    QStringList rowLabels;
-    QStringList columnLabels;
+    task->m_rowPattern = m_rowPattern;
+    task->m_colPattern = m_columnPattern;
+    task->m_rowReplace = m_rowReplace;
+    task->m_colReplace = m_columnReplace;
+    task->m_haveRowPattern = m_haveRowPattern;
+    task->m_haveColPattern = m_haveColumnPattern;
+    task->m_valuePattern = m_valuePattern;
+    task->m_rotationPattern = m_rotationPattern;
+    task->m_valueReplace = m_valueReplace;
+    task->m_rotationReplace = m_rotationReplace;
+    task->m_haveValuePattern = m_haveValuePattern;
+    task->m_haveRotationPattern = m_haveRotationPattern;
 
     QHash<int, QByteArray> roleHash = m_itemModel->roleNames();
 
     // Default value role to display role if no mapping
     m_valueRole = roleHash.key(m_proxy->valueRole().toLatin1(), Qt::DisplayRole);
     m_rotationRole = roleHash.key(m_proxy->rotationRole().toLatin1(), noRoleIndex);
-    int rowCount = m_itemModel->rowCount();
-    int columnCount = m_itemModel->columnCount();
-
-    if (m_proxy->useModelCategories()) {
-        // If dimensions have changed, recreate the array
-        if (m_proxyArray != m_proxy->array() || columnCount != m_columnCount
-                || rowCount != m_proxyArray->size()) {
-            m_proxyArray = new QBarDataArray;
-            m_proxyArray->reserve(rowCount);
-            for (int i = 0; i < rowCount; i++)
-                m_proxyArray->append(new QBarDataRow(columnCount));
-        }
-        for (int i = 0; i < rowCount; i++) {
-            QBarDataRow &newProxyRow = *m_proxyArray->at(i);
-            for (int j = 0; j < columnCount; j++) {
-                QModelIndex index = m_itemModel->index(i, j);
-                QVariant valueVar = index.data(m_valueRole);
-                float value;
-                if (m_haveValuePattern)
-                    value = valueVar.toString().replace(m_valuePattern, m_valueReplace).toFloat();
-                else
-                    value = valueVar.toFloat();
-                newProxyRow[j].setValue(value);
-                if (m_rotationRole != noRoleIndex) {
-                    QVariant rotationVar = index.data(m_rotationRole);
-                    float rotation;
-                    if (m_haveRotationPattern) {
-                        rotation = rotationVar.toString().replace(m_rotationPattern,
-                                                                  m_rotationReplace).toFloat();
-                    } else {
-                        rotation = rotationVar.toFloat();
-                    }
-                    newProxyRow[j].setRotation(rotation);
-                }
-            }
-        }
+    m_rowRole = roleHash.key(m_proxy->rowRole().toLatin1());
+    m_columnRole = roleHash.key(m_proxy->columnRole().toLatin1());
+
+    QVector<int> roles;
+    task->m_useModelCategories = m_proxy->useModelCategories();
+    if (task->m_useModelCategories) {
         // Generate labels from headers if using model rows/columns
+        int rowCount = m_itemModel->rowCount();
+        int columnCount = m_itemModel->columnCount();
         for (int i = 0; i < rowCount; i++)
-            rowLabels << m_itemModel->headerData(i, Qt::Vertical).toString();
+            task->m_rowLabels << m_itemModel->headerData(i, Qt::Vertical).toString();
         for (int i = 0; i < columnCount; i++)
-            columnLabels << m_itemModel->headerData(i, Qt::Horizontal).toString();
-        m_columnCount = columnCount;
+            task->m_columnLabels << m_itemModel->headerData(i, Qt::Horizontal).toString();
     } else {
-        int rowRole = roleHash.key(m_proxy->rowRole().toLatin1());
-        int columnRole = roleHash.key(m_proxy->columnRole().toLatin1());
-
-        bool generateRows = m_proxy->autoRowCategories();
-        bool generateColumns = m_proxy->autoColumnCategories();
-        QStringList rowList;
-        QStringList columnList;
-        // For detecting duplicates in categories generation, using QHashes should be faster than
-        // simple QStringList::contains() check.
-        QHash<QString, bool> rowListHash;
-        QHash<QString, bool> columnListHash;
-
-        // Sort values into rows and columns
-        typedef QHash<QString, float> ColumnValueMap;
-        QHash<QString, ColumnValueMap> itemValueMap;
-        QHash<QString, ColumnValueMap> itemRotationMap;
-
-        bool cumulative = m_proxy->multiMatchBehavior() == QItemModelBarDataProxy::MMBAverage
-                || m_proxy->multiMatchBehavior() == QItemModelBarDataProxy::MMBCumulative;
-        bool countMatches = m_proxy->multiMatchBehavior() == QItemModelBarDataProxy::MMBAverage;
-        bool takeFirst = m_proxy->multiMatchBehavior() == QItemModelBarDataProxy::MMBFirst;
-        QHash<QString, QHash<QString, int> > *matchCountMap = 0;
-        if (countMatches)
-            matchCountMap = new QHash<QString, QHash<QString, int> >;
-
-        for (int i = 0; i < rowCount; i++) {
-            for (int j = 0; j < columnCount; j++) {
-                QModelIndex index = m_itemModel->index(i, j);
-                QString rowRoleStr = index.data(rowRole).toString();
-                if (haveRowPattern)
-                    rowRoleStr.replace(rowPattern, rowReplace);
-                QString columnRoleStr = index.data(columnRole).toString();
-                if (haveColPattern)
-                    columnRoleStr.replace(colPattern, colReplace);
-                QVariant valueVar = index.data(m_valueRole);
-                float value;
-                if (m_haveValuePattern)
-                    value = valueVar.toString().replace(m_valuePattern, m_valueReplace).toFloat();
-                else
-                    value = valueVar.toFloat();
-                if (countMatches)
-                    (*matchCountMap)[rowRoleStr][columnRoleStr]++;
+        task->m_rowRoleIndex = roles.size();
+        roles.append(m_rowRole);
+        task->m_columnRoleIndex = roles.size();
+        roles.append(m_columnRole);
 
-                if (cumulative) {
-                    itemValueMap[rowRoleStr][columnRoleStr] += value;
-                } else {
-                    if (takeFirst && itemValueMap.contains(rowRoleStr)) {
-                        if (itemValueMap.value(rowRoleStr).contains(columnRoleStr))
-                            continue; // We already have a value for this row/column combo
-                    }
-                    itemValueMap[rowRoleStr][columnRoleStr] = value;
-                }
+        task->m_generateRows = m_proxy->autoRowCategories();
+        task->m_generateColumns = m_proxy->autoColumnCategories();
+        if (!task->m_generateRows)
+            task->m_rowLabels = m_proxy->rowCategories();
+        if (!task->m_generateColumns)
+            task->m_columnLabels = m_proxy->columnCategories();
+        task->m_multiMatchBehavior = m_proxy->multiMatchBehavior();
+    }
+    task->m_valueRoleIndex = roles.size();
+    roles.append(m_valueRole);
+    if (m_rotationRole != noRoleIndex) {
+        task->m_rotationRoleIndex = roles.size();
+        roles.append(m_rotationRole);
+    }
 
-                if (m_rotationRole != noRoleIndex) {
-                    QVariant rotationVar = index.data(m_rotationRole);
-                    float rotation;
-                    if (m_haveRotationPattern) {
-                        rotation = rotationVar.toString().replace(m_rotationPattern,
-                                                                  m_rotationReplace).toFloat();
-                    } else {
-                        rotation = rotationVar.toFloat();
-                    }
-                    if (cumulative) {
-                        itemRotationMap[rowRoleStr][columnRoleStr] += rotation;
-                    } else {
-                        // We know we are in take last mode if we get here,
-                        // as take first mode skips to next loop already earlier
-                        itemRotationMap[rowRoleStr][columnRoleStr] = rotation;
-                    }
-                }
-                if (generateRows && !rowListHash.value(rowRoleStr, false)) {
-                    rowListHash.insert(rowRoleStr, true);
-                    rowList << rowRoleStr;
-                }
-                if (generateColumns && !columnListHash.value(columnRoleStr, false)) {
-                    columnListHash.insert(columnRoleStr, true);
-                    columnList << columnRoleStr;
-                }
+    // Existing array can only be written to directly when resolving right away
+    if (!m_asynchronous && isResolvedArrayInUse())
+        task->m_reuseArray = m_proxyArray;
+
+    task->takeSnapshot(m_itemModel.data(), roles);
+
+    return task;
+}
+
+void BarItemModelHandler::applyResolveTask(ItemModelResolveTask *task)
+{
+    BarItemModelResolveTask *barTask = static_cast<BarItemModelResolveTask *>(task);
+
+    if (!barTask->m_useModelCategories) {
+        if (barTask->m_generateRows)
+            m_proxy->dptr()->m_rowCategories = barTask->m_rowLabels;
+        if (barTask->m_generateColumns)
+            m_proxy->dptr()->m_columnCategories = barTask->m_columnLabels;
+    }
+
+    m_categoryMapping = barTask->m_mapping;
+    m_proxyArray = barTask->takeArray();
+    m_columnCount = barTask->m_columnLabels.size();
+    m_proxy->resetArray(m_proxyArray, barTask->m_rowLabels, barTask->m_columnLabels);
+}
+
+//  BarItemModelResolveTask
+
+BarItemModelResolveTask::BarItemModelResolveTask()
+    : m_useModelCategories(false),
+      m_rowRoleIndex(noRoleIndex),
+      m_columnRoleIndex(noRoleIndex),
+      m_valueRoleIndex(noRoleIndex),
+      m_rotationRoleIndex(noRoleIndex),
+      m_haveRowPattern(false),
+      m_haveColPattern(false),
+      m_haveValuePattern(false),
+      m_haveRotationPattern(false),
+      m_generateRows(false),
+      m_generateColumns(false),
+      m_multiMatchBehavior(QItemModelBarDataProxy::MMBLast),
+      m_reuseArray(0),
+      m_array(0)
+{
+}
+
+BarItemModelResolveTask::~BarItemModelResolveTask()
+{
+    if (m_array && m_array != m_reuseArray) {
+        qDeleteAll(*m_array);
+        delete m_array;
+    }
+}
+
+void BarItemModelResolveTask::resolve()
+{
+    if (m_useModelCategories)
+        resolveModelCategories();
+    else
+        resolveRoleCategories();
+}
+
+QBarDataArray *BarItemModelResolveTask::takeArray()
+{
+    QBarDataArray *array = m_array;
+    m_array = 0;
+    return array;
+}
+
+// If dimensions have changed, recreate the array
+QBarDataArray *BarItemModelResolveTask::arrayForSize(int rowCount, int columnCount)
+{
+    if (m_reuseArray && m_reuseArray->size() == rowCount
+            && (!rowCount || m_reuseArray->at(0)->size() == columnCount)) {
+        return m_reuseArray;
+    }
+
+    QBarDataArray *array = new QBarDataArray;
+    array->reserve(rowCount);
+    for (int i = 0; i < rowCount; i++)
+        array->append(new QBarDataRow(columnCount));
+    return array;
+}
+
+float BarItemModelResolveTask::toFloat(const QVariant &variant, bool havePattern,
+                                       const QRegExp &pattern, const QString &replace)
+{
+    if (havePattern)
+        return variant.toString().replace(pattern, replace).toFloat();
+    else
+        return variant.toFloat();
+}
+
+void BarItemModelResolveTask::resolveModelCategories()
+{
+    m_array = arrayForSize(m_rowCount, m_columnCount);
+
+    for (int i = 0; i < m_rowCount; i++) {
+        if (isCancelled())
+            return;
+        QBarDataRow &newProxyRow = *m_array->at(i);
+        for (int j = 0; j < m_columnCount; j++) {
+            newProxyRow[j].setValue(toFloat(value(i, j, m_valueRoleIndex), m_haveValuePattern,
+                                            m_valuePattern, m_valueReplace));
+            if (m_rotationRoleIndex != noRoleIndex) {
+                newProxyRow[j].setRotation(toFloat(value(i, j, m_rotationRoleIndex),
+                                                   m_haveRotationPattern, m_rotationPattern,
+                                                   m_rotationReplace));
             }
         }
+    }
+}
+
+void BarItemModelResolveTask::resolveRoleCategories()
+{
+    QStringList rowList;
+    QStringList columnList;
+    // For detecting duplicates in categories generation, using QHashes should be faster than
+    // simple QStringList::contains() check.
+    QHash<QString, bool> rowListHash;
+    QHash<QString, bool> columnListHash;
+
+    // Sort values into rows and columns
+    typedef QHash<QString, float> ColumnValueMap;
+    QHash<QString, ColumnValueMap> itemValueMap;
+    QHash<QString, ColumnValueMap> itemRotationMap;
+
+    bool cumulative = m_multiMatchBehavior == QItemModelBarDataProxy::MMBAverage
+            || m_multiMatchBehavior == QItemModelBarDataProxy::MMBCumulative;
+    bool countMatches = m_multiMatchBehavior == QItemModelBarDataProxy::MMBAverage;
+    bool takeFirst = m_multiMatchBehavior == QItemModelBarDataProxy::MMBFirst;
+    QHash<QString, QHash<QString, int> > *matchCountMap = 0;
+    if (countMatches)
+        matchCountMap = new QHash<QString, QHash<QString, int> >;
+
+    // Categories of each model item, for mapping model items to proxy items
+    QStringList itemRowCategories;
+    QStringList itemColumnCategories;
+    itemRowCategories.reserve(m_rowCount * m_columnCount);
+    itemColumnCategories.reserve(m_rowCount * m_columnCount);
 
-        if (generateRows)
-            m_proxy->dptr()->m_rowCategories = rowList;
-        else
-            rowList = m_proxy->rowCategories();
-
-        if (generateColumns)
-            m_proxy->dptr()->m_columnCategories = columnList;
-        else
-            columnList = m_proxy->columnCategories();
-
-        // If dimensions have changed, recreate the array
-        if (m_proxyArray != m_proxy->array() || columnList.size() != m_columnCount
-                || rowList.size() != m_proxyArray->size()) {
-            m_proxyArray = new QBarDataArray;
-            m_proxyArray->reserve(rowList.size());
-            for (int i = 0; i < rowList.size(); i++)
-                m_proxyArray->append(new QBarDataRow(columnList.size()));
+    for (int i = 0; i < m_rowCount; i++) {
+        if (isCancelled()) {
+            delete matchCountMap;
+            return;
         }
-        // Create new data array from itemValueMap
-        for (int i = 0; i < rowList.size(); i++) {
-            QString rowKey = rowList.at(i);
-            QBarDataRow &newProxyRow = *m_proxyArray->at(i);
-            for (int j = 0; j < columnList.size(); j++) {
-                float value = itemValueMap[rowKey][columnList.at(j)];
-                if (countMatches)
-                    value /= float((*matchCountMap)[rowKey][columnList.at(j)]);
-                newProxyRow[j].setValue(value);
-                if (m_rotationRole != noRoleIndex) {
-                    float angle = itemRotationMap[rowKey][columnList.at(j)];
-                    if (countMatches)
-                        angle /= float((*matchCountMap)[rowKey][columnList.at(j)]);
-                    newProxyRow[j].setRotation(angle);
+        for (int j = 0; j < m_columnCount; j++) {
+            QString rowRoleStr = value(i, j, m_rowRoleIndex).toString();
+            if (m_haveRowPattern)
+                rowRoleStr.replace(m_rowPattern, m_rowReplace);
+            QString columnRoleStr = value(i, j, m_columnRoleIndex).toString();
+            if (m_haveColPattern)
+                columnRoleStr.replace(m_colPattern, m_colReplace);
+            itemRowCategories << rowRoleStr;
+            itemColumnCategories << columnRoleStr;
+            float itemValue = toFloat(value(i, j, m_valueRoleIndex), m_haveValuePattern,
+                                      m_valuePattern, m_valueReplace);
+            if (countMatches)
+                (*matchCountMap)[rowRoleStr][columnRoleStr]++;
+
+            if (cumulative) {
+                itemValueMap[rowRoleStr][columnRoleStr] += itemValue;
+            } else {
+                if (takeFirst && itemValueMap.contains(rowRoleStr)) {
+                    if (itemValueMap.value(rowRoleStr).contains(columnRoleStr))
+                        continue; // We already have a value for this row/column combo
+                }
+                itemValueMap[rowRoleStr][columnRoleStr] = itemValue;
+            }
+
+            if (m_rotationRoleIndex != noRoleIndex) {
+                float rotation = toFloat(value(i, j, m_rotationRoleIndex), m_haveRotationPattern,
+                                         m_rotationPattern, m_rotationReplace);
+                if (cumulative) {
+                    itemRotationMap[rowRoleStr][columnRoleStr] += rotation;
+                } else {
+                    // We know we are in take last mode if we get here,
+                    // as take first mode skips to next loop already earlier
+                    itemRotationMap[rowRoleStr][columnRoleStr] = rotation;
                 }
             }
+            if (m_generateRows && !rowListHash.value(rowRoleStr, false)) {
+                rowListHash.insert(rowRoleStr, true);
+                rowList << rowRoleStr;
+            }
+            if (m_generateColumns && !columnListHash.value(columnRoleStr, false)) {
+                columnListHash.insert(columnRoleStr, true);
+                columnList << columnRoleStr;
+            }
         }
+    }
+
+    if (m_generateRows)
+        m_rowLabels = rowList;
+    else
+        rowList = m_rowLabels;
+
+    if (m_generateColumns)
+        m_columnLabels = columnList;
+    else
+        columnList = m_columnLabels;
 
-        rowLabels = rowList;
-        columnLabels = columnList;
-        m_columnCount = columnList.size();
+    m_array = arrayForSize(rowList.size(), columnList.size());
 
-        delete matchCountMap;
+    // Create new data array from itemValueMap
+    for (int i = 0; i < rowList.size(); i++) {
+        QString rowKey = rowList.at(i);
+        QBarDataRow &newProxyRow = *m_array->at(i);
+        for (int j = 0; j < columnList.size(); j++) {
+            float itemValue = itemValueMap[rowKey][columnList.at(j)];
+            if (countMatches)
+                itemValue /= float((*matchCountMap)[rowKey][columnList.at(j)]);
+            newProxyRow[j].setValue(itemValue);
+            if (m_rotationRoleIndex != noRoleIndex) {
+                float angle = itemRotationMap[rowKey][columnList.at(j)];
+                if (countMatches)
+                    angle /= float((*matchCountMap)[rowKey][columnList.at(j)]);
+                newProxyRow[j].setRotation(angle);
+            }
+        }
     }
 
-    m_proxy->resetArray(m_proxyArray, rowLabels, columnLabels);
+    delete matchCountMap;
+
+    m_mapping.reset(rowList, columnList, m_columnCount, m_generateRows, m_generateColumns);
+    for (int i = 0; i < itemRowCategories.size(); i++)
+        m_mapping.appendModelItem(m_mapping.proxyItem(itemRowCategories.at(i),
+                                                      itemColumnCategories.at(i)));
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -45,6 +45,57 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class BarItemModelResolveTask : public ItemModelResolveTask
+{
+public:
+    BarItemModelResolveTask();
+    virtual ~BarItemModelResolveTask();
+
+    virtual void resolve();
+    QBarDataArray *takeArray();
+
+private:
+    void resolveModelCategories();
+    void resolveRoleCategories();
+    QBarDataArray *arrayForSize(int rowCount, int columnCount);
+    static float toFloat(const QVariant &variant, bool havePattern, const QRegExp &pattern,
+                         const QString &replace);
+
+    bool m_useModelCategories;
+    // Snapshot role indexes, -1 if the role is not in the snapshot
+    int m_rowRoleIndex;
+    int m_columnRoleIndex;
+    int m_valueRoleIndex;
+    int m_rotationRoleIndex;
+
+    QRegExp m_rowPattern;
+    QRegExp m_colPattern;
+    QRegExp m_valuePattern;
+    QRegExp m_rotationPattern;
+    QString m_rowReplace;
+    QString m_colReplace;
+    QString m_valueReplace;
+    QString m_rotationReplace;
+    bool m_haveRowPattern;
+    bool m_haveColPattern;
+    bool m_haveValuePattern;
+    bool m_haveRotationPattern;
+
+    bool m_generateRows;
+    bool m_generateColumns;
+    QItemModelBarDataProxy::MultiMatchBehavior m_multiMatchBehavior;
+
+    // Array that can be written to directly if the dimensions do not change. Not owned.
+    QBarDataArray *m_reuseArray;
+    QBarDataArray *m_array;
+    // Model headers or categories, depending on the mode
+    QStringList m_rowLabels;
+    QStringList m_columnLabels;
+    ItemModelCategoryMapping m_mapping;
+
+    friend class BarItemModelHandler;
+};
+
 class BarItemModelHandler : public AbstractItemModelHandler
 {
     Q_OBJECT
@@ -55,9 +106,19 @@ public:
 public Q_SLOTS:
     virtual void handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
                                    const QVector<int> &roles = QVector<int> ());
+    virtual void handleRowsInserted(const QModelIndex &parent, int start, int end);
+    virtual void handleRowsRemoved(const QModelIndex &parent, int start, int end);
 
 protected:
-    void virtual resolveModel();
+    virtual ItemModelResolveTask *createResolveTask();
+    virtual void applyResolveTask(ItemModelResolveTask *task);
+    virtual bool isResolvedArrayInUse() const;
+    virtual void updateProxyItem(int row, int column, const QVector<int> &sources);
+    void resolveItem(const QModelIndex &index, QBarDataItem &item) const;
+    void updateModelRows(int startRow, int endRow, int startColumn, int endColumn);
+    bool insertModelRows(int start, int end);
+    bool removeModelRows(int start, int end);
+    void updateRowLabels(int startRow);
 
     QItemModelBarDataProxy *m_proxy; // Not owned
     QBarDataArray *m_proxyArray; // Not owned
@@ -688,6 +688,11 @@ QAbstractDataProxy *QAbstract3DSeriesPrivate::dataProxy() const
     return m_dataProxy;
 }
 
+QAbstractDataProxyPrivate *QAbstract3DSeriesPrivate::dataProxyPrivate() const
+{
+    return m_dataProxy ? m_dataProxy->d_ptr.data() : 0;
+}
+
 void QAbstract3DSeriesPrivate::setDataProxy(QAbstractDataProxy *proxy)
 {
     Q_ASSERT(proxy && proxy != m_dataProxy && !proxy->d_ptr->series());
@@ -754,8 +759,11 @@ void QAbstract3DSeriesPrivate::setMeshRotation(const QQuaternion &rotation)
     if (m_controller) {
         m_controller->markSeriesVisualsDirty();
 
-        if (m_controller->optimizationHints().testFlag(QAbstract3DGraph::OptimizationStatic))
+        // Series rotation is baked into the buffered item data in static and instanced modes
+        if (m_controller->optimizationHints() & (QAbstract3DGraph::OptimizationStatic
+                                                 | QAbstract3DGraph::OptimizationInstanced)) {
             m_controller->markDataDirty();
+        }
     }
 }
 
@@ -46,6 +46,7 @@
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 class QAbstractDataProxy;
+class QAbstractDataProxyPrivate;
 class Abstract3DController;
 
 struct QAbstract3DSeriesChangeBitField {
@@ -114,6 +115,7 @@ public:
     virtual ~QAbstract3DSeriesPrivate();
 
     QAbstractDataProxy *dataProxy() const;
+    QAbstractDataProxyPrivate *dataProxyPrivate() const;
     virtual void setDataProxy(QAbstractDataProxy *proxy);
     virtual void setController(Abstract3DController *controller);
     virtual void connectControllerAndProxy(Abstract3DController *newController) = 0;
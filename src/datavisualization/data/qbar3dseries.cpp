@@ -346,6 +346,8 @@ void QBar3DSeriesPrivate::connectControllerAndProxy(Abstract3DController *newCon
                          &Bars3DController::handleRowsInserted);
         QObject::connect(barDataProxy, &QBarDataProxy::itemChanged, controller,
                          &Bars3DController::handleItemChanged);
+        QObject::connect(barDataProxy, &QBarDataProxy::rowsShifted, controller,
+                         &Bars3DController::handleRowsShifted);
         QObject::connect(barDataProxy, &QBarDataProxy::rowLabelsChanged, controller,
                          &Bars3DController::handleDataRowLabelsChanged);
         QObject::connect(barDataProxy, &QBarDataProxy::columnLabelsChanged, controller,
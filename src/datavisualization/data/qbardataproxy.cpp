@@ -123,6 +123,7 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 QBarDataProxy::QBarDataProxy(QObject *parent) :
     QAbstractDataProxy(new QBarDataProxyPrivate(this), parent)
 {
+    dptr()->connectBoundsTracking();
 }
 
 /*!
@@ -131,6 +132,7 @@ QBarDataProxy::QBarDataProxy(QObject *parent) :
 QBarDataProxy::QBarDataProxy(QBarDataProxyPrivate *d, QObject *parent) :
     QAbstractDataProxy(d, parent)
 {
+    dptr()->connectBoundsTracking();
 }
 
 /*!
@@ -383,6 +385,95 @@ void QBarDataProxy::removeRows(int rowIndex, int removeCount, bool removeLabels)
     }
 }
 
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new row \a row to the end of the array and removes the first row,
+ * so that the number of rows stays the same. The label of the first row is
+ * removed as well, so the remaining row labels move along with their rows.
+ * If the array is empty, the row is added to it.
+ *
+ * This is intended for scrolling data, where a new row is added on each
+ * update and the oldest row drops out. The graph only needs to process the
+ * new row instead of the whole array.
+ *
+ * \sa shiftRows(), rowsShifted()
+ */
+void QBarDataProxy::shiftRow(QBarDataRow *row)
+{
+    QBarDataArray rows;
+    rows.append(row);
+    shiftRows(rows);
+}
+
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new row \a row with the label \a label to the end of the array and
+ * removes the first row and its label, so that the number of rows stays the
+ * same. If the array is empty, the row is added to it.
+ *
+ * \sa shiftRows(), rowsShifted()
+ */
+void QBarDataProxy::shiftRow(QBarDataRow *row, const QString &label)
+{
+    QBarDataArray rows;
+    rows.append(row);
+    shiftRows(rows, QStringList(label));
+}
+
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new \a rows to the end of the array and removes the same number of
+ * rows and their labels from the beginning of it, so that the number of rows
+ * stays the same.
+ *
+ * If \a rows holds at least as many rows as the array, the array is reset to
+ * contain just the new rows and arrayReset() is emitted instead of
+ * rowsShifted().
+ *
+ * \sa shiftRow(), rowsShifted()
+ */
+void QBarDataProxy::shiftRows(const QBarDataArray &rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    if (rows.size() >= rowCount()) {
+        resetArray(new QBarDataArray(rows), QStringList(), columnLabels());
+    } else {
+        dptr()->shiftRows(rows, 0);
+        emit rowsShifted(rows.size());
+    }
+}
+
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new \a rows with \a labels to the end of the array and removes the
+ * same number of rows and their labels from the beginning of it, so that the
+ * number of rows stays the same.
+ *
+ * If \a rows holds at least as many rows as the array, the array is reset to
+ * contain just the new rows and arrayReset() is emitted instead of
+ * rowsShifted().
+ *
+ * \sa shiftRow(), rowsShifted()
+ */
+void QBarDataProxy::shiftRows(const QBarDataArray &rows, const QStringList &labels)
+{
+    if (rows.isEmpty())
+        return;
+
+    if (rows.size() >= rowCount()) {
+        resetArray(new QBarDataArray(rows), labels, columnLabels());
+    } else {
+        dptr()->shiftRows(rows, &labels);
+        emit rowsShifted(rows.size());
+    }
+}
+
 /*!
  * \property QBarDataProxy::rowCount
  *
@@ -541,6 +632,18 @@ const QBarDataProxyPrivate *QBarDataProxy::dptrc() const
  * insertRows(), this signal needs to be emitted to update the graph.
  */
 
+/*!
+ * \fn void QBarDataProxy::rowsShifted(int count)
+ * \since QtDataVisualization 1.3
+ *
+ * This signal is emitted when the number of rows specified by \a count is
+ * added to the end of the array and the same number of rows is removed from
+ * the beginning of it.
+ *
+ * If rows are shifted in the array without calling shiftRow() or
+ * shiftRows(), this signal needs to be emitted to update the graph.
+ */
+
 /*!
  * \fn void QBarDataProxy::itemChanged(int rowIndex, int columnIndex)
  *
@@ -554,7 +657,11 @@ const QBarDataProxyPrivate *QBarDataProxy::dptrc() const
 
 QBarDataProxyPrivate::QBarDataProxyPrivate(QBarDataProxy *q)
     : QAbstractDataProxyPrivate(q, QAbstractDataProxy::DataTypeBar),
-      m_dataArray(new QBarDataArray)
+      m_dataArray(new QBarDataArray),
+      m_minValue(0.0f),
+      m_maxValue(0.0f),
+      m_boundsDirty(true),
+      m_boundsReleased(false)
 {
 }
 
@@ -587,6 +694,9 @@ void QBarDataProxyPrivate::setRow(int rowIndex, QBarDataRow *row, const QString
     if (label)
         fixRowLabels(rowIndex, 1, QStringList(*label), false);
     if (row != m_dataArray->at(rowIndex)) {
+        // A row set again in place may have been modified, so only replaced rows are released
+        releaseBounds(m_dataArray->at(rowIndex));
+        m_boundsReleased = true;
         clearRow(rowIndex);
         (*m_dataArray)[rowIndex] = row;
     }
@@ -599,13 +709,18 @@ void QBarDataProxyPrivate::setRows(int rowIndex, const QBarDataArray &rows,
     Q_ASSERT(rowIndex >= 0 && (rowIndex + rows.size()) <= dataArray.size());
     if (labels)
         fixRowLabels(rowIndex, rows.size(), *labels, false);
+    bool allReplaced = true;
     for (int i = 0; i < rows.size(); i++) {
         if (rows.at(i) != dataArray.at(rowIndex)) {
+            releaseBounds(dataArray.at(rowIndex));
             clearRow(rowIndex);
             dataArray[rowIndex] = rows.at(i);
+        } else {
+            allReplaced = false;
         }
         rowIndex++;
     }
+    m_boundsReleased = allReplaced;
 }
 
 void QBarDataProxyPrivate::setItem(int rowIndex, int columnIndex, const QBarDataItem &item)
@@ -613,6 +728,8 @@ void QBarDataProxyPrivate::setItem(int rowIndex, int columnIndex, const QBarData
     Q_ASSERT(rowIndex >= 0 && rowIndex < m_dataArray->size());
     QBarDataRow &row = *(*m_dataArray)[rowIndex];
     Q_ASSERT(columnIndex < row.size());
+    releaseBounds(row.at(columnIndex).value());
+    m_boundsReleased = true;
     row[columnIndex] = item;
 }
 
@@ -659,7 +776,9 @@ void QBarDataProxyPrivate::removeRows(int rowIndex, int removeCount, bool remove
     int maxRemoveCount = m_dataArray->size() - rowIndex;
     removeCount = qMin(removeCount, maxRemoveCount);
     bool labelsChanged = false;
+    m_boundsReleased = true;
     for (int i = 0; i < removeCount; i++) {
+        releaseBounds(m_dataArray->at(rowIndex));
         clearRow(rowIndex);
         m_dataArray->removeAt(rowIndex);
         if (removeLabels && m_rowLabels.size() > rowIndex) {
@@ -671,11 +790,165 @@ void QBarDataProxyPrivate::removeRows(int rowIndex, int removeCount, bool remove
         emit qptr()->rowLabelsChanged();
 }
 
+void QBarDataProxyPrivate::shiftRows(const QBarDataArray &rows, const QStringList *labels)
+{
+    Q_ASSERT(rows.size() < m_dataArray->size());
+
+    int shiftCount = rows.size();
+    m_boundsReleased = true;
+    for (int i = 0; i < shiftCount; i++) {
+        releaseBounds(m_dataArray->at(i));
+        clearRow(i);
+    }
+    m_dataArray->erase(m_dataArray->begin(), m_dataArray->begin() + shiftCount);
+    int firstNewRow = m_dataArray->size();
+    *m_dataArray += rows;
+
+    int removeLabelCount = qMin(shiftCount, m_rowLabels.size());
+    bool labelsChanged = removeLabelCount > 0;
+    m_rowLabels.erase(m_rowLabels.begin(), m_rowLabels.begin() + removeLabelCount);
+    if (labels && !labels->isEmpty()) {
+        // Labels past the old label array, so fill the intervening space with empty strings
+        while (m_rowLabels.size() < firstNewRow)
+            m_rowLabels << QString();
+        m_rowLabels << labels->mid(0, shiftCount);
+        labelsChanged = true;
+    }
+    if (labelsChanged)
+        emit qptr()->rowLabelsChanged();
+}
+
 QBarDataProxy *QBarDataProxyPrivate::qptr()
 {
     return static_cast<QBarDataProxy *>(q_ptr);
 }
 
+void QBarDataProxyPrivate::connectBoundsTracking()
+{
+    // These connections are made before any controller connects to the proxy, so the
+    // bounds are always current by the time the controller adjusts the axis ranges.
+    QBarDataProxy *q = qptr();
+    QObject::connect(q, &QBarDataProxy::arrayReset,
+                     this, &QBarDataProxyPrivate::handleArrayReset);
+    QObject::connect(q, &QBarDataProxy::rowsAdded,
+                     this, &QBarDataProxyPrivate::handleRowsAdded);
+    QObject::connect(q, &QBarDataProxy::rowsChanged,
+                     this, &QBarDataProxyPrivate::handleRowsChanged);
+    QObject::connect(q, &QBarDataProxy::rowsRemoved,
+                     this, &QBarDataProxyPrivate::handleRowsRemoved);
+    QObject::connect(q, &QBarDataProxy::rowsInserted,
+                     this, &QBarDataProxyPrivate::handleRowsInserted);
+    QObject::connect(q, &QBarDataProxy::itemChanged,
+                     this, &QBarDataProxyPrivate::handleItemChanged);
+    QObject::connect(q, &QBarDataProxy::rowsShifted,
+                     this, &QBarDataProxyPrivate::handleRowsShifted);
+}
+
+void QBarDataProxyPrivate::handleArrayReset()
+{
+    m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QBarDataProxyPrivate::handleRowsAdded(int startIndex, int count)
+{
+    addBounds(startIndex, count);
+}
+
+void QBarDataProxyPrivate::handleRowsChanged(int startIndex, int count)
+{
+    // Rows changed directly in the array may have held an extreme value that is now gone
+    if (m_boundsReleased)
+        addBounds(startIndex, count);
+    else
+        m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QBarDataProxyPrivate::handleRowsRemoved(int startIndex, int count)
+{
+    Q_UNUSED(startIndex)
+    Q_UNUSED(count)
+
+    if (!m_boundsReleased)
+        m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QBarDataProxyPrivate::handleRowsInserted(int startIndex, int count)
+{
+    addBounds(startIndex, count);
+}
+
+void QBarDataProxyPrivate::handleItemChanged(int rowIndex, int columnIndex)
+{
+    if (m_boundsReleased && rowIndex >= 0 && rowIndex < m_dataArray->size()) {
+        const QBarDataRow *row = m_dataArray->at(rowIndex);
+        if (row && columnIndex >= 0 && columnIndex < row->size())
+            addBounds(row->at(columnIndex).value());
+    } else {
+        m_boundsDirty = true;
+    }
+    m_boundsReleased = false;
+}
+
+void QBarDataProxyPrivate::handleRowsShifted(int count)
+{
+    // Rows shifted directly in the array may have held an extreme value that is now gone
+    if (m_boundsReleased)
+        addBounds(m_dataArray->size() - count, count);
+    else
+        m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QBarDataProxyPrivate::rebuildBounds() const
+{
+    m_minValue = 0.0f;
+    m_maxValue = 0.0f;
+    m_boundsDirty = false;
+
+    addBounds(0, m_dataArray->size());
+}
+
+void QBarDataProxyPrivate::addBounds(int startIndex, int count) const
+{
+    if (m_boundsDirty)
+        return;
+
+    const int endIndex = qMin(startIndex + count, m_dataArray->size());
+    for (int i = qMax(startIndex, 0); i < endIndex; i++) {
+        const QBarDataRow *row = m_dataArray->at(i);
+        if (row) {
+            for (int j = 0; j < row->size(); j++)
+                addBounds(row->at(j).value());
+        }
+    }
+}
+
+void QBarDataProxyPrivate::addBounds(float value) const
+{
+    if (m_maxValue < value)
+        m_maxValue = value;
+    if (m_minValue > value)
+        m_minValue = value;
+}
+
+void QBarDataProxyPrivate::releaseBounds(const QBarDataRow *row)
+{
+    if (row) {
+        for (int j = 0; j < row->size() && !m_boundsDirty; j++)
+            releaseBounds(row->at(j).value());
+    }
+}
+
+void QBarDataProxyPrivate::releaseBounds(float value)
+{
+    // The next extreme is not known without a rescan. Zero is always within the bounds.
+    if ((value > 0.0f && value == m_maxValue) || (value < 0.0f && value == m_minValue))
+        m_boundsDirty = true;
+}
+
 void QBarDataProxyPrivate::clearRow(int rowIndex)
 {
     if (m_dataArray->at(rowIndex)) {
@@ -763,6 +1036,23 @@ QPair<GLfloat, GLfloat> QBarDataProxyPrivate::limitValues(int startRow, int endR
 {
     QPair<GLfloat, GLfloat> limits = qMakePair(0.0f, 0.0f);
     endRow = qMin(endRow, m_dataArray->size() - 1);
+
+    // The tracked bounds apply when the whole array is covered, which is the case
+    // whenever the category axes are adjusted automatically
+    bool wholeArray = (startRow <= 0 && endRow == m_dataArray->size() - 1 && startColumn <= 0);
+    for (int i = 0; wholeArray && i <= endRow; i++) {
+        const QBarDataRow *row = m_dataArray->at(i);
+        if (row && row->size() - 1 > endColumn)
+            wholeArray = false;
+    }
+    if (wholeArray) {
+        if (m_boundsDirty)
+            rebuildBounds();
+        limits.first = m_minValue;
+        limits.second = m_maxValue;
+        return limits;
+    }
+
     for (int i = startRow; i <= endRow; i++) {
         QBarDataRow *row = m_dataArray->at(i);
         if (row) {
@@ -96,6 +96,11 @@ public:
 
     void removeRows(int rowIndex, int removeCount, bool removeLabels = true);
 
+    void shiftRow(QBarDataRow *row);
+    void shiftRow(QBarDataRow *row, const QString &label);
+    void shiftRows(const QBarDataArray &rows);
+    void shiftRows(const QBarDataArray &rows, const QStringList &labels);
+
 Q_SIGNALS:
     void arrayReset();
     void rowsAdded(int startIndex, int count);
@@ -103,6 +108,7 @@ Q_SIGNALS:
     void rowsRemoved(int startIndex, int count);
     void rowsInserted(int startIndex, int count);
     void itemChanged(int rowIndex, int columnIndex);
+    void rowsShifted(int count);
 
     void rowCountChanged(int count);
     void rowLabelsChanged();
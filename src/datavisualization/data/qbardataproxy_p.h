@@ -62,22 +62,47 @@ public:
     void insertRow(int rowIndex, QBarDataRow *row, const QString *label);
     void insertRows(int rowIndex, const QBarDataArray &rows, const QStringList *labels);
     void removeRows(int rowIndex, int removeCount, bool removeLabels);
+    void shiftRows(const QBarDataArray &rows, const QStringList *labels);
 
     QPair<GLfloat, GLfloat> limitValues(int startRow, int startColumn, int rowCount,
                                         int columnCount) const;
 
     virtual void setSeries(QAbstract3DSeries *series);
 
+public Q_SLOTS:
+    void handleArrayReset();
+    void handleRowsAdded(int startIndex, int count);
+    void handleRowsChanged(int startIndex, int count);
+    void handleRowsRemoved(int startIndex, int count);
+    void handleRowsInserted(int startIndex, int count);
+    void handleItemChanged(int rowIndex, int columnIndex);
+    void handleRowsShifted(int count);
+
 private:
     QBarDataProxy *qptr();
     void clearRow(int rowIndex);
     void clearArray();
     void fixRowLabels(int startIndex, int count, const QStringList &newLabels, bool isInsert);
+    void connectBoundsTracking();
+    void rebuildBounds() const;
+    void addBounds(int startIndex, int count) const;
+    void addBounds(float value) const;
+    void releaseBounds(const QBarDataRow *row);
+    void releaseBounds(float value);
 
     QBarDataArray *m_dataArray;
     QStringList m_rowLabels;
     QStringList m_columnLabels;
 
+    // Value extents of the whole array, including zero, maintained on mutation. A full
+    // rescan is only needed after an extreme value has been overwritten or removed.
+    mutable float m_minValue;
+    mutable float m_maxValue;
+    mutable bool m_boundsDirty;
+    // Set when the rows or item about to be changed or removed have already been released
+    // from the bounds, i.e. the change came through the proxy rather than direct array access
+    bool m_boundsReleased;
+
 private:
     friend class QBarDataProxy;
 };
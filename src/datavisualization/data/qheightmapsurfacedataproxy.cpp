@@ -28,6 +28,11 @@
 ****************************************************************************/
 
 #include "qheightmapsurfacedataproxy_p.h"
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+#include <QtCore/QDebug>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -35,6 +40,43 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 const float defaultMinValue = 0.0f;
 const float defaultMaxValue = 10.0f;
 
+// Height maps smaller than this are resolved right away, as handing them over to the thread
+// pool would cost more than resolving them.
+const qint64 asyncResolvePixelThreshold = 512 * 512;
+// Minimum number of image rows resolved as a single band
+const int minResolveBandSize = 16;
+
+// Resolves a height map in the thread pool and notifies the proxy when done
+class HeightMapResolveTask : public QRunnable
+{
+public:
+    HeightMapResolveTask(const QSharedPointer<HeightMapResolveJob> &job) : m_job(job) {}
+
+    void run()
+    {
+        HeightMapResolveJob::resolve(m_job);
+        m_job->notifyReceiver();
+    }
+
+private:
+    QSharedPointer<HeightMapResolveJob> m_job;
+};
+
+// Helps resolving the bands of a height map job
+class HeightMapResolveBandTask : public QRunnable
+{
+public:
+    HeightMapResolveBandTask(const QSharedPointer<HeightMapResolveJob> &job) : m_job(job) {}
+
+    void run()
+    {
+        m_job->resolveBands();
+    }
+
+private:
+    QSharedPointer<HeightMapResolveJob> m_job;
+};
+
 /*!
  * \class QHeightMapSurfaceDataProxy
  * \inmodule QtDataVisualization
@@ -82,9 +124,10 @@ const float defaultMaxValue = 10.0f;
  * and you should try converting the image yourself before setting it. Preferred format is
  * QImage::Format_RGB32 in grayscale.
  *
- * The height of the image is read from the red component of the pixels if the image is in grayscale,
- * otherwise it is an average calculated from red, green and blue components of the pixels. Using
- * grayscale images may improve data conversion speed for large images.
+ * The height of the image is an average calculated from red, green and blue components of the
+ * pixels, which for grayscale pixels is the value of any single component. Images in
+ * QImage::Format_Grayscale8 format are read directly. Large height maps are resolved in a
+ * background thread.
  *
  * Since height maps do not contain values for X or Z axes, those values need to be given
  * separately using minXValue, maxXValue, minZValue, and maxZValue properties. X-value corresponds
@@ -190,18 +233,20 @@ QHeightMapSurfaceDataProxy::~QHeightMapSurfaceDataProxy()
  * and you should try converting the \a image yourself before setting it. Preferred format is
  * QImage::Format_RGB32 in grayscale.
  *
- * The height of the \a image is read from the red component of the pixels if the \a image is in
- * grayscale, otherwise it is an average calculated from red, green, and blue components of the
- * pixels. Using grayscale images may improve data conversion speed for large images.
+ * The height of the \a image is an average calculated from red, green, and blue components of
+ * the pixels, which for grayscale pixels is the value of any single component. Images in
+ * QImage::Format_Grayscale8 format are read directly.
  *
  * Not recommended formats: all mono formats (for example QImage::Format_Mono).
  *
  * The height map is resolved asynchronously. QSurfaceDataProxy::arrayReset() is emitted when the
- * data has been resolved.
+ * data has been resolved. Large height maps are resolved in a background thread, split over
+ * several threads, and the current data is kept until the new data is ready.
  */
 void QHeightMapSurfaceDataProxy::setHeightMap(const QImage &image)
 {
     dptr()->m_heightMap = image;
+    dptr()->m_rawFile.clear();
 
     // We do resolving asynchronously to make qml onArrayReset handlers actually get the initial reset
     if (!dptr()->m_resolveTimer.isActive())
@@ -237,6 +282,84 @@ QString QHeightMapSurfaceDataProxy::heightMapFile() const
     return dptrc()->m_heightMapFile;
 }
 
+/*!
+ * \enum QHeightMapSurfaceDataProxy::RawDataFormat
+ * \since QtDataVisualization 1.3
+ *
+ * The sample format of a raw height map file. Samples are stored in little-endian byte order.
+ *
+ * \value RawDataFloat32
+ *        32-bit floating point samples.
+ * \value RawDataInt16
+ *        Signed 16-bit integer samples.
+ */
+
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Replaces current data with height map data read from the raw height field file specified by
+ * \a filename. The file holds \a height lines of \a width samples in the given \a format,
+ * starting \a offset bytes from the beginning of the file. Like in images, the first line of
+ * the file corresponds to the maximum Z value. The height of each point is the sample value
+ * multiplied by \a scale. Samples equal to \a noDataValue, as well as NaN samples, are given
+ * zero height.
+ *
+ * The file is mapped to memory while the data is resolved, and the surface rows are read
+ * directly from the mapped pages, so the file is never fully loaded or decoded into an
+ * intermediate image. Like height map images, the raw data is resolved asynchronously,
+ * large files in a background thread.
+ *
+ * Returns \c false and leaves the current data intact, if the file cannot be opened or is too
+ * small to hold the given data. The current data is also left intact, if the file cannot be
+ * mapped to memory when the data is resolved. Setting heightMap or heightMapFile replaces the
+ * raw height map.
+ *
+ * \sa RawDataFormat, setHeightMap()
+ */
+bool QHeightMapSurfaceDataProxy::setRawHeightMapFile(const QString &filename, int width,
+                                                     int height, RawDataFormat format,
+                                                     qint64 offset, float scale,
+                                                     float noDataValue)
+{
+    if (width <= 0 || height <= 0 || offset < 0) {
+        qWarning() << "Invalid raw height map dimensions or offset:" << width << height << offset;
+        return false;
+    }
+
+    QFile file(filename);
+    qint64 sampleSize = (format == RawDataInt16) ? sizeof(qint16) : sizeof(float);
+    qint64 dataSize = qint64(width) * qint64(height) * sampleSize;
+    if (!file.open(QIODevice::ReadOnly) || file.size() < offset + dataSize) {
+        qWarning() << "Cannot read raw height map file" << filename << "of"
+                   << dataSize << "bytes from offset" << offset;
+        return false;
+    }
+    file.close();
+
+    dptr()->m_rawFile = filename;
+    dptr()->m_rawWidth = width;
+    dptr()->m_rawHeight = height;
+    dptr()->m_rawFormat = format;
+    dptr()->m_rawOffset = offset;
+    dptr()->m_rawScale = scale;
+    dptr()->m_noDataValue = noDataValue;
+
+    // Raw data replaces any height map image
+    if (!dptr()->m_heightMapFile.isEmpty()) {
+        dptr()->m_heightMapFile.clear();
+        emit heightMapFileChanged(dptr()->m_heightMapFile);
+    }
+    if (!dptr()->m_heightMap.isNull()) {
+        dptr()->m_heightMap = QImage();
+        emit heightMapChanged(dptr()->m_heightMap);
+    }
+
+    if (!dptr()->m_resolveTimer.isActive())
+        dptr()->m_resolveTimer.start(0);
+
+    return true;
+}
+
 /*!
  * A convenience function for setting all minimum (\a minX and \a minZ) and maximum
  * (\a maxX and \a maxZ) values at the same time. The minimum values must be smaller than the
@@ -347,6 +470,12 @@ const QHeightMapSurfaceDataProxyPrivate *QHeightMapSurfaceDataProxy::dptrc() con
 
 QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapSurfaceDataProxy *q)
     : QSurfaceDataProxyPrivate(q),
+      m_rawWidth(0),
+      m_rawHeight(0),
+      m_rawFormat(QHeightMapSurfaceDataProxy::RawDataFloat32),
+      m_rawOffset(0),
+      m_rawScale(1.0f),
+      m_noDataValue(qQNaN()),
       m_minXValue(defaultMinValue),
       m_maxXValue(defaultMaxValue),
       m_minZValue(defaultMinValue),
@@ -359,6 +488,7 @@ QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapS
 
 QHeightMapSurfaceDataProxyPrivate::~QHeightMapSurfaceDataProxyPrivate()
 {
+    cancelResolve();
 }
 
 QHeightMapSurfaceDataProxy *QHeightMapSurfaceDataProxyPrivate::qptr()
@@ -507,91 +637,335 @@ void QHeightMapSurfaceDataProxyPrivate::setMaxZValue(float max)
 
 void QHeightMapSurfaceDataProxyPrivate::handlePendingResolve()
 {
-    QImage heightImage = m_heightMap;
+    cancelResolve();
+
+    QSharedPointer<HeightMapResolveJob> job;
+    qint64 pixelCount;
+    if (m_rawFile.isEmpty()) {
+        job.reset(new HeightMapResolveJob(m_heightMap, m_minXValue, m_maxXValue,
+                                          m_minZValue, m_maxZValue, this));
+        pixelCount = qint64(m_heightMap.width()) * qint64(m_heightMap.height());
+    } else {
+        job.reset(new HeightMapResolveJob(m_rawFile, m_rawWidth, m_rawHeight, m_rawFormat,
+                                          m_rawOffset, m_rawScale, m_noDataValue,
+                                          m_minXValue, m_maxXValue, m_minZValue, m_maxZValue,
+                                          this));
+        pixelCount = qint64(m_rawWidth) * qint64(m_rawHeight);
+    }
+
+    if (pixelCount < asyncResolvePixelThreshold) {
+        HeightMapResolveJob::resolve(job);
+        if (!job->isCancelled()) {
+            qptr()->resetArray(job->takeResult());
+            if (m_rawFile.isEmpty())
+                emit qptr()->heightMapChanged(m_heightMap);
+        }
+    } else {
+        // Large height maps are resolved in the thread pool to keep the GUI responsive.
+        // The current data is shown until the new data is ready.
+        m_resolveJob = job;
+        QThreadPool::globalInstance()->start(new HeightMapResolveTask(job));
+    }
+}
+
+void QHeightMapSurfaceDataProxyPrivate::handleResolveFinished()
+{
+    // Notifications of cancelled jobs may still be queued, so only take finished current jobs
+    if (m_resolveJob.isNull() || !m_resolveJob->isFinished())
+        return;
+
+    // Jobs that failed to read their data cancel themselves, keeping the current data
+    if (m_resolveJob->isCancelled()) {
+        m_resolveJob.clear();
+        return;
+    }
+
+    QSurfaceDataArray *dataArray = m_resolveJob->takeResult();
+    m_resolveJob.clear();
+
+    qptr()->resetArray(dataArray);
+    if (m_rawFile.isEmpty())
+        emit qptr()->heightMapChanged(m_heightMap);
+}
+
+void QHeightMapSurfaceDataProxyPrivate::cancelResolve()
+{
+    if (!m_resolveJob.isNull()) {
+        m_resolveJob->cancel();
+        m_resolveJob.clear();
+    }
+}
+
+//  HeightMapResolveJob
+
+HeightMapResolveJob::HeightMapResolveJob(const QImage &heightMap, float minX, float maxX,
+                                         float minZ, float maxZ,
+                                         QHeightMapSurfaceDataProxyPrivate *receiver)
+    : m_heightMap(heightMap),
+      m_minXValue(minX),
+      m_maxXValue(maxX),
+      m_minZValue(minZ),
+      m_maxZValue(maxZ),
+      m_rawFormat(QHeightMapSurfaceDataProxy::RawDataFloat32),
+      m_rawOffset(0),
+      m_rawScale(1.0f),
+      m_noDataValue(0.0f),
+      m_rawData(0),
+      m_width(0),
+      m_height(0),
+      m_bandSize(0),
+      m_bandCount(0),
+      m_nextBand(0),
+      m_cancelled(0),
+      m_finished(0),
+      m_doneBandCount(0),
+      m_receiver(receiver)
+{
+}
+
+HeightMapResolveJob::HeightMapResolveJob(const QString &rawFile, int width, int height,
+                                         QHeightMapSurfaceDataProxy::RawDataFormat rawFormat,
+                                         qint64 rawOffset, float rawScale, float noDataValue,
+                                         float minX, float maxX, float minZ, float maxZ,
+                                         QHeightMapSurfaceDataProxyPrivate *receiver)
+    : m_minXValue(minX),
+      m_maxXValue(maxX),
+      m_minZValue(minZ),
+      m_maxZValue(maxZ),
+      m_rawFile(rawFile),
+      m_rawFormat(rawFormat),
+      m_rawOffset(rawOffset),
+      m_rawScale(rawScale),
+      m_noDataValue(noDataValue),
+      m_rawData(0),
+      m_width(width),
+      m_height(height),
+      m_bandSize(0),
+      m_bandCount(0),
+      m_nextBand(0),
+      m_cancelled(0),
+      m_finished(0),
+      m_doneBandCount(0),
+      m_receiver(receiver)
+{
+}
+
+HeightMapResolveJob::~HeightMapResolveJob()
+{
+    qDeleteAll(m_rows);
+}
+
+void HeightMapResolveJob::resolve(const QSharedPointer<HeightMapResolveJob> &job)
+{
+    // The raw file stays mapped until all the bands are done
+    QFile rawFile(job->m_rawFile);
+    if (!job->m_rawFile.isEmpty()) {
+        qint64 sampleSize = (job->m_rawFormat == QHeightMapSurfaceDataProxy::RawDataInt16)
+                ? sizeof(qint16) : sizeof(float);
+        qint64 dataSize = qint64(job->m_width) * qint64(job->m_height) * sampleSize;
+        if (rawFile.open(QIODevice::ReadOnly))
+            job->m_rawData = rawFile.map(job->m_rawOffset, dataSize);
+        if (!job->m_rawData) {
+            // The job is cancelled, so that the current data is kept
+            qWarning() << "Failed to map raw height map file" << job->m_rawFile
+                       << rawFile.errorString();
+            job->m_cancelled.storeRelease(1);
+            job->m_finished.storeRelease(1);
+            return;
+        }
+    }
+
+    job->prepare();
+
+    // The helpers only pick up bands nobody has claimed yet, so it doesn't matter if the pool
+    // is busy and they start late, or only after all the bands have been resolved here.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    int helperCount = qMin(pool->maxThreadCount(), job->m_bandCount) - 1;
+    for (int i = 0; i < helperCount; i++)
+        pool->start(new HeightMapResolveBandTask(job));
+
+    job->resolveBands();
+
+    {
+        QMutexLocker locker(&job->m_mutex);
+        while (job->m_doneBandCount < job->m_bandCount)
+            job->m_bandsDone.wait(&job->m_mutex);
+    }
+
+    if (job->m_rawData) {
+        rawFile.unmap(const_cast<uchar *>(job->m_rawData));
+        job->m_rawData = 0;
+    }
+
+    job->m_finished.storeRelease(1);
+}
+
+void HeightMapResolveJob::resolveBands()
+{
+    int band;
+    while ((band = m_nextBand.fetchAndAddRelaxed(1)) < m_bandCount) {
+        if (!m_cancelled.loadAcquire())
+            resolveBand(band);
+
+        QMutexLocker locker(&m_mutex);
+        if (++m_doneBandCount == m_bandCount)
+            m_bandsDone.wakeAll();
+    }
+}
+
+void HeightMapResolveJob::notifyReceiver()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_receiver) {
+        QMetaObject::invokeMethod(m_receiver, "handleResolveFinished",
+                                  Qt::QueuedConnection);
+    }
+}
+
+void HeightMapResolveJob::cancel()
+{
+    m_cancelled.storeRelease(1);
+
+    // The receiver can be going away, so make sure it won't be notified anymore
+    QMutexLocker locker(&m_mutex);
+    m_receiver = 0;
+}
+
+bool HeightMapResolveJob::isCancelled() const
+{
+    return m_cancelled.loadAcquire();
+}
+
+bool HeightMapResolveJob::isFinished() const
+{
+    return m_finished.loadAcquire();
+}
+
+QSurfaceDataArray *HeightMapResolveJob::takeResult()
+{
+    QSurfaceDataArray *dataArray = new QSurfaceDataArray;
+    dataArray->reserve(m_rows.size());
+    foreach (QSurfaceDataRow *row, m_rows)
+        dataArray->append(row);
+    m_rows.clear();
+    return dataArray;
+}
 
-    // Convert to RGB32 to be sure we're reading the right bytes
-    if (heightImage.format() != QImage::Format_RGB32)
-        heightImage = heightImage.convertToFormat(QImage::Format_RGB32);
+void HeightMapResolveJob::prepare()
+{
+    if (m_rawFile.isEmpty()) {
+        // Formats the bands can read as they are are used directly, anything else is converted
+        // to RGB32 to be sure we're reading the right bytes.
+        switch (m_heightMap.format()) {
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_Grayscale8:
+            break;
+        default:
+            m_heightMap = m_heightMap.convertToFormat(QImage::Format_RGB32);
+            break;
+        }
+        m_width = m_heightMap.width();
+        m_height = m_heightMap.height();
+    }
 
-    uchar *bits = heightImage.bits();
+    // X values are the same for every row, so calculate them just once.
+    // Last column is explicitly set to max value, as relying on multiplier can cause rounding
+    // errors, resulting in the value being slightly over the specified maximum, which in turn
+    // can lead to it not getting rendered.
+    m_xValues.resize(m_width);
+    float xMul = (m_maxXValue - m_minXValue) / float(m_width - 1);
+    int lastCol = m_width - 1;
+    for (int j = 0; j < lastCol; j++)
+        m_xValues[j] = (float(j) * xMul) + m_minXValue;
+    if (m_width)
+        m_xValues[lastCol] = m_maxXValue;
+
+    m_rows.fill(0, m_height);
+
+    // Split the rows into a few bands per thread, so that uneven thread scheduling
+    // doesn't leave the resolving thread waiting for long.
+    int bandsPerThread = 4;
+    int targetBandCount = qMax(1, QThreadPool::globalInstance()->maxThreadCount() * bandsPerThread);
+    m_bandSize = qMax(minResolveBandSize, (m_height + targetBandCount - 1) / targetBandCount);
+    m_bandCount = (m_height + m_bandSize - 1) / m_bandSize;
+}
 
-    int imageHeight = heightImage.height();
-    int imageWidth = heightImage.width();
-    int bitCount = imageWidth * 4 * (imageHeight - 1);
-    int widthBits = imageWidth * 4;
-    float height = 0;
+void HeightMapResolveJob::resolveBand(int band)
+{
+    int lastRow = m_height - 1;
+    float zMul = (m_maxZValue - m_minZValue) / float(lastRow);
+    int firstRow = band * m_bandSize;
+    int endRow = qMin(firstRow + m_bandSize, m_height);
+    const float *xValues = m_xValues.constData();
+
+    QVector<float> heights(m_width);
+    float *rowHeights = heights.data();
+
+    for (int i = firstRow; i < endRow; i++) {
+        // Image and raw file lines run top down, while data rows run along the Z-axis.
+        // Heights are first read into a plain float buffer with tight per format loops that
+        // the compiler can vectorize, and only then copied into the data items.
+        if (m_rawData)
+            readRawLine(lastRow - i, rowHeights);
+        else
+            readImageLine(lastRow - i, rowHeights);
+
+        // Last row is explicitly set to max value for the same reason as the last column
+        float zVal;
+        if (i == lastRow)
+            zVal = m_maxZValue;
+        else
+            zVal = (float(i) * zMul) + m_minZValue;
+
+        QSurfaceDataRow *newRow = new QSurfaceDataRow(m_width);
+        QSurfaceDataItem *items = newRow->data();
+        for (int j = 0; j < m_width; j++)
+            items[j].setPosition(QVector3D(xValues[j], rowHeights[j], zVal));
+        m_rows[i] = newRow;
+    }
+}
 
-    // Do not recreate array if dimensions have not changed
-    QSurfaceDataArray *dataArray = m_dataArray;
-    if (imageWidth != qptr()->columnCount() || imageHeight != dataArray->size()) {
-        dataArray = new QSurfaceDataArray;
-        dataArray->reserve(imageHeight);
-        for (int i = 0; i < imageHeight; i++) {
-            QSurfaceDataRow *newProxyRow = new QSurfaceDataRow(imageWidth);
-            dataArray->append(newProxyRow);
+void HeightMapResolveJob::readImageLine(int line, float *heights) const
+{
+    const uchar *scanLine = m_heightMap.constScanLine(line);
+
+    switch (m_heightMap.format()) {
+    case QImage::Format_Grayscale8:
+        for (int j = 0; j < m_width; j++)
+            heights[j] = float(scanLine[j]);
+        break;
+    default: {
+        // Height is the average of red, green and blue. For grayscale pixels it is
+        // exactly the value of any single channel.
+        const quint32 *pixels = reinterpret_cast<const quint32 *>(scanLine);
+        for (int j = 0; j < m_width; j++) {
+            quint32 pixel = pixels[j];
+            heights[j] = float(((pixel >> 16) & 0xff) + ((pixel >> 8) & 0xff)
+                               + (pixel & 0xff)) / 3.0f;
         }
+        break;
+    }
     }
+}
 
-    float xMul = (m_maxXValue - m_minXValue) / float(imageWidth - 1);
-    float zMul = (m_maxZValue - m_minZValue) / float(imageHeight - 1);
-
-    // Last row and column are explicitly set to max values, as relying
-    // on multiplier can cause rounding errors, resulting in the value being
-    // slightly over the specified maximum, which in turn can lead to it not
-    // getting rendered.
-    int lastRow = imageHeight - 1;
-    int lastCol = imageWidth - 1;
-
-    if (heightImage.isGrayscale()) {
-        // Grayscale, it's enough to read Red byte
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
-            float zVal;
-            if (i == lastRow)
-                zVal = m_maxZValue;
-            else
-                zVal = (float(i) * zMul) + m_minZValue;
-            int j = 0;
-            for (; j < lastCol; j++)
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
-                                                float(bits[bitCount + (j * 4)]),
-                                      zVal));
-            newRow[j].setPosition(QVector3D(m_maxXValue,
-                                            float(bits[bitCount + (j * 4)]),
-                                  zVal));
+void HeightMapResolveJob::readRawLine(int line, float *heights) const
+{
+    if (m_rawFormat == QHeightMapSurfaceDataProxy::RawDataInt16) {
+        const uchar *samples = m_rawData + qint64(line) * qint64(m_width) * sizeof(qint16);
+        for (int j = 0; j < m_width; j++) {
+            float value = float(qFromLittleEndian<qint16>(samples + j * sizeof(qint16)));
+            heights[j] = (value == m_noDataValue) ? 0.0f : value * m_rawScale;
         }
     } else {
-        // Not grayscale, we'll need to calculate height from RGB
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
-            float zVal;
-            if (i == lastRow)
-                zVal = m_maxZValue;
-            else
-                zVal = (float(i) * zMul) + m_minZValue;
-            int j = 0;
-            int nextpixel = 0;
-            for (; j < lastCol; j++) {
-                nextpixel = j * 4;
-                height = (float(bits[bitCount + nextpixel])
-                        + float(bits[1 + bitCount + nextpixel])
-                        + float(bits[2 + bitCount + nextpixel]));
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
-                                                height / 3.0f,
-                                                zVal));
-            }
-            nextpixel = j * 4;
-            height = (float(bits[bitCount + nextpixel])
-                    + float(bits[1 + bitCount + nextpixel])
-                    + float(bits[2 + bitCount + nextpixel]));
-            newRow[j].setPosition(QVector3D(m_maxXValue,
-                                            height / 3.0f,
-                                            zVal));
+        const uchar *samples = m_rawData + qint64(line) * qint64(m_width) * sizeof(float);
+        for (int j = 0; j < m_width; j++) {
+            quint32 bits = qFromLittleEndian<quint32>(samples + j * sizeof(float));
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            heights[j] = (value == m_noDataValue || qIsNaN(value)) ? 0.0f : value * m_rawScale;
         }
     }
-
-    qptr()->resetArray(dataArray);
-    emit qptr()->heightMapChanged(m_heightMap);
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
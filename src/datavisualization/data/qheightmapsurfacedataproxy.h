@@ -33,6 +33,7 @@
 #include <QtDataVisualization/qsurfacedataproxy.h>
 #include <QtGui/QImage>
 #include <QtCore/QString>
+#include <QtCore/qnumeric.h>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -41,6 +42,7 @@ class QHeightMapSurfaceDataProxyPrivate;
 class QT_DATAVISUALIZATION_EXPORT QHeightMapSurfaceDataProxy : public QSurfaceDataProxy
 {
     Q_OBJECT
+    Q_ENUMS(RawDataFormat)
 
     Q_PROPERTY(QImage heightMap READ heightMap WRITE setHeightMap NOTIFY heightMapChanged)
     Q_PROPERTY(QString heightMapFile READ heightMapFile WRITE setHeightMapFile NOTIFY heightMapFileChanged)
@@ -50,6 +52,11 @@ class QT_DATAVISUALIZATION_EXPORT QHeightMapSurfaceDataProxy : public QSurfaceDa
     Q_PROPERTY(float maxZValue READ maxZValue WRITE setMaxZValue NOTIFY maxZValueChanged)
 
 public:
+    enum RawDataFormat {
+        RawDataFloat32 = 0,
+        RawDataInt16
+    };
+
     explicit QHeightMapSurfaceDataProxy(QObject *parent = Q_NULLPTR);
     explicit QHeightMapSurfaceDataProxy(const QImage &image, QObject *parent = Q_NULLPTR);
     explicit QHeightMapSurfaceDataProxy(const QString &filename, QObject *parent = Q_NULLPTR);
@@ -59,6 +66,9 @@ public:
     QImage heightMap() const;
     void setHeightMapFile(const QString &filename);
     QString heightMapFile() const;
+    bool setRawHeightMapFile(const QString &filename, int width, int height,
+                             RawDataFormat format, qint64 offset = 0, float scale = 1.0f,
+                             float noDataValue = qQNaN());
 
     void setValueRanges(float minX, float maxX, float minZ, float maxZ);
     void setMinXValue(float min);
@@ -43,9 +43,74 @@
 #include "qheightmapsurfacedataproxy.h"
 #include "qsurfacedataproxy_p.h"
 #include <QtCore/QTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class QHeightMapSurfaceDataProxyPrivate;
+
+// Converts a height map image into a surface data array. The rows are split into bands that
+// are resolved by any thread calling resolveBands(), so the work can be shared with the global
+// thread pool while the thread calling resolve() does its part of the bands, too.
+class HeightMapResolveJob
+{
+public:
+    HeightMapResolveJob(const QImage &heightMap, float minX, float maxX, float minZ, float maxZ,
+                        QHeightMapSurfaceDataProxyPrivate *receiver);
+    HeightMapResolveJob(const QString &rawFile, int width, int height,
+                        QHeightMapSurfaceDataProxy::RawDataFormat rawFormat, qint64 rawOffset,
+                        float rawScale, float noDataValue, float minX, float maxX,
+                        float minZ, float maxZ, QHeightMapSurfaceDataProxyPrivate *receiver);
+    ~HeightMapResolveJob();
+
+    static void resolve(const QSharedPointer<HeightMapResolveJob> &job);
+    void resolveBands();
+    void notifyReceiver();
+    void cancel();
+    bool isCancelled() const;
+    bool isFinished() const;
+    QSurfaceDataArray *takeResult();
+
+private:
+    void prepare();
+    void resolveBand(int band);
+    void readImageLine(int line, float *heights) const;
+    void readRawLine(int line, float *heights) const;
+
+    QImage m_heightMap;
+    float m_minXValue;
+    float m_maxXValue;
+    float m_minZValue;
+    float m_maxZValue;
+
+    // Raw height map files are mapped to memory for the duration of the resolve
+    QString m_rawFile;
+    QHeightMapSurfaceDataProxy::RawDataFormat m_rawFormat;
+    qint64 m_rawOffset;
+    float m_rawScale;
+    float m_noDataValue;
+    const uchar *m_rawData;
+
+    int m_width;
+    int m_height;
+    QVector<float> m_xValues;
+    QVector<QSurfaceDataRow *> m_rows;
+    int m_bandSize;
+    int m_bandCount;
+    QAtomicInt m_nextBand;
+    QAtomicInt m_cancelled;
+    QAtomicInt m_finished;
+
+    QMutex m_mutex;
+    QWaitCondition m_bandsDone;
+    int m_doneBandCount;
+    QHeightMapSurfaceDataProxyPrivate *m_receiver;
+
+    Q_DISABLE_COPY(HeightMapResolveJob)
+};
+
 class QHeightMapSurfaceDataProxyPrivate : public QSurfaceDataProxyPrivate
 {
     Q_OBJECT
@@ -59,13 +124,26 @@ public:
     void setMaxXValue(float max);
     void setMinZValue(float min);
     void setMaxZValue(float max);
+
+public Q_SLOTS:
+    void handleResolveFinished();
+
 private:
     QHeightMapSurfaceDataProxy *qptr();
     void handlePendingResolve();
+    void cancelResolve();
 
     QImage m_heightMap;
     QString m_heightMapFile;
+    QString m_rawFile;
+    int m_rawWidth;
+    int m_rawHeight;
+    QHeightMapSurfaceDataProxy::RawDataFormat m_rawFormat;
+    qint64 m_rawOffset;
+    float m_rawScale;
+    float m_noDataValue;
     QTimer m_resolveTimer;
+    QSharedPointer<HeightMapResolveJob> m_resolveJob;
 
     float m_minXValue;
     float m_maxXValue;
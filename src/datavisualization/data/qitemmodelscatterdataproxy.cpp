@@ -571,6 +571,33 @@ QString QItemModelScatterDataProxy::rotationRoleReplace() const
     return dptrc()->m_rotationRoleReplace;
 }
 
+/*!
+ * \property QItemModelScatterDataProxy::asynchronous
+ * \since QtDataVisualization 1.3
+ *
+ * \brief Whether the item model is resolved in a background thread.
+ *
+ * When \c true, only reading the data from the item model happens in the GUI thread when
+ * the model or the role mappings change. Turning the data into the proxy array happens in a
+ * background thread, after which the array is swapped in with resetArray(). The previous data
+ * stays in the proxy until then, and a resolve in progress is cancelled if the item model
+ * changes again before it is done.
+ *
+ * Defaults to \c{false}.
+ */
+void QItemModelScatterDataProxy::setAsynchronous(bool asynchronous)
+{
+    if (dptr()->m_itemModelHandler->isAsynchronous() != asynchronous) {
+        dptr()->m_itemModelHandler->setAsynchronous(asynchronous);
+        emit asynchronousChanged(asynchronous);
+    }
+}
+
+bool QItemModelScatterDataProxy::isAsynchronous() const
+{
+    return dptrc()->m_itemModelHandler->isAsynchronous();
+}
+
 /*!
  * Changes \a xPosRole, \a yPosRole, \a zPosRole, and \a rotationRole mapping.
  */
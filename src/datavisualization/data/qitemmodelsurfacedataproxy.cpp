@@ -44,9 +44,10 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  *
  * Data is resolved asynchronously whenever the mapping or the model changes.
  * QSurfaceDataProxy::arrayReset() is emitted when the data has been resolved.
- * However, when useModelCategories property is set to \c true, single item changes are resolved
- * synchronously, unless the same frame also contains a change that causes the whole model to be
- * resolved.
+ * However, when useModelCategories property is set to \c true, single item changes as well as
+ * inserted and removed rows are resolved synchronously, unless the same frame also contains a
+ * change that causes the whole model to be resolved. The same applies to the role based mapping,
+ * as long as the changes do not add, remove, or reorder categories.
  *
  * Mappings can be used in the following ways:
  *
@@ -1038,6 +1039,33 @@ QItemModelSurfaceDataProxy::MultiMatchBehavior QItemModelSurfaceDataProxy::multi
     return dptrc()->m_multiMatchBehavior;
 }
 
+/*!
+ * \property QItemModelSurfaceDataProxy::asynchronous
+ * \since QtDataVisualization 1.3
+ *
+ * \brief Whether the item model is resolved in a background thread.
+ *
+ * When \c true, only reading the data from the item model happens in the GUI thread when
+ * the model or the role mappings change. Turning the data into the proxy array happens in a
+ * background thread, after which the array is swapped in with resetArray(). The previous data
+ * stays in the proxy until then, and a resolve in progress is cancelled if the item model
+ * changes again before it is done.
+ *
+ * Defaults to \c{false}.
+ */
+void QItemModelSurfaceDataProxy::setAsynchronous(bool asynchronous)
+{
+    if (dptr()->m_itemModelHandler->isAsynchronous() != asynchronous) {
+        dptr()->m_itemModelHandler->setAsynchronous(asynchronous);
+        emit asynchronousChanged(asynchronous);
+    }
+}
+
+bool QItemModelSurfaceDataProxy::isAsynchronous() const
+{
+    return dptrc()->m_itemModelHandler->isAsynchronous();
+}
+
 /*!
  * \internal
  */
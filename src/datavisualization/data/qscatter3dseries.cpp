@@ -29,6 +29,7 @@
 
 #include "qscatter3dseries_p.h"
 #include "scatter3dcontroller_p.h"
+#include "qscatterdataproxy_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -124,6 +125,52 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * The preset default is \c 0.0.
  */
 
+/*!
+ * \qmlproperty real Scatter3DSeries::lodThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * The projected item size in pixels below which items are drawn with a lower
+ * detail version of the series mesh. Only MeshSphere has a lower detail version;
+ * the other built-in meshes are already simple enough.
+ * The preset default is \c 0.0, which disables the level of detail selection.
+ *
+ * \sa lodPointThreshold
+ */
+
+/*!
+ * \qmlproperty real Scatter3DSeries::lodPointThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * The projected item size in pixels below which items are drawn as points
+ * instead of meshes. Points are not used on OpenGL ES2, nor when the items are
+ * drawn from static or instanced buffers.
+ * The preset default is \c 0.0, which disables the point fallback.
+ *
+ * \sa lodThreshold
+ */
+
+/*!
+ * \qmlproperty Scatter3DSeries.RenderingMode Scatter3DSeries::renderingMode
+ * \since QtDataVisualization 1.3
+ *
+ * Sets how the items of the series are rendered. In
+ * \l{QScatter3DSeries::RenderingModeDensity}{Scatter3DSeries.RenderingModeDensity},
+ * the items are counted into a voxel grid that is rendered as a volume colored by the
+ * item density, instead of rendering each item separately.
+ * The preset default is \l{QScatter3DSeries::RenderingModeItems}{Scatter3DSeries.RenderingModeItems}.
+ *
+ * \sa QScatter3DSeries::RenderingMode, densityResolution
+ */
+
+/*!
+ * \qmlproperty int Scatter3DSeries::densityResolution
+ * \since QtDataVisualization 1.3
+ *
+ * The number of voxels along each axis of the density grid used when the
+ * \l renderingMode is \l{QScatter3DSeries::RenderingModeDensity}{Scatter3DSeries.RenderingModeDensity}.
+ * The value must be between \c 4 and \c 256. The preset default is \c 64.
+ */
+
 /*!
  * \qmlproperty int Scatter3DSeries::invalidSelectionIndex
  * A constant property providing an invalid index for selection. This index is
@@ -132,6 +179,20 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * \sa AbstractGraph3D::clearSelection()
  */
 
+/*!
+ * \enum QScatter3DSeries::RenderingMode
+ * \since QtDataVisualization 1.3
+ *
+ * Rendering modes of the series items.
+ *
+ * \value RenderingModeItems
+ *        Each item is rendered separately with the series mesh.
+ * \value RenderingModeDensity
+ *        The items are counted into a voxel grid, which is rendered as a volume
+ *        colored by the item density. Meant for series with so many items that
+ *        rendering them separately is neither fast nor readable.
+ */
+
 /*!
  * Constructs a scatter 3D series with the parent \a parent.
  */
@@ -249,6 +310,139 @@ float QScatter3DSeries::itemSize() const
     return dptrc()->m_itemSize;
 }
 
+/*!
+ * \property QScatter3DSeries::lodThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * \brief The projected item size in pixels below which items are drawn with a
+ * lower detail mesh.
+ *
+ * The projected size of each item is estimated from its distance to the camera
+ * every frame. Items smaller than this threshold are drawn with a lower detail
+ * version of the series mesh, which reduces the vertex count considerably for
+ * large numbers of distant items. Only MeshSphere has a lower detail version;
+ * the other built-in meshes are already simple enough. The selected item is always
+ * drawn with the full mesh.
+ *
+ * With QAbstract3DGraph::OptimizationStatic and QAbstract3DGraph::OptimizationInstanced,
+ * the level of detail is selected for the whole series, based on the projected item
+ * size at the center of the graph. Changing the level of the static optimization
+ * reloads the series buffers.
+ *
+ * The value must not be negative. The preset default is \c 0.0f, which disables the
+ * level of detail selection.
+ *
+ * \sa lodPointThreshold
+ */
+void QScatter3DSeries::setLodThreshold(float pixels)
+{
+    if (pixels < 0.0f) {
+        qWarning("Invalid threshold. lodThreshold cannot be negative");
+    } else if (pixels != dptr()->m_lodThreshold) {
+        dptr()->setLodThresholds(pixels, dptr()->m_lodPointThreshold);
+        emit lodThresholdChanged(pixels);
+    }
+}
+
+float QScatter3DSeries::lodThreshold() const
+{
+    return dptrc()->m_lodThreshold;
+}
+
+/*!
+ * \property QScatter3DSeries::lodPointThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * \brief The projected item size in pixels below which items are drawn as points.
+ *
+ * Items smaller than this threshold are drawn as points sized to their projected
+ * size, in the series base color or range gradient color. This only applies to the
+ * default optimization on desktop OpenGL, as points cannot be mixed with meshes in
+ * the static and instanced buffers. Otherwise these items use the lower detail mesh.
+ *
+ * The value must not be negative. The preset default is \c 0.0f, which disables the
+ * point fallback.
+ *
+ * \sa lodThreshold
+ */
+void QScatter3DSeries::setLodPointThreshold(float pixels)
+{
+    if (pixels < 0.0f) {
+        qWarning("Invalid threshold. lodPointThreshold cannot be negative");
+    } else if (pixels != dptr()->m_lodPointThreshold) {
+        dptr()->setLodThresholds(dptr()->m_lodThreshold, pixels);
+        emit lodPointThresholdChanged(pixels);
+    }
+}
+
+float QScatter3DSeries::lodPointThreshold() const
+{
+    return dptrc()->m_lodPointThreshold;
+}
+
+/*!
+ * \property QScatter3DSeries::renderingMode
+ * \since QtDataVisualization 1.3
+ *
+ * \brief How the items of the series are rendered.
+ *
+ * In RenderingModeDensity, the visible items are counted into a voxel grid
+ * covering the graph area, and the grid is rendered as a volume. The color of
+ * each voxel comes from the series base color or base gradient according to the
+ * number of items in the voxel, on a logarithmic scale, and empty voxels are
+ * transparent. Changed items are moved between the voxels without recounting the
+ * whole series. The items of a density rendered series cannot be selected, and
+ * they don't cast shadows.
+ *
+ * Volume rendering is not supported on OpenGL ES2, where the items are always
+ * rendered separately.
+ *
+ * The preset default is RenderingModeItems.
+ *
+ * \sa densityResolution
+ */
+void QScatter3DSeries::setRenderingMode(RenderingMode mode)
+{
+    if (mode != dptr()->m_renderingMode) {
+        dptr()->setRenderingMode(mode);
+        emit renderingModeChanged(mode);
+    }
+}
+
+QScatter3DSeries::RenderingMode QScatter3DSeries::renderingMode() const
+{
+    return dptrc()->m_renderingMode;
+}
+
+/*!
+ * \property QScatter3DSeries::densityResolution
+ * \since QtDataVisualization 1.3
+ *
+ * \brief The number of voxels along each axis of the density grid.
+ *
+ * Only used when the renderingMode is RenderingModeDensity. Higher resolutions show
+ * more detail, but take more memory and make the volume slower to render.
+ * The value is rounded up to a multiple of four for the volume texture.
+ *
+ * The value must be between \c 4 and \c 256. The preset default is \c 64.
+ *
+ * \sa renderingMode
+ */
+void QScatter3DSeries::setDensityResolution(int resolution)
+{
+    if (resolution < 4 || resolution > 256) {
+        qWarning("Invalid resolution. densityResolution must be between 4 and 256");
+    } else if (resolution != dptr()->m_densityResolution) {
+        dptr()->setDensityResolution(resolution);
+        emit densityResolutionChanged(resolution);
+    }
+}
+
+int QScatter3DSeries::densityResolution() const
+{
+    return dptrc()->m_densityResolution;
+}
+
 /*!
  * Returns an invalid index for selection. This index is set to the selectedItem
  * property to clear the selection from this series.
@@ -281,7 +475,11 @@ const QScatter3DSeriesPrivate *QScatter3DSeries::dptrc() const
 QScatter3DSeriesPrivate::QScatter3DSeriesPrivate(QScatter3DSeries *q)
     : QAbstract3DSeriesPrivate(q, QAbstract3DSeries::SeriesTypeScatter),
       m_selectedItem(Scatter3DController::invalidSelectionIndex()),
-      m_itemSize(0.0f)
+      m_itemSize(0.0f),
+      m_lodThreshold(0.0f),
+      m_lodPointThreshold(0.0f),
+      m_renderingMode(QScatter3DSeries::RenderingModeItems),
+      m_densityResolution(64)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -350,7 +548,8 @@ void QScatter3DSeriesPrivate::createItemLabel()
     QValue3DAxis *axisX = static_cast<QValue3DAxis *>(m_controller->axisX());
     QValue3DAxis *axisY = static_cast<QValue3DAxis *>(m_controller->axisY());
     QValue3DAxis *axisZ = static_cast<QValue3DAxis *>(m_controller->axisZ());
-    QVector3D selectedPosition = qptr()->dataProxy()->itemAt(m_selectedItem)->position();
+    QVector3D selectedPosition =
+            static_cast<QScatterDataProxyPrivate *>(dataProxyPrivate())->positionAt(m_selectedItem);
 
     m_itemLabel = m_itemLabelFormat;
 
@@ -392,4 +591,26 @@ void QScatter3DSeriesPrivate::setItemSize(float size)
         m_controller->markSeriesVisualsDirty();
 }
 
+void QScatter3DSeriesPrivate::setLodThresholds(float lodThreshold, float lodPointThreshold)
+{
+    m_lodThreshold = lodThreshold;
+    m_lodPointThreshold = lodPointThreshold;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QScatter3DSeriesPrivate::setRenderingMode(QScatter3DSeries::RenderingMode mode)
+{
+    m_renderingMode = mode;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QScatter3DSeriesPrivate::setDensityResolution(int resolution)
+{
+    m_densityResolution = resolution;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
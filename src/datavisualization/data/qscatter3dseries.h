@@ -40,11 +40,21 @@ class QScatter3DSeriesPrivate;
 class QT_DATAVISUALIZATION_EXPORT QScatter3DSeries : public QAbstract3DSeries
 {
     Q_OBJECT
+    Q_ENUMS(RenderingMode)
     Q_PROPERTY(QScatterDataProxy *dataProxy READ dataProxy WRITE setDataProxy NOTIFY dataProxyChanged)
     Q_PROPERTY(int selectedItem READ selectedItem WRITE setSelectedItem NOTIFY selectedItemChanged)
     Q_PROPERTY(float itemSize READ itemSize WRITE setItemSize NOTIFY itemSizeChanged)
+    Q_PROPERTY(float lodThreshold READ lodThreshold WRITE setLodThreshold NOTIFY lodThresholdChanged REVISION 1)
+    Q_PROPERTY(float lodPointThreshold READ lodPointThreshold WRITE setLodPointThreshold NOTIFY lodPointThresholdChanged REVISION 1)
+    Q_PROPERTY(RenderingMode renderingMode READ renderingMode WRITE setRenderingMode NOTIFY renderingModeChanged REVISION 1)
+    Q_PROPERTY(int densityResolution READ densityResolution WRITE setDensityResolution NOTIFY densityResolutionChanged REVISION 1)
 
 public:
+    enum RenderingMode {
+        RenderingModeItems = 0,
+        RenderingModeDensity
+    };
+
     explicit QScatter3DSeries(QObject *parent = Q_NULLPTR);
     explicit QScatter3DSeries(QScatterDataProxy *dataProxy, QObject *parent = Q_NULLPTR);
     virtual ~QScatter3DSeries();
@@ -59,10 +69,24 @@ public:
     void setItemSize(float size);
     float itemSize() const;
 
+    void setLodThreshold(float pixels);
+    float lodThreshold() const;
+    void setLodPointThreshold(float pixels);
+    float lodPointThreshold() const;
+
+    void setRenderingMode(RenderingMode mode);
+    RenderingMode renderingMode() const;
+    void setDensityResolution(int resolution);
+    int densityResolution() const;
+
 Q_SIGNALS:
     void dataProxyChanged(QScatterDataProxy *proxy);
     void selectedItemChanged(int index);
     void itemSizeChanged(float size);
+    Q_REVISION(1) void lodThresholdChanged(float pixels);
+    Q_REVISION(1) void lodPointThresholdChanged(float pixels);
+    Q_REVISION(1) void renderingModeChanged(QScatter3DSeries::RenderingMode mode);
+    Q_REVISION(1) void densityResolutionChanged(int resolution);
 
 protected:
     explicit QScatter3DSeries(QScatter3DSeriesPrivate *d, QObject *parent = Q_NULLPTR);
@@ -58,11 +58,18 @@ public:
 
     void setSelectedItem(int index);
     void setItemSize(float size);
+    void setLodThresholds(float lodThreshold, float lodPointThreshold);
+    void setRenderingMode(QScatter3DSeries::RenderingMode mode);
+    void setDensityResolution(int resolution);
 
 private:
     QScatter3DSeries *qptr();
     int m_selectedItem;
     float m_itemSize;
+    float m_lodThreshold;
+    float m_lodPointThreshold;
+    QScatter3DSeries::RenderingMode m_renderingMode;
+    int m_densityResolution;
 
 private:
     friend class QScatter3DSeries;
@@ -30,6 +30,7 @@
 #include "qscatterdataproxy_p.h"
 #include "qscatter3dseries_p.h"
 #include "qabstract3daxis_p.h"
+#include <QtCore/qnumeric.h>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -46,6 +47,10 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * QtDataVisualization::QScatterDataArray and QScatterDataItem objects passed to
  * it.
  *
+ * For very large data sets, the proxy can also be given separate caller-owned
+ * position buffers with resetArray(). In that case the data is read directly
+ * from the buffers and no QScatterDataItem objects are created for it.
+ *
  * \sa {Qt Data Visualization Data Handling}
  */
 
@@ -89,6 +94,7 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 QScatterDataProxy::QScatterDataProxy(QObject *parent) :
     QAbstractDataProxy(new QScatterDataProxyPrivate(this), parent)
 {
+    dptr()->connectBoundsTracking();
 }
 
 /*!
@@ -97,6 +103,7 @@ QScatterDataProxy::QScatterDataProxy(QObject *parent) :
 QScatterDataProxy::QScatterDataProxy(QScatterDataProxyPrivate *d, QObject *parent) :
     QAbstractDataProxy(d, parent)
 {
+    dptr()->connectBoundsTracking();
 }
 
 /*!
@@ -125,13 +132,45 @@ QScatter3DSeries *QScatterDataProxy::series() const
  */
 void QScatterDataProxy::resetArray(QScatterDataArray *newArray)
 {
-    if (dptr()->m_dataArray != newArray)
+    if (dptr()->m_dataArray != newArray || dptr()->hasBuffers())
         dptr()->resetArray(newArray);
 
     emit arrayReset();
     emit itemCountChanged(itemCount());
 }
 
+/*!
+ * \overload
+ * \since QtDataVisualization 1.3
+ *
+ * Uses the caller-owned buffers \a xValues, \a yValues, and \a zValues as the
+ * item positions, each holding \a count values. If \a rotations is not null,
+ * it must also hold \a count values, which are used as the item rotations.
+ * Otherwise all items use the default rotation.
+ *
+ * The buffers are not copied and the proxy does not take ownership of them.
+ * They must stay valid until the array is reset again or the proxy is
+ * deleted. If the buffer contents are changed in place, itemsChanged() or
+ * arrayReset() needs to be emitted to update the graph.
+ *
+ * While buffers are in use, array() returns an empty array and itemAt()
+ * returns null, so reading the data never copies the buffers. Use
+ * itemValueAt() to read the items. Calling any of the functions that add,
+ * change, insert, or remove items copies the buffer contents into an internal
+ * array first, after which the buffers are no longer referenced.
+ *
+ * Passing a null buffer or a \a count that is not positive clears the data.
+ */
+void QScatterDataProxy::resetArray(const float *xValues, const float *yValues,
+                                   const float *zValues, int count,
+                                   const QQuaternion *rotations)
+{
+    dptr()->resetBuffers(xValues, yValues, zValues, count, rotations);
+
+    emit arrayReset();
+    emit itemCountChanged(itemCount());
+}
+
 /*!
  * Replaces the item at the position \a index with the item \a item.
  */
@@ -206,7 +245,7 @@ void QScatterDataProxy::insertItems(int index, const QScatterDataArray &items)
  */
 void QScatterDataProxy::removeItems(int index, int removeCount)
 {
-    if (index >= dptr()->m_dataArray->size())
+    if (index >= dptr()->itemCount())
         return;
 
     dptr()->removeItems(index, removeCount);
@@ -221,11 +260,14 @@ void QScatterDataProxy::removeItems(int index, int removeCount)
  */
 int QScatterDataProxy::itemCount() const
 {
-    return dptrc()->m_dataArray->size();
+    return dptrc()->itemCount();
 }
 
 /*!
- * Returns the pointer to the data array.
+ * Returns the pointer to the data array. The array is empty while the proxy uses
+ * caller-owned buffers.
+ *
+ * \sa resetArray()
  */
 const QScatterDataArray *QScatterDataProxy::array() const
 {
@@ -234,13 +276,33 @@ const QScatterDataArray *QScatterDataProxy::array() const
 
 /*!
  * Returns the pointer to the item at the index \a index. It is guaranteed to be
- * valid only until the next call that modifies data.
+ * valid only until the next call that modifies data. Returns null while the
+ * proxy uses caller-owned buffers.
+ *
+ * \sa itemValueAt()
  */
 const QScatterDataItem *QScatterDataProxy::itemAt(int index) const
 {
+    if (dptrc()->hasBuffers())
+        return 0;
     return &dptrc()->m_dataArray->at(index);
 }
 
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Returns a copy of the item at the index \a index. Unlike itemAt(), this also
+ * works while the proxy uses caller-owned buffers.
+ *
+ * \sa resetArray()
+ */
+QScatterDataItem QScatterDataProxy::itemValueAt(int index) const
+{
+    const QScatterDataProxyPrivate *d = dptrc();
+    Q_ASSERT(index >= 0 && index < d->itemCount());
+    return QScatterDataItem(d->positionAt(index), d->rotationAt(index));
+}
+
 /*!
  * \internal
  */
@@ -306,7 +368,14 @@ const QScatterDataProxyPrivate *QScatterDataProxy::dptrc() const
 
 QScatterDataProxyPrivate::QScatterDataProxyPrivate(QScatterDataProxy *q)
     : QAbstractDataProxyPrivate(q, QAbstractDataProxy::DataTypeScatter),
-      m_dataArray(new QScatterDataArray)
+      m_dataArray(new QScatterDataArray),
+      m_xBuffer(0),
+      m_yBuffer(0),
+      m_zBuffer(0),
+      m_rotationBuffer(0),
+      m_bufferCount(0),
+      m_boundsDirty(true),
+      m_boundsReleased(false)
 {
 }
 
@@ -318,6 +387,8 @@ QScatterDataProxyPrivate::~QScatterDataProxyPrivate()
 
 void QScatterDataProxyPrivate::resetArray(QScatterDataArray *newArray)
 {
+    clearBuffers();
+
     if (!newArray)
         newArray = new QScatterDataArray;
 
@@ -328,21 +399,69 @@ void QScatterDataProxyPrivate::resetArray(QScatterDataArray *newArray)
     }
 }
 
+void QScatterDataProxyPrivate::resetBuffers(const float *xValues, const float *yValues,
+                                            const float *zValues, int count,
+                                            const QQuaternion *rotations)
+{
+    // Release the items of the previous array, but keep the array itself, as it is still
+    // returned by QScatterDataProxy::array()
+    m_dataArray->clear();
+    m_dataArray->squeeze();
+    clearBuffers();
+
+    if (xValues && yValues && zValues && count > 0) {
+        m_xBuffer = xValues;
+        m_yBuffer = yValues;
+        m_zBuffer = zValues;
+        m_rotationBuffer = rotations;
+        m_bufferCount = count;
+    }
+}
+
+void QScatterDataProxyPrivate::detachBuffers()
+{
+    if (!m_xBuffer)
+        return;
+
+    m_dataArray->resize(m_bufferCount);
+    QScatterDataItem *items = m_dataArray->data();
+    for (int i = 0; i < m_bufferCount; i++) {
+        items[i].setPosition(positionAt(i));
+        items[i].setRotation(rotationAt(i));
+    }
+
+    clearBuffers();
+}
+
+void QScatterDataProxyPrivate::clearBuffers()
+{
+    m_xBuffer = 0;
+    m_yBuffer = 0;
+    m_zBuffer = 0;
+    m_rotationBuffer = 0;
+    m_bufferCount = 0;
+}
+
 void QScatterDataProxyPrivate::setItem(int index, const QScatterDataItem &item)
 {
+    detachBuffers();
     Q_ASSERT(index >= 0 && index < m_dataArray->size());
+    releaseBounds(index, 1);
     (*m_dataArray)[index] = item;
 }
 
 void QScatterDataProxyPrivate::setItems(int index, const QScatterDataArray &items)
 {
+    detachBuffers();
     Q_ASSERT(index >= 0 && (index + items.size()) <= m_dataArray->size());
+    releaseBounds(index, items.size());
     for (int i = 0; i < items.size(); i++)
         (*m_dataArray)[index++] = items[i];
 }
 
 int QScatterDataProxyPrivate::addItem(const QScatterDataItem &item)
 {
+    detachBuffers();
     int currentSize = m_dataArray->size();
     m_dataArray->append(item);
     return currentSize;
@@ -350,6 +469,7 @@ int QScatterDataProxyPrivate::addItem(const QScatterDataItem &item)
 
 int QScatterDataProxyPrivate::addItems(const QScatterDataArray &items)
 {
+    detachBuffers();
     int currentSize = m_dataArray->size();
     (*m_dataArray) += items;
     return currentSize;
@@ -357,12 +477,14 @@ int QScatterDataProxyPrivate::addItems(const QScatterDataArray &items)
 
 void QScatterDataProxyPrivate::insertItem(int index, const QScatterDataItem &item)
 {
+    detachBuffers();
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
     m_dataArray->insert(index, item);
 }
 
 void QScatterDataProxyPrivate::insertItems(int index, const QScatterDataArray &items)
 {
+    detachBuffers();
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
     for (int i = 0; i < items.size(); i++)
         m_dataArray->insert(index++, items.at(i));
@@ -370,9 +492,11 @@ void QScatterDataProxyPrivate::insertItems(int index, const QScatterDataArray &i
 
 void QScatterDataProxyPrivate::removeItems(int index, int removeCount)
 {
+    detachBuffers();
     Q_ASSERT(index >= 0);
     int maxRemoveCount = m_dataArray->size() - index;
     removeCount = qMin(removeCount, maxRemoveCount);
+    releaseBounds(index, removeCount);
     m_dataArray->remove(index, removeCount);
 }
 
@@ -380,55 +504,31 @@ void QScatterDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxV
                                            QAbstract3DAxis *axisX, QAbstract3DAxis *axisY,
                                            QAbstract3DAxis *axisZ) const
 {
-    if (m_dataArray->isEmpty())
+    const int count = itemCount();
+    if (!count)
         return;
 
-    const QVector3D &firstPos = m_dataArray->at(0).position();
-
-    float minX = firstPos.x();
-    float maxX = minX;
-    float minY = firstPos.y();
-    float maxY = minY;
-    float minZ = firstPos.z();
-    float maxZ = minZ;
-
-    if (m_dataArray->size() > 1) {
-        for (int i = 1; i < m_dataArray->size(); i++) {
-            const QVector3D &pos = m_dataArray->at(i).position();
-
-            float value = pos.x();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minX, value, axisX))
-                minX = value;
-            if (maxX < value)
-                maxX = value;
-
-            value = pos.y();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minY, value, axisY))
-                minY = value;
-            if (maxY < value)
-                maxY = value;
-
-            value = pos.z();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minZ, value, axisZ))
-                minZ = value;
-            if (maxZ < value)
-                maxZ = value;
-        }
+    if (m_boundsDirty)
+        rebuildBounds();
+
+    const QVector3D firstPos = positionAt(0);
+    QAbstract3DAxis *axes[3] = { axisX, axisY, axisZ };
+
+    for (int i = 0; i < 3; i++) {
+        const AxisBounds &bounds = m_bounds[i];
+        float min = firstPos[i];
+        float max = min;
+        if (isValidValue(min, bounds.minPositive, axes[i]))
+            min = bounds.minPositive;
+        if (bounds.zeroCount && isValidValue(min, 0.0f, axes[i]))
+            min = 0.0f;
+        if (isValidValue(min, bounds.minNegative, axes[i]))
+            min = bounds.minNegative;
+        if (max < bounds.max)
+            max = bounds.max;
+        minValues[i] = min;
+        maxValues[i] = max;
     }
-
-    minValues.setX(minX);
-    minValues.setY(minY);
-    minValues.setZ(minZ);
-
-    maxValues.setX(maxX);
-    maxValues.setY(maxY);
-    maxValues.setZ(maxZ);
 }
 
 bool QScatterDataProxyPrivate::isValidValue(float axisValue, float value,
@@ -451,4 +551,129 @@ QScatterDataProxy *QScatterDataProxyPrivate::qptr()
     return static_cast<QScatterDataProxy *>(q_ptr);
 }
 
+void QScatterDataProxyPrivate::connectBoundsTracking()
+{
+    // These connections are made before any controller connects to the proxy, so the
+    // bounds are always current by the time the controller adjusts the axis ranges.
+    QScatterDataProxy *q = qptr();
+    QObject::connect(q, &QScatterDataProxy::arrayReset,
+                     this, &QScatterDataProxyPrivate::handleArrayReset);
+    QObject::connect(q, &QScatterDataProxy::itemsAdded,
+                     this, &QScatterDataProxyPrivate::handleItemsAdded);
+    QObject::connect(q, &QScatterDataProxy::itemsChanged,
+                     this, &QScatterDataProxyPrivate::handleItemsChanged);
+    QObject::connect(q, &QScatterDataProxy::itemsRemoved,
+                     this, &QScatterDataProxyPrivate::handleItemsRemoved);
+    QObject::connect(q, &QScatterDataProxy::itemsInserted,
+                     this, &QScatterDataProxyPrivate::handleItemsInserted);
+}
+
+void QScatterDataProxyPrivate::handleArrayReset()
+{
+    m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QScatterDataProxyPrivate::handleItemsAdded(int startIndex, int count)
+{
+    addBounds(startIndex, count);
+}
+
+void QScatterDataProxyPrivate::handleItemsChanged(int startIndex, int count)
+{
+    // Items changed directly in the array may have held an extreme value that is now gone
+    if (m_boundsReleased)
+        addBounds(startIndex, count);
+    else
+        m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QScatterDataProxyPrivate::handleItemsRemoved(int startIndex, int count)
+{
+    Q_UNUSED(startIndex)
+    Q_UNUSED(count)
+
+    if (!m_boundsReleased)
+        m_boundsDirty = true;
+    m_boundsReleased = false;
+}
+
+void QScatterDataProxyPrivate::handleItemsInserted(int startIndex, int count)
+{
+    addBounds(startIndex, count);
+}
+
+void QScatterDataProxyPrivate::rebuildBounds() const
+{
+    for (int i = 0; i < 3; i++) {
+        m_bounds[i].minPositive = qInf();
+        m_bounds[i].minNegative = qInf();
+        m_bounds[i].max = -qInf();
+        m_bounds[i].zeroCount = 0;
+    }
+    m_boundsDirty = false;
+
+    addBounds(0, itemCount());
+}
+
+void QScatterDataProxyPrivate::addBounds(int startIndex, int count) const
+{
+    if (m_boundsDirty)
+        return;
+
+    const int endIndex = qMin(startIndex + count, itemCount());
+    for (int i = qMax(startIndex, 0); i < endIndex; i++) {
+        // A non-finite coordinate excludes the remaining coordinates of the item as well
+        const QVector3D pos = positionAt(i);
+        for (int j = 0; j < 3 && addBounds(m_bounds[j], pos[j]); j++) {}
+    }
+}
+
+bool QScatterDataProxyPrivate::addBounds(AxisBounds &bounds, float value) const
+{
+    if (qIsNaN(value) || qIsInf(value))
+        return false;
+
+    if (value > 0.0f)
+        bounds.minPositive = qMin(bounds.minPositive, value);
+    else if (value < 0.0f)
+        bounds.minNegative = qMin(bounds.minNegative, value);
+    else
+        bounds.zeroCount++;
+    bounds.max = qMax(bounds.max, value);
+
+    return true;
+}
+
+void QScatterDataProxyPrivate::releaseBounds(int startIndex, int count)
+{
+    m_boundsReleased = true;
+
+    const int endIndex = qMin(startIndex + count, itemCount());
+    for (int i = startIndex; i < endIndex && !m_boundsDirty; i++) {
+        const QVector3D pos = positionAt(i);
+        for (int j = 0; j < 3; j++) {
+            float value = pos[j];
+            if (qIsNaN(value) || qIsInf(value))
+                break;
+            if (!releaseBounds(m_bounds[j], value)) {
+                m_boundsDirty = true;
+                break;
+            }
+        }
+    }
+}
+
+bool QScatterDataProxyPrivate::releaseBounds(AxisBounds &bounds, float value)
+{
+    // Returns false if the value is an extreme, as the next one is not known without a rescan
+    if (value == bounds.max || value == bounds.minPositive || value == bounds.minNegative)
+        return false;
+    if (value == 0.0f)
+        bounds.zeroCount--;
+
+    return true;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -58,8 +58,11 @@ public:
     int itemCount() const;
     const QScatterDataArray *array() const;
     const QScatterDataItem *itemAt(int index) const;
+    QScatterDataItem itemValueAt(int index) const;
 
     void resetArray(QScatterDataArray *newArray);
+    void resetArray(const float *xValues, const float *yValues, const float *zValues, int count,
+                    const QQuaternion *rotations = Q_NULLPTR);
 
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
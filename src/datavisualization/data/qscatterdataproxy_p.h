@@ -56,6 +56,8 @@ public:
     virtual ~QScatterDataProxyPrivate();
 
     void resetArray(QScatterDataArray *newArray);
+    void resetBuffers(const float *xValues, const float *yValues, const float *zValues,
+                      int count, const QQuaternion *rotations);
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
     int addItem(const QScatterDataItem &item);
@@ -68,9 +70,64 @@ public:
     bool isValidValue(float axisValue, float value, QAbstract3DAxis *axis) const;
 
     virtual void setSeries(QAbstract3DSeries *series);
+
+    inline bool hasBuffers() const { return m_xBuffer; }
+    inline int itemCount() const { return m_xBuffer ? m_bufferCount : m_dataArray->size(); }
+    inline QVector3D positionAt(int index) const
+    {
+        if (m_xBuffer)
+            return QVector3D(m_xBuffer[index], m_yBuffer[index], m_zBuffer[index]);
+        return m_dataArray->at(index).position();
+    }
+    inline QQuaternion rotationAt(int index) const
+    {
+        if (m_xBuffer)
+            return m_rotationBuffer ? m_rotationBuffer[index] : QQuaternion();
+        return m_dataArray->at(index).rotation();
+    }
+
+public Q_SLOTS:
+    void handleArrayReset();
+    void handleItemsAdded(int startIndex, int count);
+    void handleItemsChanged(int startIndex, int count);
+    void handleItemsRemoved(int startIndex, int count);
+    void handleItemsInserted(int startIndex, int count);
+
 private:
+    // Value extents of a single axis, split by sign so that the valid minimum can be
+    // resolved against the axis at query time.
+    struct AxisBounds {
+        float minPositive;  // Infinity if there are no positive values
+        float minNegative;  // Infinity if there are no negative values
+        float max;          // Negative infinity if there are no finite values
+        int zeroCount;
+    };
+
     QScatterDataProxy *qptr();
+    void detachBuffers();
+    void clearBuffers();
+    void connectBoundsTracking();
+    void rebuildBounds() const;
+    void addBounds(int startIndex, int count) const;
+    bool addBounds(AxisBounds &bounds, float value) const;
+    void releaseBounds(int startIndex, int count);
+    bool releaseBounds(AxisBounds &bounds, float value);
+
     QScatterDataArray *m_dataArray;
+    // Caller-owned position and rotation buffers, used instead of m_dataArray when set
+    const float *m_xBuffer;
+    const float *m_yBuffer;
+    const float *m_zBuffer;
+    const QQuaternion *m_rotationBuffer;
+    int m_bufferCount;
+
+    // Extents of all items for X, Y, and Z, maintained on mutation. A full rescan is only
+    // needed after an extreme value has been overwritten or removed (m_boundsDirty).
+    mutable AxisBounds m_bounds[3];
+    mutable bool m_boundsDirty;
+    // Set when the items about to be changed or removed have already been released from
+    // the bounds, i.e. the change came through the proxy rather than direct array access
+    bool m_boundsReleased;
 
     friend class QScatterDataProxy;
 };
@@ -165,6 +165,29 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * file name is set.
  */
 
+/*!
+ * \qmlproperty real Surface3DSeries::lodThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * The largest error in pixels allowed when parts of the surface are drawn with
+ * fewer triangles. The surface is split into square blocks, and each block is drawn
+ * with the coarsest tessellation whose projected error stays below this threshold.
+ * Only smooth shaded surfaces are drawn with a level of detail, so flatShadingEnabled
+ * must be \c false for this to have an effect.
+ * The preset default is \c 0.0, which disables the level of detail selection.
+ */
+
+/*!
+ * \qmlproperty bool Surface3DSeries::heightfieldRenderingEnabled
+ * \since QtDataVisualization 1.3
+ *
+ * Whether the surface is drawn from a texture of its heights when possible. When
+ * \c true, a smooth shaded surface whose samples lie on a uniform grid is drawn from a texture of its heights,
+ * with the positions and normals generated on the GPU. Data changes then only upload
+ * the changed heights. Surfaces that do not qualify are drawn normally.
+ * The preset default is \c false.
+ */
+
 
 /*!
  * \enum QSurface3DSeries::DrawFlag
@@ -398,6 +421,74 @@ QString QSurface3DSeries::textureFile() const
     return dptrc()->m_textureFile;
 }
 
+/*!
+ * \property QSurface3DSeries::lodThreshold
+ * \since QtDataVisualization 1.3
+ *
+ * \brief The largest projected error in pixels allowed for the surface level of
+ * detail.
+ *
+ * When the threshold is larger than zero, the surface is split into square blocks of
+ * samples. Each block has a set of tessellations that skip more and more of its samples,
+ * and every frame the coarsest one whose geometric error, projected to the screen at the
+ * distance of the block from the camera, is at most this many pixels is drawn. Distant
+ * parts of large surfaces are then drawn with a fraction of the triangles, while the
+ * parts close to the camera keep their full detail. The edges of neighboring blocks
+ * are matched, so no gaps open between blocks of different detail.
+ *
+ * Only smooth shaded surfaces are drawn with a level of detail, so flatShadingEnabled
+ * must be \c false for this to have an effect. The slice view always shows the full
+ * detail.
+ *
+ * The value must not be negative. The preset default is \c 0.0f, which disables the
+ * level of detail selection.
+ */
+void QSurface3DSeries::setLodThreshold(float pixels)
+{
+    if (pixels < 0.0f) {
+        qWarning("Invalid threshold. lodThreshold cannot be negative");
+    } else if (pixels != dptr()->m_lodThreshold) {
+        dptr()->setLodThreshold(pixels);
+        emit lodThresholdChanged(pixels);
+    }
+}
+
+float QSurface3DSeries::lodThreshold() const
+{
+    return dptrc()->m_lodThreshold;
+}
+
+/*!
+ * \property QSurface3DSeries::heightfieldRenderingEnabled
+ * \since QtDataVisualization 1.3
+ *
+ * \brief Whether the surface is drawn from a texture of its heights when possible.
+ *
+ * When enabled, a surface whose samples lie on a uniform grid keeps only the heights of
+ * its samples in a texture. The vertex shader generates the positions and normals from
+ * the texture and a static grid that is shared by all frames, so a data change uploads
+ * one float per changed sample instead of a position and a normal.
+ *
+ * The heightfield is only used for smooth shaded surfaces without a texture, on graphs
+ * that are not polar, and when the platform supports texture lookups in vertex shaders.
+ * It is not supported on OpenGL ES 2. In all other cases, and when the data moves off
+ * the uniform grid, the surface is drawn normally.
+ *
+ * The preset default is \c false.
+ */
+void QSurface3DSeries::setHeightfieldRenderingEnabled(bool enabled)
+{
+    if (dptr()->m_heightfieldRenderingEnabled != enabled) {
+        dptr()->setHeightfieldRenderingEnabled(enabled);
+        emit heightfieldRenderingEnabledChanged(enabled);
+    }
+}
+
+bool QSurface3DSeries::isHeightfieldRenderingEnabled() const
+{
+    return dptrc()->m_heightfieldRenderingEnabled;
+}
+
 /*!
  * \internal
  */
@@ -420,7 +511,9 @@ QSurface3DSeriesPrivate::QSurface3DSeriesPrivate(QSurface3DSeries *q)
     : QAbstract3DSeriesPrivate(q, QAbstract3DSeries::SeriesTypeSurface),
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
       m_flatShadingEnabled(true),
-      m_drawMode(QSurface3DSeries::DrawSurfaceAndWireframe)
+      m_drawMode(QSurface3DSeries::DrawSurfaceAndWireframe),
+      m_lodThreshold(0.0f),
+      m_heightfieldRenderingEnabled(false)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -469,6 +562,8 @@ void QSurface3DSeriesPrivate::connectControllerAndProxy(Abstract3DController *ne
                          &Surface3DController::handleRowsInserted);
         QObject::connect(surfaceDataProxy, &QSurfaceDataProxy::itemChanged, controller,
                          &Surface3DController::handleItemChanged);
+        QObject::connect(surfaceDataProxy, &QSurfaceDataProxy::rowsShifted, controller,
+                         &Surface3DController::handleRowsShifted);
         QObject::connect(qptr(), &QSurface3DSeries::dataProxyChanged, controller,
                          &Surface3DController::handleArrayReset);
     }
@@ -553,4 +648,18 @@ void QSurface3DSeriesPrivate::setTexture(const QImage &texture)
         static_cast<Surface3DController *>(m_controller)->updateSurfaceTexture(qptr());
 }
 
+void QSurface3DSeriesPrivate::setLodThreshold(float pixels)
+{
+    m_lodThreshold = pixels;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QSurface3DSeriesPrivate::setHeightfieldRenderingEnabled(bool enabled)
+{
+    m_heightfieldRenderingEnabled = enabled;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -60,6 +60,8 @@ public:
     void setFlatShadingEnabled(bool enabled);
     void setDrawMode(QSurface3DSeries::DrawFlags mode);
     void setTexture(const QImage &texture);
+    void setLodThreshold(float pixels);
+    void setHeightfieldRenderingEnabled(bool enabled);
 
 private:
     QSurface3DSeries *qptr();
@@ -69,6 +71,8 @@ private:
     QSurface3DSeries::DrawFlags m_drawMode;
     QImage m_texture;
     QString m_textureFile;
+    float m_lodThreshold;
+    bool m_heightfieldRenderingEnabled;
 
 private:
     friend class QSurface3DSeries;
@@ -30,6 +30,7 @@
 #include "qsurfacedataproxy_p.h"
 #include "qsurface3dseries_p.h"
 #include "qabstract3daxis_p.h"
+#include <QtCore/qnumeric.h>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -130,6 +131,7 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 QSurfaceDataProxy::QSurfaceDataProxy(QObject *parent) :
     QAbstractDataProxy(new QSurfaceDataProxyPrivate(this), parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -138,6 +140,7 @@ QSurfaceDataProxy::QSurfaceDataProxy(QObject *parent) :
 QSurfaceDataProxy::QSurfaceDataProxy(QSurfaceDataProxyPrivate *d, QObject *parent) :
     QAbstractDataProxy(d, parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -288,6 +291,53 @@ void QSurfaceDataProxy::removeRows(int rowIndex, int removeCount)
     }
 }
 
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new row \a row to the end of the array and removes the first row,
+ * so that the number of rows stays the same. The new row must have the same
+ * number of columns as the rows in the array. If the array is empty, the
+ * row is added to it.
+ *
+ * This is intended for streaming data, such as waterfall plots, where a new
+ * row is added on each update and the oldest row drops out. The graph only
+ * needs to process the new row instead of the whole array.
+ *
+ * \sa shiftRows(), rowsShifted()
+ */
+void QSurfaceDataProxy::shiftRow(QSurfaceDataRow *row)
+{
+    QSurfaceDataArray rows;
+    rows.append(row);
+    shiftRows(rows);
+}
+
+/*!
+ * \since QtDataVisualization 1.3
+ *
+ * Adds the new \a rows to the end of the array and removes the same number of
+ * rows from the beginning of it, so that the number of rows stays the same.
+ * The new rows must have the same number of columns as the rows in the array.
+ *
+ * If \a rows holds at least as many rows as the array, the array is reset to
+ * contain just the new rows and arrayReset() is emitted instead of
+ * rowsShifted().
+ *
+ * \sa shiftRow(), rowsShifted()
+ */
+void QSurfaceDataProxy::shiftRows(const QSurfaceDataArray &rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    if (rows.size() >= rowCount()) {
+        resetArray(new QSurfaceDataArray(rows));
+    } else {
+        dptr()->shiftRows(rows);
+        emit rowsShifted(rows.size());
+    }
+}
+
 /*!
  * Returns the pointer to the data array.
  */
@@ -406,6 +456,18 @@ const QSurfaceDataProxyPrivate *QSurfaceDataProxy::dptrc() const
  * insertRows(), this signal needs to be emitted to update the graph.
  */
 
+/*!
+ * \fn void QSurfaceDataProxy::rowsShifted(int count)
+ * \since QtDataVisualization 1.3
+ *
+ * This signal is emitted when the number of rows specified by \a count is
+ * added to the end of the array and the same number of rows is removed from
+ * the beginning of it.
+ *
+ * If rows are shifted in the array without calling shiftRow() or
+ * shiftRows(), this signal needs to be emitted to update the graph.
+ */
+
 /*!
  * \fn void QSurfaceDataProxy::itemChanged(int rowIndex, int columnIndex)
  *
@@ -519,11 +581,167 @@ void QSurfaceDataProxyPrivate::removeRows(int rowIndex, int removeCount)
     }
 }
 
+void QSurfaceDataProxyPrivate::shiftRows(const QSurfaceDataArray &rows)
+{
+    Q_ASSERT(rows.size() < m_dataArray->size());
+
+    int shiftCount = rows.size();
+    for (int i = 0; i < shiftCount; i++) {
+        Q_ASSERT(m_dataArray->at(0)->size() == rows.at(i)->size());
+        clearRow(i);
+    }
+    m_dataArray->remove(0, shiftCount);
+    *m_dataArray += rows;
+}
+
 QSurfaceDataProxy *QSurfaceDataProxyPrivate::qptr()
 {
     return static_cast<QSurfaceDataProxy *>(q_ptr);
 }
 
+void QSurfaceDataProxyPrivate::connectLimitTracking()
+{
+    // These connections are made before any controller connects to the proxy, so the
+    // limits are always current by the time the controller adjusts the axis ranges.
+    QSurfaceDataProxy *q = qptr();
+    QObject::connect(q, &QSurfaceDataProxy::arrayReset,
+                     this, &QSurfaceDataProxyPrivate::handleArrayReset);
+    QObject::connect(q, &QSurfaceDataProxy::rowsAdded,
+                     this, &QSurfaceDataProxyPrivate::handleRowsAdded);
+    QObject::connect(q, &QSurfaceDataProxy::rowsChanged,
+                     this, &QSurfaceDataProxyPrivate::handleRowsChanged);
+    QObject::connect(q, &QSurfaceDataProxy::rowsRemoved,
+                     this, &QSurfaceDataProxyPrivate::handleRowsRemoved);
+    QObject::connect(q, &QSurfaceDataProxy::rowsInserted,
+                     this, &QSurfaceDataProxyPrivate::handleRowsInserted);
+    QObject::connect(q, &QSurfaceDataProxy::itemChanged,
+                     this, &QSurfaceDataProxyPrivate::handleItemChanged);
+    QObject::connect(q, &QSurfaceDataProxy::rowsShifted,
+                     this, &QSurfaceDataProxyPrivate::handleRowsShifted);
+}
+
+void QSurfaceDataProxyPrivate::handleArrayReset()
+{
+    m_rowLimits.clear();
+    rebuildLimitTree();
+}
+
+void QSurfaceDataProxyPrivate::handleRowsAdded(int startIndex, int count)
+{
+    handleRowsInserted(startIndex, count);
+}
+
+void QSurfaceDataProxyPrivate::handleRowsChanged(int startIndex, int count)
+{
+    if (m_rowLimits.size() != m_dataArray->size()) {
+        rebuildLimitTree();
+        return;
+    }
+
+    int endIndex = qMin(startIndex + count, m_dataArray->size());
+    for (int i = qMax(startIndex, 0); i < endIndex; i++) {
+        m_rowLimits[i] = calculateRowLimits(m_dataArray->at(i));
+        updateLimitTree(i);
+    }
+}
+
+void QSurfaceDataProxyPrivate::handleRowsRemoved(int startIndex, int count)
+{
+    if (startIndex >= 0 && startIndex < m_rowLimits.size())
+        m_rowLimits.remove(startIndex, qMin(count, m_rowLimits.size() - startIndex));
+    rebuildLimitTree();
+}
+
+void QSurfaceDataProxyPrivate::handleRowsInserted(int startIndex, int count)
+{
+    if (startIndex >= 0 && startIndex <= m_rowLimits.size()
+            && m_rowLimits.size() + count == m_dataArray->size()) {
+        m_rowLimits.insert(startIndex, count, RowLimits());
+        for (int i = startIndex; i < startIndex + count; i++)
+            m_rowLimits[i] = calculateRowLimits(m_dataArray->at(i));
+    }
+    rebuildLimitTree();
+}
+
+void QSurfaceDataProxyPrivate::handleRowsShifted(int count)
+{
+    handleRowsRemoved(0, count);
+    handleRowsAdded(m_dataArray->size() - count, count);
+}
+
+void QSurfaceDataProxyPrivate::handleItemChanged(int rowIndex, int columnIndex)
+{
+    Q_UNUSED(columnIndex)
+
+    // A changed item may have been the extreme of its row, so the whole row is rescanned.
+    handleRowsChanged(rowIndex, 1);
+}
+
+QSurfaceDataProxyPrivate::RowLimits QSurfaceDataProxyPrivate::calculateRowLimits(
+        const QSurfaceDataRow *row) const
+{
+    RowLimits limits;
+    limits.minPositive = qInf();
+    limits.minNegative = qInf();
+    limits.max = -qInf();
+    limits.hasZero = false;
+
+    if (row) {
+        const int columns = row->size();
+        for (int j = 0; j < columns; j++) {
+            float itemValue = row->at(j).y();
+            if (qIsNaN(itemValue) || qIsInf(itemValue))
+                continue;
+            if (itemValue > 0.0f)
+                limits.minPositive = qMin(limits.minPositive, itemValue);
+            else if (itemValue < 0.0f)
+                limits.minNegative = qMin(limits.minNegative, itemValue);
+            else
+                limits.hasZero = true;
+            limits.max = qMax(limits.max, itemValue);
+        }
+    }
+
+    return limits;
+}
+
+void QSurfaceDataProxyPrivate::rebuildLimitTree() const
+{
+    const int rows = m_dataArray->size();
+    if (m_rowLimits.size() != rows) {
+        m_rowLimits.resize(rows);
+        for (int i = 0; i < rows; i++)
+            m_rowLimits[i] = calculateRowLimits(m_dataArray->at(i));
+    }
+
+    m_limitTree.resize(2 * rows);
+    for (int i = 0; i < rows; i++)
+        m_limitTree[rows + i] = m_rowLimits.at(i);
+    for (int i = rows - 1; i > 0; i--) {
+        m_limitTree[i] = m_limitTree.at(2 * i);
+        mergeLimits(m_limitTree[i], m_limitTree.at(2 * i + 1));
+    }
+}
+
+void QSurfaceDataProxyPrivate::updateLimitTree(int rowIndex) const
+{
+    const int rows = m_rowLimits.size();
+    int node = rows + rowIndex;
+    m_limitTree[node] = m_rowLimits.at(rowIndex);
+    for (node /= 2; node > 0; node /= 2) {
+        m_limitTree[node] = m_limitTree.at(2 * node);
+        mergeLimits(m_limitTree[node], m_limitTree.at(2 * node + 1));
+    }
+}
+
+void QSurfaceDataProxyPrivate::mergeLimits(RowLimits &target, const RowLimits &source)
+{
+    target.minPositive = qMin(target.minPositive, source.minPositive);
+    target.minNegative = qMin(target.minNegative, source.minNegative);
+    target.max = qMax(target.max, source.max);
+    target.hasZero = target.hasZero || source.hasZero;
+}
+
 void QSurfaceDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxValues,
                                            QAbstract3DAxis *axisX, QAbstract3DAxis *axisY,
                                            QAbstract3DAxis *axisZ) const
@@ -539,21 +757,22 @@ void QSurfaceDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxV
     if (rows && columns) {
         min = m_dataArray->at(0)->at(0).y();
         max = m_dataArray->at(0)->at(0).y();
-    }
 
-    for (int i = 0; i < rows; i++) {
-        QSurfaceDataRow *row = m_dataArray->at(i);
-        if (row) {
-            for (int j = 0; j < columns; j++) {
-                float itemValue = m_dataArray->at(i)->at(j).y();
-                if (qIsNaN(itemValue) || qIsInf(itemValue))
-                    continue;
-                if (min > itemValue && isValidValue(itemValue, axisY))
-                    min = itemValue;
-                if (max < itemValue)
-                    max = itemValue;
-            }
-        }
+        // The tracked limits only go stale if the array was modified without emitting
+        // the corresponding change signal, or while signals were blocked.
+        if (m_rowLimits.size() != rows)
+            rebuildLimitTree();
+
+        const RowLimits &limits = m_limitTree.at(1);
+        float validMin = limits.minPositive;
+        if (limits.hasZero && isValidValue(0.0f, axisY))
+            validMin = qMin(validMin, 0.0f);
+        if (limits.minNegative < 0.0f && isValidValue(limits.minNegative, axisY))
+            validMin = qMin(validMin, limits.minNegative);
+        if (min > validMin)
+            min = validMin;
+        if (max < limits.max)
+            max = limits.max;
     }
 
     minValues.setY(min);
@@ -79,6 +79,9 @@ public:
 
     void removeRows(int rowIndex, int removeCount);
 
+    void shiftRow(QSurfaceDataRow *row);
+    void shiftRows(const QSurfaceDataArray &rows);
+
 Q_SIGNALS:
     void arrayReset();
     void rowsAdded(int startIndex, int count);
@@ -86,6 +89,7 @@ Q_SIGNALS:
     void rowsRemoved(int startIndex, int count);
     void rowsInserted(int startIndex, int count);
     void itemChanged(int rowIndex, int columnIndex);
+    void rowsShifted(int count);
 
     void rowCountChanged(int count);
     void columnCountChanged(int count);
@@ -63,19 +63,48 @@ public:
     void insertRow(int rowIndex, QSurfaceDataRow *row);
     void insertRows(int rowIndex, const QSurfaceDataArray &rows);
     void removeRows(int rowIndex, int removeCount);
+    void shiftRows(const QSurfaceDataArray &rows);
     void limitValues(QVector3D &minValues, QVector3D &maxValues, QAbstract3DAxis *axisX,
                      QAbstract3DAxis *axisY, QAbstract3DAxis *axisZ) const;
     bool isValidValue(float value, QAbstract3DAxis *axis) const;
 
     virtual void setSeries(QAbstract3DSeries *series);
 
+public Q_SLOTS:
+    void handleArrayReset();
+    void handleRowsAdded(int startIndex, int count);
+    void handleRowsChanged(int startIndex, int count);
+    void handleRowsRemoved(int startIndex, int count);
+    void handleRowsInserted(int startIndex, int count);
+    void handleItemChanged(int rowIndex, int columnIndex);
+    void handleRowsShifted(int count);
+
 protected:
     QSurfaceDataArray *m_dataArray;
 
 private:
+    // Y value extents of a single row, split by sign so that the valid minimum can be
+    // resolved against the axis at query time.
+    struct RowLimits {
+        float minPositive;  // Infinity if the row has no positive values
+        float minNegative;  // Infinity if the row has no negative values
+        float max;          // Negative infinity if the row has no finite values
+        bool hasZero;
+    };
+
     QSurfaceDataProxy *qptr();
     void clearRow(int rowIndex);
     void clearArray();
+    void connectLimitTracking();
+    RowLimits calculateRowLimits(const QSurfaceDataRow *row) const;
+    void rebuildLimitTree() const;
+    void updateLimitTree(int rowIndex) const;
+    static void mergeLimits(RowLimits &target, const RowLimits &source);
+
+    // Per-row Y extents and a segment tree over them (root at index 1, leaves from
+    // m_rowLimits.size() onwards), kept up to date from the proxy's own change signals.
+    mutable QVector<RowLimits> m_rowLimits;
+    mutable QVector<RowLimits> m_limitTree;
 
     friend class QSurfaceDataProxy;
 };
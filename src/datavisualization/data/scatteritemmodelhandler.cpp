@@ -194,13 +194,13 @@ void ScatterItemModelHandler::modelPosToScatterItem(int modelRow, int modelColum
     item.setPosition(QVector3D(xPos, yPos, zPos));
 }
 
-// Resolve entire item model into QScatterDataArray.
-void ScatterItemModelHandler::resolveModel()
+// Take a snapshot of the entire item model for resolving it into QScatterDataArray.
+ItemModelResolveTask *ScatterItemModelHandler::createResolveTask()
 {
     if (m_itemModel.isNull()) {
         m_proxy->resetArray(0);
         m_proxyArray = 0;
-        return;
+        return 0;
     }
 
     m_xPosPattern = m_proxy->xPosRolePattern();
@@ -221,24 +221,132 @@ void ScatterItemModelHandler::resolveModel()
     m_yPosRole = roleHash.key(m_proxy->yPosRole().toLatin1(), noRoleIndex);
     m_zPosRole = roleHash.key(m_proxy->zPosRole().toLatin1(), noRoleIndex);
     m_rotationRole = roleHash.key(m_proxy->rotationRole().toLatin1(), noRoleIndex);
-    const int columnCount = m_itemModel->columnCount();
-    const int rowCount = m_itemModel->rowCount();
-    const int totalCount = rowCount * columnCount;
+
+    ScatterItemModelResolveTask *task = new ScatterItemModelResolveTask;
+    task->m_xPosPattern = m_xPosPattern;
+    task->m_yPosPattern = m_yPosPattern;
+    task->m_zPosPattern = m_zPosPattern;
+    task->m_rotationPattern = m_rotationPattern;
+    task->m_xPosReplace = m_xPosReplace;
+    task->m_yPosReplace = m_yPosReplace;
+    task->m_zPosReplace = m_zPosReplace;
+    task->m_rotationReplace = m_rotationReplace;
+    task->m_haveXPosPattern = m_haveXPosPattern;
+    task->m_haveYPosPattern = m_haveYPosPattern;
+    task->m_haveZPosPattern = m_haveZPosPattern;
+    task->m_haveRotationPattern = m_haveRotationPattern;
+
+    // Only the mapped roles are read from the model
+    QVector<int> roles;
+    if (m_xPosRole != noRoleIndex) {
+        task->m_xPosRoleIndex = roles.size();
+        roles.append(m_xPosRole);
+    }
+    if (m_yPosRole != noRoleIndex) {
+        task->m_yPosRoleIndex = roles.size();
+        roles.append(m_yPosRole);
+    }
+    if (m_zPosRole != noRoleIndex) {
+        task->m_zPosRoleIndex = roles.size();
+        roles.append(m_zPosRole);
+    }
+    if (m_rotationRole != noRoleIndex) {
+        task->m_rotationRoleIndex = roles.size();
+        roles.append(m_rotationRole);
+    }
+
+    // Existing array can only be written to directly when resolving right away
+    if (!m_asynchronous && m_proxyArray && m_proxyArray == m_proxy->array())
+        task->m_reuseArray = m_proxyArray;
+
+    task->takeSnapshot(m_itemModel.data(), roles);
+
+    return task;
+}
+
+void ScatterItemModelHandler::applyResolveTask(ItemModelResolveTask *task)
+{
+    m_proxyArray = static_cast<ScatterItemModelResolveTask *>(task)->takeArray();
+    m_proxy->resetArray(m_proxyArray);
+}
+
+//  ScatterItemModelResolveTask
+
+ScatterItemModelResolveTask::ScatterItemModelResolveTask()
+    : m_xPosRoleIndex(noRoleIndex),
+      m_yPosRoleIndex(noRoleIndex),
+      m_zPosRoleIndex(noRoleIndex),
+      m_rotationRoleIndex(noRoleIndex),
+      m_haveXPosPattern(false),
+      m_haveYPosPattern(false),
+      m_haveZPosPattern(false),
+      m_haveRotationPattern(false),
+      m_reuseArray(0),
+      m_array(0)
+{
+}
+
+ScatterItemModelResolveTask::~ScatterItemModelResolveTask()
+{
+    if (m_array != m_reuseArray)
+        delete m_array;
+}
+
+QScatterDataArray *ScatterItemModelResolveTask::takeArray()
+{
+    QScatterDataArray *array = m_array;
+    m_array = 0;
+    return array;
+}
+
+float ScatterItemModelResolveTask::toFloat(int row, int column, int roleIndex, bool havePattern,
+                                           const QRegExp &pattern, const QString &replace) const
+{
+    if (roleIndex == noRoleIndex)
+        return 0.0f;
+    else if (havePattern)
+        return value(row, column, roleIndex).toString().replace(pattern, replace).toFloat();
+    else
+        return value(row, column, roleIndex).toFloat();
+}
+
+void ScatterItemModelResolveTask::resolve()
+{
+    const int totalCount = m_rowCount * m_columnCount;
     int runningCount = 0;
 
     // If dimensions have changed, recreate the array
-    if (m_proxyArray != m_proxy->array() || totalCount != m_proxyArray->size())
-        m_proxyArray = new QScatterDataArray(totalCount);
+    if (m_reuseArray && m_reuseArray->size() == totalCount)
+        m_array = m_reuseArray;
+    else
+        m_array = new QScatterDataArray(totalCount);
 
     // Parse data into newProxyArray
-    for (int i = 0; i < rowCount; i++) {
-        for (int j = 0; j < columnCount; j++) {
-            modelPosToScatterItem(i, j, (*m_proxyArray)[runningCount]);
-            runningCount++;
+    QScatterDataItem *items = m_array->data();
+    for (int i = 0; i < m_rowCount; i++) {
+        if (isCancelled())
+            return;
+        for (int j = 0; j < m_columnCount; j++) {
+            QScatterDataItem &item = items[runningCount++];
+            if (m_rotationRoleIndex != noRoleIndex) {
+                const QVariant &rotationVar = value(i, j, m_rotationRoleIndex);
+                if (m_haveRotationPattern) {
+                    item.setRotation(
+                                toQuaternion(
+                                    QVariant(rotationVar.toString().replace(m_rotationPattern,
+                                                                            m_rotationReplace))));
+                } else {
+                    item.setRotation(toQuaternion(rotationVar));
+                }
+            }
+            item.setPosition(QVector3D(toFloat(i, j, m_xPosRoleIndex, m_haveXPosPattern,
+                                               m_xPosPattern, m_xPosReplace),
+                                       toFloat(i, j, m_yPosRoleIndex, m_haveYPosPattern,
+                                               m_yPosPattern, m_yPosReplace),
+                                       toFloat(i, j, m_zPosRoleIndex, m_haveZPosPattern,
+                                               m_zPosPattern, m_zPosReplace)));
         }
     }
-
-    m_proxy->resetArray(m_proxyArray);
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
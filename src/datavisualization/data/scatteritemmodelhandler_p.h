@@ -45,6 +45,45 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class ScatterItemModelResolveTask : public ItemModelResolveTask
+{
+public:
+    ScatterItemModelResolveTask();
+    virtual ~ScatterItemModelResolveTask();
+
+    virtual void resolve();
+    QScatterDataArray *takeArray();
+
+private:
+    float toFloat(int row, int column, int roleIndex, bool havePattern, const QRegExp &pattern,
+                  const QString &replace) const;
+
+    // Snapshot role indexes, -1 if the role is not in the snapshot
+    int m_xPosRoleIndex;
+    int m_yPosRoleIndex;
+    int m_zPosRoleIndex;
+    int m_rotationRoleIndex;
+
+    QRegExp m_xPosPattern;
+    QRegExp m_yPosPattern;
+    QRegExp m_zPosPattern;
+    QRegExp m_rotationPattern;
+    QString m_xPosReplace;
+    QString m_yPosReplace;
+    QString m_zPosReplace;
+    QString m_rotationReplace;
+    bool m_haveXPosPattern;
+    bool m_haveYPosPattern;
+    bool m_haveZPosPattern;
+    bool m_haveRotationPattern;
+
+    // Array that can be written to directly if the size does not change. Not owned.
+    QScatterDataArray *m_reuseArray;
+    QScatterDataArray *m_array;
+
+    friend class ScatterItemModelHandler;
+};
+
 class ScatterItemModelHandler : public AbstractItemModelHandler
 {
     Q_OBJECT
@@ -59,7 +98,8 @@ public Q_SLOTS:
     virtual void handleRowsRemoved(const QModelIndex &parent, int start, int end);
 
 protected:
-    void virtual resolveModel();
+    virtual ItemModelResolveTask *createResolveTask();
+    virtual void applyResolveTask(ItemModelResolveTask *task);
 
 private:
     void modelPosToScatterItem(int modelRow, int modelColumn, QScatterDataItem &item);
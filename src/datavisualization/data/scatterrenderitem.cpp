@@ -38,10 +38,9 @@ ScatterRenderItem::ScatterRenderItem()
 }
 
 ScatterRenderItem::ScatterRenderItem(const ScatterRenderItem &other)
-    : AbstractRenderItem(other)
+    : AbstractRenderItem(other),
+      m_visible(other.m_visible)
 {
-    m_position = other.m_position;
-    m_visible = other.m_visible;
 }
 
 ScatterRenderItem::~ScatterRenderItem()
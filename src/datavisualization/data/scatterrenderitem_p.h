@@ -49,24 +49,22 @@ class ScatterRenderItem : public AbstractRenderItem
 public:
     ScatterRenderItem();
     ScatterRenderItem(const ScatterRenderItem &other);
-    virtual ~ScatterRenderItem();
-
-    inline const QVector3D &position() const { return m_position; }
-    inline void setPosition(const QVector3D &pos)
-    {
-        if (m_position != pos)
-            m_position = pos;
-    }
+    ~ScatterRenderItem();
 
     inline bool isVisible() const { return m_visible; }
     inline void setVisible(bool visible) { m_visible = visible; }
 
 protected:
-    QVector3D m_position;
+    // The data position is not stored, as the translation is always calculated directly
+    // from the data item. Keep the item small, large series have millions of these.
     bool m_visible;
 };
 typedef QVector<ScatterRenderItem> ScatterRenderItemArray;
 
 QT_END_NAMESPACE_DATAVISUALIZATION
 
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(QtDataVisualization::ScatterRenderItem, Q_MOVABLE_TYPE);
+QT_END_NAMESPACE
+
 #endif
@@ -56,88 +56,249 @@ void SurfaceItemModelHandler::handleDataChanged(const QModelIndex &topLeft,
 {
     // Do nothing if full reset already pending
     if (!m_fullReset) {
-        if (!m_proxy->useModelCategories()) {
-            // If the data model doesn't directly map rows and columns, we cannot optimize
+        int startRow = qMin(topLeft.row(), bottomRight.row());
+        int endRow = qMax(topLeft.row(), bottomRight.row());
+        int startCol = qMin(topLeft.column(), bottomRight.column());
+        int endCol = qMax(topLeft.column(), bottomRight.column());
+
+        if (m_proxy->useModelCategories()) {
+            updateModelRows(startRow, endRow, startCol, endCol);
+        } else if (!updateCategoryItems(startRow, endRow, startCol, endCol)) {
+            m_categoryMapping.clear();
             AbstractItemModelHandler::handleDataChanged(topLeft, bottomRight, roles);
-        } else {
-            int startRow = qMin(topLeft.row(), bottomRight.row());
-            int endRow = qMax(topLeft.row(), bottomRight.row());
-            int startCol = qMin(topLeft.column(), bottomRight.column());
-            int endCol = qMax(topLeft.column(), bottomRight.column());
-
-            for (int i = startRow; i <= endRow; i++) {
-                for (int j = startCol; j <= endCol; j++) {
-                    QModelIndex index = m_itemModel->index(i, j);
-                    QSurfaceDataItem item;
-                    QVariant xValueVar = index.data(m_xPosRole);
-                    QVariant yValueVar = index.data(m_yPosRole);
-                    QVariant zValueVar = index.data(m_zPosRole);
-                    const QSurfaceDataItem *oldItem = m_proxy->itemAt(i, j);
-                    float xPos;
-                    float yPos;
-                    float zPos;
-                    if (m_xPosRole != noRoleIndex) {
-                        if (m_haveXPosPattern)
-                            xPos = xValueVar.toString().replace(m_xPosPattern, m_xPosReplace).toFloat();
-                        else
-                            xPos = xValueVar.toFloat();
-                    } else {
-                        xPos = oldItem->x();
-                    }
-
-                    if (m_haveYPosPattern)
-                        yPos = yValueVar.toString().replace(m_yPosPattern, m_yPosReplace).toFloat();
-                    else
-                        yPos = yValueVar.toFloat();
-
-                    if (m_zPosRole != noRoleIndex) {
-                        if (m_haveZPosPattern)
-                            zPos = zValueVar.toString().replace(m_zPosPattern, m_zPosReplace).toFloat();
-                        else
-                            zPos = zValueVar.toFloat();
-                    } else {
-                        zPos = oldItem->z();
-                    }
-                    item.setPosition(QVector3D(xPos, yPos, zPos));
-                    m_proxy->setItem(i, j, item);
-                }
+        }
+    }
+}
+
+void SurfaceItemModelHandler::handleRowsInserted(const QModelIndex &parent, int start, int end)
+{
+    // Do nothing if full reset already pending
+    if (!m_fullReset) {
+        bool handled = m_proxy->useModelCategories() ? insertModelRows(start, end)
+                                                     : insertCategoryItems(start, end);
+        if (!handled) {
+            m_categoryMapping.clear();
+            AbstractItemModelHandler::handleRowsInserted(parent, start, end);
+        }
+    }
+}
+
+void SurfaceItemModelHandler::handleRowsRemoved(const QModelIndex &parent, int start, int end)
+{
+    // Do nothing if full reset already pending
+    if (!m_fullReset) {
+        bool handled = m_proxy->useModelCategories() ? removeModelRows(start, end)
+                                                     : removeCategoryItems(start, end);
+        if (!handled) {
+            m_categoryMapping.clear();
+            AbstractItemModelHandler::handleRowsRemoved(parent, start, end);
+        }
+    }
+}
+
+bool SurfaceItemModelHandler::isResolvedArrayInUse() const
+{
+    return m_proxyArray && m_proxyArray == m_proxy->array();
+}
+
+// Coordinates without a role are taken from defaultPos
+void SurfaceItemModelHandler::resolveItem(const QModelIndex &index, const QVector3D &defaultPos,
+                                          QSurfaceDataItem &item) const
+{
+    QVariant xValueVar = index.data(m_xPosRole);
+    QVariant yValueVar = index.data(m_yPosRole);
+    QVariant zValueVar = index.data(m_zPosRole);
+    float xPos;
+    float yPos;
+    float zPos;
+    if (m_xPosRole != noRoleIndex) {
+        if (m_haveXPosPattern)
+            xPos = xValueVar.toString().replace(m_xPosPattern, m_xPosReplace).toFloat();
+        else
+            xPos = xValueVar.toFloat();
+    } else {
+        xPos = defaultPos.x();
+    }
+
+    if (m_haveYPosPattern)
+        yPos = yValueVar.toString().replace(m_yPosPattern, m_yPosReplace).toFloat();
+    else
+        yPos = yValueVar.toFloat();
+
+    if (m_zPosRole != noRoleIndex) {
+        if (m_haveZPosPattern)
+            zPos = zValueVar.toString().replace(m_zPosPattern, m_zPosReplace).toFloat();
+        else
+            zPos = zValueVar.toFloat();
+    } else {
+        zPos = defaultPos.z();
+    }
+    item.setPosition(QVector3D(xPos, yPos, zPos));
+}
+
+float SurfaceItemModelHandler::headerPosition(Qt::Orientation orientation, int section) const
+{
+    bool ok = false;
+    float headerValue = m_itemModel->headerData(section, orientation).toString().toFloat(&ok);
+    return ok ? headerValue : float(section);
+}
+
+void SurfaceItemModelHandler::updateModelRows(int startRow, int endRow, int startColumn,
+                                              int endColumn)
+{
+    int columnCount = m_proxy->columnCount();
+    if (startColumn == 0 && endColumn == columnCount - 1 && canUpdateProxy()
+            && endRow < m_proxyArray->size()) {
+        // Whole rows changed, so replace them with a single notification
+        QSurfaceDataArray rows;
+        rows.reserve(endRow - startRow + 1);
+        for (int i = startRow; i <= endRow; i++) {
+            const QSurfaceDataRow &oldRow = *m_proxyArray->at(i);
+            QSurfaceDataRow *row = new QSurfaceDataRow(columnCount);
+            for (int j = 0; j < columnCount; j++)
+                resolveItem(m_itemModel->index(i, j), oldRow.at(j).position(), (*row)[j]);
+            rows.append(row);
+        }
+        m_proxy->setRows(startRow, rows);
+    } else {
+        for (int i = startRow; i <= endRow; i++) {
+            for (int j = startColumn; j <= endColumn; j++) {
+                QSurfaceDataItem item;
+                resolveItem(m_itemModel->index(i, j), m_proxy->itemAt(i, j)->position(), item);
+                m_proxy->setItem(i, j, item);
             }
         }
     }
 }
 
-// Resolve entire item model into QSurfaceDataArray.
-void SurfaceItemModelHandler::resolveModel()
+// Model rows map directly to proxy rows, so inserted rows can be inserted as such, unless row
+// positions come from the headers of the rows following them.
+bool SurfaceItemModelHandler::insertModelRows(int start, int end)
+{
+    int count = end - start + 1;
+    int columnCount = m_proxy->columnCount();
+    if (!canUpdateProxy() || columnCount != m_itemModel->columnCount()
+            || m_proxyArray->size() != m_itemModel->rowCount() - count
+            || (m_zPosRole == noRoleIndex && start != m_proxyArray->size())) {
+        return false;
+    }
+
+    QVector<float> headerXPos;
+    if (m_xPosRole == noRoleIndex) {
+        headerXPos.resize(columnCount);
+        for (int j = 0; j < columnCount; j++)
+            headerXPos[j] = headerPosition(Qt::Horizontal, j);
+    }
+
+    QSurfaceDataArray rows;
+    rows.reserve(count);
+    for (int i = start; i <= end; i++) {
+        float zPos = (m_zPosRole == noRoleIndex) ? headerPosition(Qt::Vertical, i) : 0.0f;
+        QSurfaceDataRow *row = new QSurfaceDataRow(columnCount);
+        for (int j = 0; j < columnCount; j++) {
+            float xPos = (m_xPosRole == noRoleIndex) ? headerXPos.at(j) : 0.0f;
+            resolveItem(m_itemModel->index(i, j), QVector3D(xPos, 0.0f, zPos), (*row)[j]);
+        }
+        rows.append(row);
+    }
+    m_proxy->insertRows(start, rows);
+
+    return true;
+}
+
+bool SurfaceItemModelHandler::removeModelRows(int start, int end)
+{
+    int count = end - start + 1;
+    if (!canUpdateProxy() || m_proxyArray->size() != m_itemModel->rowCount() + count
+            || (m_zPosRole == noRoleIndex && end != m_proxyArray->size() - 1)) {
+        return false;
+    }
+
+    m_proxy->removeRows(start, count);
+
+    return true;
+}
+
+void SurfaceItemModelHandler::updateProxyItem(int row, int column, const QVector<int> &sources)
+{
+    QItemModelSurfaceDataProxy::MultiMatchBehavior behavior = m_proxy->multiMatchBehavior();
+    bool cumulative = behavior == QItemModelSurfaceDataProxy::MMBAverage
+            || behavior == QItemModelSurfaceDataProxy::MMBCumulativeY;
+    bool average = behavior == QItemModelSurfaceDataProxy::MMBAverage;
+    bool takeFirst = behavior == QItemModelSurfaceDataProxy::MMBFirst;
+
+    QVector3D itemPos;
+    if (!sources.isEmpty()) {
+        int first = cumulative ? 0 : (takeFirst ? 0 : sources.size() - 1);
+        int last = cumulative ? sources.size() - 1 : first;
+        for (int i = first; i <= last; i++) {
+            QSurfaceDataItem item;
+            resolveItem(sourceIndex(sources.at(i)), QVector3D(), item);
+            itemPos += item.position();
+        }
+    }
+    if (cumulative) {
+        float divisor = float(sources.size());
+        if (average) {
+            itemPos /= divisor;
+        } else { // cumulativeY
+            itemPos.setX(itemPos.x() / divisor);
+            itemPos.setZ(itemPos.z() / divisor);
+        }
+    }
+
+    m_proxy->setItem(row, column, QSurfaceDataItem(itemPos));
+}
+
+// Take a snapshot of the entire item model for resolving it into QSurfaceDataArray.
+ItemModelResolveTask *SurfaceItemModelHandler::createResolveTask()
 {
     if (m_itemModel.isNull()) {
         m_proxy->resetArray(0);
         m_proxyArray = 0;
-        return;
+        return 0;
     }
 
     if (!m_proxy->useModelCategories()
             && (m_proxy->rowRole().isEmpty() || m_proxy->columnRole().isEmpty())) {
         m_proxy->resetArray(0);
         m_proxyArray = 0;
-        return;
+        return 0;
     }
 
-    // Position patterns can be reused on single item changes, so store them to member variables.
-    QRegExp rowPattern(m_proxy->rowRolePattern());
-    QRegExp colPattern(m_proxy->columnRolePattern());
+    SurfaceItemModelResolveTask *task = new SurfaceItemModelResolveTask;
+
+    // Patterns can be reused on single item changes, so store them to member variables.
+    m_rowPattern = m_proxy->rowRolePattern();
+    m_columnPattern = m_proxy->columnRolePattern();
     m_xPosPattern = m_proxy->xPosRolePattern();
     m_yPosPattern = m_proxy->yPosRolePattern();
     m_zPosPattern = m_proxy->zPosRolePattern();
-    QString rowReplace = m_proxy->rowRoleReplace();
-    QString colReplace = m_proxy->columnRoleReplace();
+    m_rowReplace = m_proxy->rowRoleReplace();
+    m_columnReplace = m_proxy->columnRoleReplace();
     m_xPosReplace = m_proxy->xPosRoleReplace();
     m_yPosReplace = m_proxy->yPosRoleReplace();
     m_zPosReplace = m_proxy->zPosRoleReplace();
-    bool haveRowPattern = !rowPattern.isEmpty() && rowPattern.isValid();
-    bool haveColPattern = !colPattern.isEmpty() && colPattern.isValid();
+    m_haveRowPattern = !m_rowPattern.isEmpty() && m_rowPattern.isValid();
+    m_haveColumnPattern = !m_columnPattern.isEmpty() && m_columnPattern.isValid();
     m_haveXPosPattern = !m_xPosPattern.isEmpty() && m_xPosPattern.isValid();
     m_haveYPosPattern = !m_yPosPattern.isEmpty() && m_yPosPattern.isValid();
     m_haveZPosPattern = !m_zPosPattern.isEmpty() && m_zPosPattern.isValid();
+    task->m_rowPattern = m_rowPattern;
+    task->m_colPattern = m_columnPattern;
+    task->m_rowReplace = m_rowReplace;
+    task->m_colReplace = m_columnReplace;
+    task->m_haveRowPattern = m_haveRowPattern;
+    task->m_haveColPattern = m_haveColumnPattern;
+    task->m_xPosPattern = m_xPosPattern;
+    task->m_yPosPattern = m_yPosPattern;
+    task->m_zPosPattern = m_zPosPattern;
+    task->m_xPosReplace = m_xPosReplace;
+    task->m_yPosReplace = m_yPosReplace;
+    task->m_zPosReplace = m_zPosReplace;
+    task->m_haveXPosPattern = m_haveXPosPattern;
+    task->m_haveYPosPattern = m_haveYPosPattern;
+    task->m_haveZPosPattern = m_haveZPosPattern;
 
     QHash<int, QByteArray> roleHash = m_itemModel->roleNames();
 
@@ -145,190 +306,309 @@ void SurfaceItemModelHandler::resolveModel()
     m_xPosRole = roleHash.key(m_proxy->xPosRole().toLatin1(), noRoleIndex);
     m_yPosRole = roleHash.key(m_proxy->yPosRole().toLatin1(), Qt::DisplayRole);
     m_zPosRole = roleHash.key(m_proxy->zPosRole().toLatin1(), noRoleIndex);
-    int rowCount = m_itemModel->rowCount();
-    int columnCount = m_itemModel->columnCount();
-
-    if (m_proxy->useModelCategories()) {
-        // If dimensions have changed, recreate the array
-        if (m_proxyArray != m_proxy->array() || columnCount != m_proxy->columnCount()
-                || rowCount != m_proxyArray->size()) {
-            m_proxyArray = new QSurfaceDataArray;
-            m_proxyArray->reserve(rowCount);
-            for (int i = 0; i < rowCount; i++)
-                m_proxyArray->append(new QSurfaceDataRow(columnCount));
-        }
-        for (int i = 0; i < rowCount; i++) {
-            QSurfaceDataRow &newProxyRow = *m_proxyArray->at(i);
-            for (int j = 0; j < columnCount; j++) {
-                QModelIndex index = m_itemModel->index(i, j);
-                QVariant xValueVar = index.data(m_xPosRole);
-                QVariant yValueVar = index.data(m_yPosRole);
-                QVariant zValueVar = index.data(m_zPosRole);
-                float xPos;
-                float yPos;
-                float zPos;
-                if (m_xPosRole != noRoleIndex) {
-                    if (m_haveXPosPattern)
-                        xPos = xValueVar.toString().replace(m_xPosPattern, m_xPosReplace).toFloat();
-                    else
-                        xPos = xValueVar.toFloat();
-                } else {
-                    QString header = m_itemModel->headerData(j, Qt::Horizontal).toString();
-                    bool ok = false;
-                    float headerValue = header.toFloat(&ok);
-                    if (ok)
-                        xPos = headerValue;
-                    else
-                        xPos = float(j);
-                }
 
-                if (m_haveYPosPattern)
-                    yPos = yValueVar.toString().replace(m_yPosPattern, m_yPosReplace).toFloat();
-                else
-                    yPos = yValueVar.toFloat();
-
-                if (m_zPosRole != noRoleIndex) {
-                    if (m_haveZPosPattern)
-                        zPos = zValueVar.toString().replace(m_zPosPattern, m_zPosReplace).toFloat();
-                    else
-                        zPos = zValueVar.toFloat();
-                } else {
-                    QString header = m_itemModel->headerData(i, Qt::Vertical).toString();
-                    bool ok = false;
-                    float headerValue = header.toFloat(&ok);
-                    if (ok)
-                        zPos = headerValue;
-                    else
-                        zPos = float(i);
-                }
-
-                newProxyRow[j].setPosition(QVector3D(xPos, yPos, zPos));
-            }
+    QVector<int> roles;
+    task->m_useModelCategories = m_proxy->useModelCategories();
+    if (task->m_useModelCategories) {
+        // Positions missing a role come from the headers
+        if (m_xPosRole != noRoleIndex) {
+            task->m_xPosRoleIndex = roles.size();
+            roles.append(m_xPosRole);
+        } else {
+            int columnCount = m_itemModel->columnCount();
+            for (int j = 0; j < columnCount; j++)
+                task->m_horizontalHeaders << m_itemModel->headerData(j, Qt::Horizontal).toString();
+        }
+        task->m_yPosRoleIndex = roles.size();
+        roles.append(m_yPosRole);
+        if (m_zPosRole != noRoleIndex) {
+            task->m_zPosRoleIndex = roles.size();
+            roles.append(m_zPosRole);
+        } else {
+            int rowCount = m_itemModel->rowCount();
+            for (int i = 0; i < rowCount; i++)
+                task->m_verticalHeaders << m_itemModel->headerData(i, Qt::Vertical).toString();
         }
     } else {
-        int rowRole = roleHash.key(m_proxy->rowRole().toLatin1());
-        int columnRole = roleHash.key(m_proxy->columnRole().toLatin1());
+        m_rowRole = roleHash.key(m_proxy->rowRole().toLatin1());
+        m_columnRole = roleHash.key(m_proxy->columnRole().toLatin1());
         if (m_xPosRole == noRoleIndex)
-            m_xPosRole = columnRole;
+            m_xPosRole = m_columnRole;
         if (m_zPosRole == noRoleIndex)
-            m_zPosRole = rowRole;
-
-        bool generateRows = m_proxy->autoRowCategories();
-        bool generateColumns = m_proxy->autoColumnCategories();
-
-        QStringList rowList;
-        QStringList columnList;
-        // For detecting duplicates in categories generation, using QHashes should be faster than
-        // simple QStringList::contains() check.
-        QHash<QString, bool> rowListHash;
-        QHash<QString, bool> columnListHash;
-
-        bool cumulative = m_proxy->multiMatchBehavior() == QItemModelSurfaceDataProxy::MMBAverage
-                || m_proxy->multiMatchBehavior() == QItemModelSurfaceDataProxy::MMBCumulativeY;
-        bool average = m_proxy->multiMatchBehavior() == QItemModelSurfaceDataProxy::MMBAverage;
-        bool takeFirst = m_proxy->multiMatchBehavior() == QItemModelSurfaceDataProxy::MMBFirst;
-        QHash<QString, QHash<QString, int> > *matchCountMap = 0;
-        if (cumulative)
-            matchCountMap = new QHash<QString, QHash<QString, int> >;
-
-        // Sort values into rows and columns
-        typedef QHash<QString, QVector3D> ColumnValueMap;
-        QHash <QString, ColumnValueMap> itemValueMap;
-        for (int i = 0; i < rowCount; i++) {
-            for (int j = 0; j < columnCount; j++) {
-                QModelIndex index = m_itemModel->index(i, j);
-                QString rowRoleStr = index.data(rowRole).toString();
-                if (haveRowPattern)
-                    rowRoleStr.replace(rowPattern, rowReplace);
-                QString columnRoleStr = index.data(columnRole).toString();
-                if (haveColPattern)
-                    columnRoleStr.replace(colPattern, colReplace);
-                QVariant xValueVar = index.data(m_xPosRole);
-                QVariant yValueVar = index.data(m_yPosRole);
-                QVariant zValueVar = index.data(m_zPosRole);
-                float xPos;
-                float yPos;
-                float zPos;
-                if (m_haveXPosPattern)
-                    xPos = xValueVar.toString().replace(m_xPosPattern, m_xPosReplace).toFloat();
-                else
-                    xPos = xValueVar.toFloat();
-                if (m_haveYPosPattern)
-                    yPos = yValueVar.toString().replace(m_yPosPattern, m_yPosReplace).toFloat();
-                else
-                    yPos = yValueVar.toFloat();
-                if (m_haveZPosPattern)
-                    zPos = zValueVar.toString().replace(m_zPosPattern, m_zPosReplace).toFloat();
-                else
-                    zPos = zValueVar.toFloat();
-
-                QVector3D itemPos(xPos, yPos, zPos);
-
-                if (cumulative)
-                    (*matchCountMap)[rowRoleStr][columnRoleStr]++;
-
-                if (cumulative) {
-                    itemValueMap[rowRoleStr][columnRoleStr] += itemPos;
-                } else {
-                    if (takeFirst && itemValueMap.contains(rowRoleStr)) {
-                        if (itemValueMap.value(rowRoleStr).contains(columnRoleStr))
-                            continue; // We already have a value for this row/column combo
-                    }
-                    itemValueMap[rowRoleStr][columnRoleStr] = itemPos;
-                }
+            m_zPosRole = m_rowRole;
+
+        task->m_rowRoleIndex = 0;
+        task->m_columnRoleIndex = 1;
+        task->m_xPosRoleIndex = 2;
+        task->m_yPosRoleIndex = 3;
+        task->m_zPosRoleIndex = 4;
+        roles << m_rowRole << m_columnRole << m_xPosRole << m_yPosRole << m_zPosRole;
+
+        task->m_generateRows = m_proxy->autoRowCategories();
+        task->m_generateColumns = m_proxy->autoColumnCategories();
+        if (!task->m_generateRows)
+            task->m_rowCategories = m_proxy->rowCategories();
+        if (!task->m_generateColumns)
+            task->m_columnCategories = m_proxy->columnCategories();
+        task->m_multiMatchBehavior = m_proxy->multiMatchBehavior();
+    }
 
-                if (generateRows && !rowListHash.value(rowRoleStr, false)) {
-                    rowListHash.insert(rowRoleStr, true);
-                    rowList << rowRoleStr;
-                }
-                if (generateColumns && !columnListHash.value(columnRoleStr, false)) {
-                    columnListHash.insert(columnRoleStr, true);
-                    columnList << columnRoleStr;
-                }
-            }
+    // Existing array can only be written to directly when resolving right away
+    if (!m_asynchronous && isResolvedArrayInUse())
+        task->m_reuseArray = m_proxyArray;
+
+    task->takeSnapshot(m_itemModel.data(), roles);
+
+    return task;
+}
+
+void SurfaceItemModelHandler::applyResolveTask(ItemModelResolveTask *task)
+{
+    SurfaceItemModelResolveTask *surfaceTask = static_cast<SurfaceItemModelResolveTask *>(task);
+
+    if (!surfaceTask->m_useModelCategories) {
+        if (surfaceTask->m_generateRows)
+            m_proxy->dptr()->m_rowCategories = surfaceTask->m_rowCategories;
+        if (surfaceTask->m_generateColumns)
+            m_proxy->dptr()->m_columnCategories = surfaceTask->m_columnCategories;
+    }
+
+    m_categoryMapping = surfaceTask->m_mapping;
+    m_proxyArray = surfaceTask->takeArray();
+    m_proxy->resetArray(m_proxyArray);
+}
+
+//  SurfaceItemModelResolveTask
+
+SurfaceItemModelResolveTask::SurfaceItemModelResolveTask()
+    : m_useModelCategories(false),
+      m_rowRoleIndex(noRoleIndex),
+      m_columnRoleIndex(noRoleIndex),
+      m_xPosRoleIndex(noRoleIndex),
+      m_yPosRoleIndex(noRoleIndex),
+      m_zPosRoleIndex(noRoleIndex),
+      m_haveRowPattern(false),
+      m_haveColPattern(false),
+      m_haveXPosPattern(false),
+      m_haveYPosPattern(false),
+      m_haveZPosPattern(false),
+      m_generateRows(false),
+      m_generateColumns(false),
+      m_multiMatchBehavior(QItemModelSurfaceDataProxy::MMBLast),
+      m_reuseArray(0),
+      m_array(0)
+{
+}
+
+SurfaceItemModelResolveTask::~SurfaceItemModelResolveTask()
+{
+    if (m_array && m_array != m_reuseArray) {
+        qDeleteAll(*m_array);
+        delete m_array;
+    }
+}
+
+void SurfaceItemModelResolveTask::resolve()
+{
+    if (m_useModelCategories)
+        resolveModelCategories();
+    else
+        resolveRoleCategories();
+}
+
+QSurfaceDataArray *SurfaceItemModelResolveTask::takeArray()
+{
+    QSurfaceDataArray *array = m_array;
+    m_array = 0;
+    return array;
+}
+
+// If dimensions have changed, recreate the array
+QSurfaceDataArray *SurfaceItemModelResolveTask::arrayForSize(int rowCount, int columnCount)
+{
+    if (m_reuseArray && m_reuseArray->size() == rowCount
+            && (!rowCount || m_reuseArray->at(0)->size() == columnCount)) {
+        return m_reuseArray;
+    }
+
+    QSurfaceDataArray *array = new QSurfaceDataArray;
+    array->reserve(rowCount);
+    for (int i = 0; i < rowCount; i++)
+        array->append(new QSurfaceDataRow(columnCount));
+    return array;
+}
+
+float SurfaceItemModelResolveTask::toFloat(const QVariant &variant, bool havePattern,
+                                           const QRegExp &pattern, const QString &replace)
+{
+    if (havePattern)
+        return variant.toString().replace(pattern, replace).toFloat();
+    else
+        return variant.toFloat();
+}
+
+void SurfaceItemModelResolveTask::resolveModelCategories()
+{
+    m_array = arrayForSize(m_rowCount, m_columnCount);
+
+    // Header based positions are the same for all rows or columns
+    QVector<float> headerXPos;
+    QVector<float> headerZPos;
+    if (m_xPosRoleIndex == noRoleIndex) {
+        headerXPos.resize(m_columnCount);
+        for (int j = 0; j < m_columnCount; j++) {
+            bool ok = false;
+            float headerValue = m_horizontalHeaders.at(j).toFloat(&ok);
+            headerXPos[j] = ok ? headerValue : float(j);
         }
+    }
+    if (m_zPosRoleIndex == noRoleIndex) {
+        headerZPos.resize(m_rowCount);
+        for (int i = 0; i < m_rowCount; i++) {
+            bool ok = false;
+            float headerValue = m_verticalHeaders.at(i).toFloat(&ok);
+            headerZPos[i] = ok ? headerValue : float(i);
+        }
+    }
 
-        if (generateRows)
-            m_proxy->dptr()->m_rowCategories = rowList;
-        else
-            rowList = m_proxy->rowCategories();
+    for (int i = 0; i < m_rowCount; i++) {
+        if (isCancelled())
+            return;
+        QSurfaceDataRow &newProxyRow = *m_array->at(i);
+        for (int j = 0; j < m_columnCount; j++) {
+            float xPos;
+            float yPos;
+            float zPos;
+            if (m_xPosRoleIndex != noRoleIndex) {
+                xPos = toFloat(value(i, j, m_xPosRoleIndex), m_haveXPosPattern, m_xPosPattern,
+                               m_xPosReplace);
+            } else {
+                xPos = headerXPos.at(j);
+            }
+            yPos = toFloat(value(i, j, m_yPosRoleIndex), m_haveYPosPattern, m_yPosPattern,
+                           m_yPosReplace);
+            if (m_zPosRoleIndex != noRoleIndex) {
+                zPos = toFloat(value(i, j, m_zPosRoleIndex), m_haveZPosPattern, m_zPosPattern,
+                               m_zPosReplace);
+            } else {
+                zPos = headerZPos.at(i);
+            }
 
-        if (generateColumns)
-            m_proxy->dptr()->m_columnCategories = columnList;
-        else
-            columnList = m_proxy->columnCategories();
-
-        // If dimensions have changed, recreate the array
-        if (m_proxyArray != m_proxy->array() || columnList.size() != m_proxy->columnCount()
-                || rowList.size() != m_proxyArray->size()) {
-            m_proxyArray = new QSurfaceDataArray;
-            m_proxyArray->reserve(rowList.size());
-            for (int i = 0; i < rowList.size(); i++)
-                m_proxyArray->append(new QSurfaceDataRow(columnList.size()));
+            newProxyRow[j].setPosition(QVector3D(xPos, yPos, zPos));
         }
-        // Create data array from itemValueMap
-        for (int i = 0; i < rowList.size(); i++) {
-            QString rowKey = rowList.at(i);
-            QSurfaceDataRow &newProxyRow = *m_proxyArray->at(i);
-            for (int j = 0; j < columnList.size(); j++) {
-                QVector3D &itemPos = itemValueMap[rowKey][columnList.at(j)];
-                if (cumulative) {
-                    if (average) {
-                        itemPos /= float((*matchCountMap)[rowKey][columnList.at(j)]);
-                    } else { // cumulativeY
-                        float divisor = float((*matchCountMap)[rowKey][columnList.at(j)]);
-                        itemPos.setX(itemPos.x() / divisor);
-                        itemPos.setZ(itemPos.z() / divisor);
-                    }
+    }
+}
+
+void SurfaceItemModelResolveTask::resolveRoleCategories()
+{
+    QStringList rowList;
+    QStringList columnList;
+    // For detecting duplicates in categories generation, using QHashes should be faster than
+    // simple QStringList::contains() check.
+    QHash<QString, bool> rowListHash;
+    QHash<QString, bool> columnListHash;
+
+    bool cumulative = m_multiMatchBehavior == QItemModelSurfaceDataProxy::MMBAverage
+            || m_multiMatchBehavior == QItemModelSurfaceDataProxy::MMBCumulativeY;
+    bool average = m_multiMatchBehavior == QItemModelSurfaceDataProxy::MMBAverage;
+    bool takeFirst = m_multiMatchBehavior == QItemModelSurfaceDataProxy::MMBFirst;
+    QHash<QString, QHash<QString, int> > *matchCountMap = 0;
+    if (cumulative)
+        matchCountMap = new QHash<QString, QHash<QString, int> >;
+
+    // Categories of each model item, for mapping model items to proxy items
+    QStringList itemRowCategories;
+    QStringList itemColumnCategories;
+    itemRowCategories.reserve(m_rowCount * m_columnCount);
+    itemColumnCategories.reserve(m_rowCount * m_columnCount);
+
+    // Sort values into rows and columns
+    typedef QHash<QString, QVector3D> ColumnValueMap;
+    QHash <QString, ColumnValueMap> itemValueMap;
+    for (int i = 0; i < m_rowCount; i++) {
+        if (isCancelled()) {
+            delete matchCountMap;
+            return;
+        }
+        for (int j = 0; j < m_columnCount; j++) {
+            QString rowRoleStr = value(i, j, m_rowRoleIndex).toString();
+            if (m_haveRowPattern)
+                rowRoleStr.replace(m_rowPattern, m_rowReplace);
+            QString columnRoleStr = value(i, j, m_columnRoleIndex).toString();
+            if (m_haveColPattern)
+                columnRoleStr.replace(m_colPattern, m_colReplace);
+            itemRowCategories << rowRoleStr;
+            itemColumnCategories << columnRoleStr;
+            float xPos = toFloat(value(i, j, m_xPosRoleIndex), m_haveXPosPattern, m_xPosPattern,
+                                 m_xPosReplace);
+            float yPos = toFloat(value(i, j, m_yPosRoleIndex), m_haveYPosPattern, m_yPosPattern,
+                                 m_yPosReplace);
+            float zPos = toFloat(value(i, j, m_zPosRoleIndex), m_haveZPosPattern, m_zPosPattern,
+                                 m_zPosReplace);
+
+            QVector3D itemPos(xPos, yPos, zPos);
+
+            if (cumulative)
+                (*matchCountMap)[rowRoleStr][columnRoleStr]++;
+
+            if (cumulative) {
+                itemValueMap[rowRoleStr][columnRoleStr] += itemPos;
+            } else {
+                if (takeFirst && itemValueMap.contains(rowRoleStr)) {
+                    if (itemValueMap.value(rowRoleStr).contains(columnRoleStr))
+                        continue; // We already have a value for this row/column combo
                 }
-                newProxyRow[j].setPosition(itemPos);
+                itemValueMap[rowRoleStr][columnRoleStr] = itemPos;
+            }
+
+            if (m_generateRows && !rowListHash.value(rowRoleStr, false)) {
+                rowListHash.insert(rowRoleStr, true);
+                rowList << rowRoleStr;
+            }
+            if (m_generateColumns && !columnListHash.value(columnRoleStr, false)) {
+                columnListHash.insert(columnRoleStr, true);
+                columnList << columnRoleStr;
             }
         }
+    }
 
-        delete matchCountMap;
+    if (m_generateRows)
+        m_rowCategories = rowList;
+    else
+        rowList = m_rowCategories;
+
+    if (m_generateColumns)
+        m_columnCategories = columnList;
+    else
+        columnList = m_columnCategories;
+
+    m_array = arrayForSize(rowList.size(), columnList.size());
+
+    // Create data array from itemValueMap
+    for (int i = 0; i < rowList.size(); i++) {
+        QString rowKey = rowList.at(i);
+        QSurfaceDataRow &newProxyRow = *m_array->at(i);
+        for (int j = 0; j < columnList.size(); j++) {
+            QVector3D &itemPos = itemValueMap[rowKey][columnList.at(j)];
+            if (cumulative) {
+                if (average) {
+                    itemPos /= float((*matchCountMap)[rowKey][columnList.at(j)]);
+                } else { // cumulativeY
+                    float divisor = float((*matchCountMap)[rowKey][columnList.at(j)]);
+                    itemPos.setX(itemPos.x() / divisor);
+                    itemPos.setZ(itemPos.z() / divisor);
+                }
+            }
+            newProxyRow[j].setPosition(itemPos);
+        }
     }
 
-    m_proxy->resetArray(m_proxyArray);
+    delete matchCountMap;
+
+    m_mapping.reset(rowList, columnList, m_columnCount, m_generateRows, m_generateColumns);
+    for (int i = 0; i < itemRowCategories.size(); i++)
+        m_mapping.appendModelItem(m_mapping.proxyItem(itemRowCategories.at(i),
+                                                      itemColumnCategories.at(i)));
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -45,6 +45,62 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class SurfaceItemModelResolveTask : public ItemModelResolveTask
+{
+public:
+    SurfaceItemModelResolveTask();
+    virtual ~SurfaceItemModelResolveTask();
+
+    virtual void resolve();
+    QSurfaceDataArray *takeArray();
+
+private:
+    void resolveModelCategories();
+    void resolveRoleCategories();
+    QSurfaceDataArray *arrayForSize(int rowCount, int columnCount);
+    static float toFloat(const QVariant &variant, bool havePattern, const QRegExp &pattern,
+                         const QString &replace);
+
+    bool m_useModelCategories;
+    // Snapshot role indexes, -1 if the role is not in the snapshot
+    int m_rowRoleIndex;
+    int m_columnRoleIndex;
+    int m_xPosRoleIndex;
+    int m_yPosRoleIndex;
+    int m_zPosRoleIndex;
+    QStringList m_horizontalHeaders;
+    QStringList m_verticalHeaders;
+
+    QRegExp m_rowPattern;
+    QRegExp m_colPattern;
+    QRegExp m_xPosPattern;
+    QRegExp m_yPosPattern;
+    QRegExp m_zPosPattern;
+    QString m_rowReplace;
+    QString m_colReplace;
+    QString m_xPosReplace;
+    QString m_yPosReplace;
+    QString m_zPosReplace;
+    bool m_haveRowPattern;
+    bool m_haveColPattern;
+    bool m_haveXPosPattern;
+    bool m_haveYPosPattern;
+    bool m_haveZPosPattern;
+
+    bool m_generateRows;
+    bool m_generateColumns;
+    QItemModelSurfaceDataProxy::MultiMatchBehavior m_multiMatchBehavior;
+
+    // Array that can be written to directly if the dimensions do not change. Not owned.
+    QSurfaceDataArray *m_reuseArray;
+    QSurfaceDataArray *m_array;
+    QStringList m_rowCategories;
+    QStringList m_columnCategories;
+    ItemModelCategoryMapping m_mapping;
+
+    friend class SurfaceItemModelHandler;
+};
+
 class SurfaceItemModelHandler : public AbstractItemModelHandler
 {
     Q_OBJECT
@@ -55,9 +111,20 @@ public:
 public Q_SLOTS:
     virtual void handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
                                    const QVector<int> &roles = QVector<int> ());
+    virtual void handleRowsInserted(const QModelIndex &parent, int start, int end);
+    virtual void handleRowsRemoved(const QModelIndex &parent, int start, int end);
 
 protected:
-    void virtual resolveModel();
+    virtual ItemModelResolveTask *createResolveTask();
+    virtual void applyResolveTask(ItemModelResolveTask *task);
+    virtual bool isResolvedArrayInUse() const;
+    virtual void updateProxyItem(int row, int column, const QVector<int> &sources);
+    void resolveItem(const QModelIndex &index, const QVector3D &defaultPos,
+                     QSurfaceDataItem &item) const;
+    float headerPosition(Qt::Orientation orientation, int section) const;
+    void updateModelRows(int startRow, int endRow, int startColumn, int endColumn);
+    bool insertModelRows(int start, int end);
+    bool removeModelRows(int start, int end);
 
     QItemModelSurfaceDataProxy *m_proxy; // Not owned
     QSurfaceDataArray *m_proxyArray; // Not owned
@@ -75,7 +75,8 @@ Abstract3DController::Abstract3DController(QRect initialViewport, Q3DScene *scen
     m_clickedType(QAbstract3DGraph::ElementNone),
     m_selectedLabelIndex(-1),
     m_selectedCustomItemIndex(-1),
-    m_margin(-1.0)
+    m_margin(-1.0),
+    m_progressiveFrameBudget(0)
 {
     if (!m_scene)
         m_scene = new Q3DScene;
@@ -506,6 +507,11 @@ void Abstract3DController::synchDataToRenderer()
         m_changeTracker.marginChanged = false;
     }
 
+    if (m_changeTracker.progressiveFrameBudgetChanged) {
+        m_renderer->updateProgressiveFrameBudget(m_progressiveFrameBudget);
+        m_changeTracker.progressiveFrameBudgetChanged = false;
+    }
+
     if (m_changedSeriesList.size()) {
         m_renderer->modifiedSeriesList(m_changedSeriesList);
         m_changedSeriesList.clear();
@@ -557,6 +563,10 @@ void Abstract3DController::render(const GLuint defaultFboHandle)
     }
 
     m_renderer->render(defaultFboHandle);
+
+    // Keep rendering until the whole scene has been drawn after the camera settles
+    if (m_renderer->finishProgressiveFrame())
+        emitNeedRender();
 }
 
 void Abstract3DController::mouseDoubleClickEvent(QMouseEvent *event)
@@ -1743,5 +1753,22 @@ qreal Abstract3DController::margin() const
     return m_margin;
 }
 
+void Abstract3DController::setProgressiveFrameBudget(int budget)
+{
+    if (budget < 0) {
+        qWarning("Invalid budget. progressiveFrameBudget cannot be negative");
+    } else if (m_progressiveFrameBudget != budget) {
+        m_progressiveFrameBudget = budget;
+        m_changeTracker.progressiveFrameBudgetChanged = true;
+        emit progressiveFrameBudgetChanged(budget);
+        emitNeedRender();
+    }
+}
+
+int Abstract3DController::progressiveFrameBudget() const
+{
+    return m_progressiveFrameBudget;
+}
+
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -32,6 +32,7 @@
 #include "q3dcamera_p.h"
 #include "q3dtheme_p.h"
 #include "qvalue3daxisformatter_p.h"
+#include "qlogvalue3daxisformatter.h"
 #include "shaderhelper_p.h"
 #include "qcustom3ditem_p.h"
 #include "qcustom3dlabel_p.h"
@@ -52,6 +53,8 @@ const int polarGridRoundness(64);
 const qreal polarGridAngle(doublePi / qreal(polarGridRoundness));
 const float polarGridAngleDegrees(float(360.0 / qreal(polarGridRoundness)));
 const qreal polarGridHalfAngle(polarGridAngle / 2.0);
+// Time in milliseconds the camera needs to stay still before the view is considered settled
+const qint64 cameraSettleTime(100);
 
 Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
     : QObject(0),
@@ -118,6 +121,9 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_oldCameraTarget(QVector3D(2000.0f, 2000.0f, 2000.0f)), // Just random invalid target
       m_reflectionEnabled(false),
       m_reflectivity(0.5),
+      m_progressiveFrameBudget(0),
+      m_progressiveStride(1),
+      m_fullFrameTime(0.0f),
 #if !defined(QT_OPENGL_ES_2)
       m_funcs_2_1(0),
 #endif
@@ -237,6 +243,15 @@ void Abstract3DRenderer::initializeOpenGL()
 
 void Abstract3DRenderer::render(const GLuint defaultFboHandle)
 {
+    // While the camera is moving, draw only every Nth item if full frames take over the budget
+    m_progressiveFrameTimer.start();
+    m_progressiveStride = 1;
+    if (m_progressiveFrameBudget > 0 && m_cameraMoveTimer.isValid()
+            && m_cameraMoveTimer.elapsed() < cameraSettleTime
+            && m_fullFrameTime > float(m_progressiveFrameBudget)) {
+        m_progressiveStride = qCeil(m_fullFrameTime / float(m_progressiveFrameBudget));
+    }
+
     if (defaultFboHandle) {
         glDepthMask(true);
         glEnable(GL_DEPTH_TEST);
@@ -383,6 +398,9 @@ void Abstract3DRenderer::updateScene(Q3DScene *scene)
     m_graphPositionQuery = QPoint(logicalGraphPosition.x() * m_devicePixelRatio,
                                   logicalGraphPosition.y() * m_devicePixelRatio);
 
+    if (m_progressiveFrameBudget > 0 && scene->activeCamera()->isDirty())
+        m_cameraMoveTimer.start();
+
     // Synchronize the renderer scene to controller scene
     scene->d_ptr->sync(*m_cachedScene->d_ptr);
 
@@ -426,7 +444,7 @@ void Abstract3DRenderer::reInitShaders()
         if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
             if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
                     && qobject_cast<Scatter3DRenderer *>(this)) {
-                initGradientShaders(QStringLiteral(":/shaders/vertexShadow"),
+                initGradientShaders(QStringLiteral(":/shaders/vertexShadowColorOnY"),
                                     QStringLiteral(":/shaders/fragmentShadow"));
                 initStaticSelectedItemShaders(QStringLiteral(":/shaders/vertexShadow"),
                                               QStringLiteral(":/shaders/fragmentShadowNoTex"),
@@ -447,7 +465,7 @@ void Abstract3DRenderer::reInitShaders()
         } else {
             if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
                     && qobject_cast<Scatter3DRenderer *>(this)) {
-                initGradientShaders(QStringLiteral(":/shaders/vertexTexture"),
+                initGradientShaders(QStringLiteral(":/shaders/vertexTextureColorOnY"),
                                     QStringLiteral(":/shaders/fragmentTexture"));
                 initStaticSelectedItemShaders(QStringLiteral(":/shaders/vertex"),
                                               QStringLiteral(":/shaders/fragment"),
@@ -475,7 +493,7 @@ void Abstract3DRenderer::reInitShaders()
     } else  {
         if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
                 && qobject_cast<Scatter3DRenderer *>(this)) {
-            initGradientShaders(QStringLiteral(":/shaders/vertexTexture"),
+            initGradientShaders(QStringLiteral(":/shaders/vertexTextureColorOnY"),
                                 QStringLiteral(":/shaders/fragmentTextureES2"));
             initStaticSelectedItemShaders(QStringLiteral(":/shaders/vertex"),
                                           QStringLiteral(":/shaders/fragmentES2"),
@@ -549,6 +567,30 @@ void Abstract3DRenderer::updateMargin(float margin)
     m_requestedMargin = margin;
 }
 
+void Abstract3DRenderer::updateProgressiveFrameBudget(int budget)
+{
+    m_progressiveFrameBudget = budget;
+    m_cameraMoveTimer.invalidate();
+}
+
+/**
+ * @brief finishProgressiveFrame Called after a frame has been rendered.
+ * Returns true if the frame was drawn progressively, so another frame is needed to draw the
+ * whole scene once the camera settles.
+ */
+bool Abstract3DRenderer::finishProgressiveFrame()
+{
+    if (!m_progressiveFrameBudget)
+        return false;
+
+    // Only full frames are measured, so that the item stride stays stable while moving
+    if (m_progressiveStride == 1) {
+        m_fullFrameTime = float(m_progressiveFrameTimer.nsecsElapsed()) / 1000000.0f;
+        return false;
+    }
+    return true;
+}
+
 void Abstract3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHints hint)
 {
     m_cachedOptimizationHint = hint;
@@ -1844,6 +1886,21 @@ void Abstract3DRenderer::calculatePolarXZ(const QVector3D &dataPos, float &x, fl
     z = -float(radius * qCos(angle)) * m_polarRadius;
 }
 
+// Data positions can be resolved in parallel only if the axis formatters are known not to modify
+// any state when resolving positions, which is the case for the built-in formatters.
+bool Abstract3DRenderer::hasReentrantFormatters() const
+{
+    const AxisRenderCache *axisCaches[3] = { &m_axisCacheX, &m_axisCacheY, &m_axisCacheZ };
+    for (int i = 0; i < 3; i++) {
+        const QValue3DAxisFormatter *formatter = axisCaches[i]->formatter();
+        if (formatter && formatter->metaObject() != &QValue3DAxisFormatter::staticMetaObject
+                && formatter->metaObject() != &QLogValue3DAxisFormatter::staticMetaObject) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void Abstract3DRenderer::drawRadialGrid(ShaderHelper *shader, float yFloorLinePos,
                                         const QMatrix4x4 &projectionViewMatrix,
                                         const QMatrix4x4 &depthMatrix)
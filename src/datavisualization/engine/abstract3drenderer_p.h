@@ -41,6 +41,7 @@
 #define ABSTRACT3DRENDERER_P_H
 
 #include <QtGui/QOpenGLFunctions>
+#include <QtCore/QElapsedTimer>
 #if !defined(QT_OPENGL_ES_2)
 #  include <QtGui/QOpenGLFunctions_2_1>
 #endif
@@ -154,6 +155,8 @@ public:
     virtual void updatePolar(bool enable);
     virtual void updateRadialLabelOffset(float offset);
     virtual void updateMargin(float margin);
+    virtual void updateProgressiveFrameBudget(int budget);
+    bool finishProgressiveFrame();
 
     virtual QVector3D convertPositionToTranslation(const QVector3D &position,
                                                    bool isAbsolute) = 0;
@@ -183,6 +186,7 @@ public:
 
     QVector4D indexToSelectionColor(GLint index);
     void calculatePolarXZ(const QVector3D &dataPos, float &x, float &z) const;
+    bool hasReentrantFormatters() const;
 
 Q_SIGNALS:
     void needRender(); // Emit this if something in renderer causes need for another render pass.
@@ -236,6 +240,10 @@ protected:
     void updateCameraViewport();
 
     void recalculateCustomItemScalingAndPos(CustomRenderItem *item);
+    inline bool isProgressivelySkipped(int index) const
+    {
+        return m_progressiveStride > 1 && (index % m_progressiveStride);
+    }
     virtual void getVisibleItemBounds(QVector3D &minBounds, QVector3D &maxBounds) = 0;
     void drawVolumeSliceFrame(const CustomRenderItem *item, Qt::Axis axis,
                               const QMatrix4x4 &projectionViewMatrix);
@@ -333,6 +341,12 @@ protected:
     bool m_reflectionEnabled;
     qreal m_reflectivity;
 
+    int m_progressiveFrameBudget; // In milliseconds, zero disables progressive rendering
+    int m_progressiveStride; // Only every Nth item is drawn on progressive frames
+    float m_fullFrameTime; // Measured time of the last fully drawn frame in milliseconds
+    QElapsedTimer m_progressiveFrameTimer;
+    QElapsedTimer m_cameraMoveTimer; // Time since the camera last moved
+
     QLocale m_locale;
 #if !defined(QT_OPENGL_ES_2)
     QOpenGLFunctions_2_1 *m_funcs_2_1;  // Not owned
@@ -30,6 +30,7 @@
 #include "axisrendercache_p.h"
 
 #include <QtGui/QFontMetrics>
+#include <QtCore/QHash>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -105,25 +106,43 @@ void AxisRenderCache::setLabels(const QStringList &labels)
         int newSize(labels.size());
         int oldSize(m_labels.size());
 
-        for (int i = newSize; i < oldSize; i++)
-            delete m_labelItems.takeLast();
-
-        m_labelItems.reserve(newSize);
-
         int widest = maxLabelWidth(labels);
 
+        // Labels often just move to a different index, e.g. when rows are shifted out of a
+        // scrolling graph, so reuse the existing label textures where the text is the same.
+        QHash<QString, LabelItem *> movedItems;
+        QList<LabelItem *> spareItems;
+        for (int i = 0; i < oldSize; i++) {
+            LabelItem *item = m_labelItems.at(i);
+            if (m_drawer && !m_labels.at(i).isEmpty() && item->size().width() == widest)
+                movedItems.insertMulti(m_labels.at(i), item);
+            else
+                spareItems.append(item);
+        }
+
+        QList<LabelItem *> newItems;
+        newItems.reserve(newSize);
         for (int i = 0; i < newSize; i++) {
-            if (i >= oldSize)
-                m_labelItems.append(new LabelItem);
-            if (m_drawer) {
-                if (labels.at(i).isEmpty()) {
-                    m_labelItems[i]->clear();
-                } else if (i >= oldSize || labels.at(i) != m_labels.at(i)
-                           || m_labelItems[i]->size().width() != widest) {
-                    m_drawer->generateLabelItem(*m_labelItems[i], labels.at(i), widest);
+            const QString &label = labels.at(i);
+            LabelItem *item = movedItems.take(label);
+            if (!item) {
+                if (!spareItems.isEmpty())
+                    item = spareItems.takeLast();
+                else
+                    item = new LabelItem;
+                if (m_drawer) {
+                    if (label.isEmpty())
+                        item->clear();
+                    else
+                        m_drawer->generateLabelItem(*item, label, widest);
                 }
             }
+            newItems.append(item);
         }
+
+        qDeleteAll(movedItems);
+        qDeleteAll(spareItems);
+        m_labelItems = newItems;
         m_labels = labels;
     }
 }
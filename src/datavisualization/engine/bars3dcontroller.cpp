@@ -108,6 +108,18 @@ void Bars3DController::synchDataToRenderer()
         m_changeTracker.floorLevelChanged = false;
     }
 
+    // Row shifts are relative to the data the renderer currently holds, so they are applied
+    // before the abstract sync. Series that get fully updated anyway are skipped.
+    if (m_changeTracker.rowsShifted) {
+        for (int i = m_shiftedRows.size() - 1; i >= 0; i--) {
+            if (m_changedSeriesList.contains(m_shiftedRows.at(i).series))
+                m_shiftedRows.remove(i);
+        }
+        m_renderer->updateRowShifts(m_shiftedRows);
+        m_changeTracker.rowsShifted = false;
+        m_shiftedRows.clear();
+    }
+
     Abstract3DController::synchDataToRenderer();
 
     // Notify changes to renderer
@@ -294,6 +306,61 @@ void Bars3DController::handleItemChanged(int rowIndex, int columnIndex)
     }
 }
 
+void Bars3DController::handleRowsShifted(int count)
+{
+    QBar3DSeries *series = static_cast<QBarDataProxy *>(sender())->series();
+
+    // Pending row and item changes refer to the row indices before the shift
+    for (int i = m_changedRows.size() - 1; i >= 0; i--) {
+        ChangeRow &changeRow = m_changedRows[i];
+        if (changeRow.series == series) {
+            changeRow.row -= count;
+            if (changeRow.row < 0)
+                m_changedRows.remove(i);
+        }
+    }
+    for (int i = m_changedItems.size() - 1; i >= 0; i--) {
+        ChangeItem &changeItem = m_changedItems[i];
+        if (changeItem.series == series) {
+            changeItem.point.rx() -= count;
+            if (changeItem.point.x() < 0)
+                m_changedItems.remove(i);
+        }
+    }
+
+    if (series == m_selectedBarSeries) {
+        // The selection moves with the shifted rows, unless the selected row dropped out
+        int selectedRow = m_selectedBar.x();
+        if (selectedRow >= 0) {
+            selectedRow -= count;
+            if (selectedRow < 0)
+                selectedRow = -1;
+            setSelectedBar(QPoint(selectedRow, m_selectedBar.y()), m_selectedBarSeries, false);
+        }
+    }
+
+    // A full update already pending for the series covers the shift as well
+    if (!m_changedSeriesList.contains(series)) {
+        bool merged = false;
+        for (int i = 0; i < m_shiftedRows.size(); i++) {
+            if (m_shiftedRows.at(i).series == series) {
+                m_shiftedRows[i].count += count;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            ChangeShift newChangeShift = {series, count};
+            m_shiftedRows.append(newChangeShift);
+        }
+        m_changeTracker.rowsShifted = true;
+    }
+
+    if (series->isVisible())
+        adjustAxisRanges();
+    emitNeedRender();
+}
+
 void Bars3DController::handleDataRowLabelsChanged()
 {
     if (m_axisZ) {
@@ -404,6 +471,11 @@ void Bars3DController::removeSeries(QAbstract3DSeries *series)
 
     Abstract3DController::removeSeries(series);
 
+    for (int i = m_shiftedRows.size() - 1; i >= 0; i--) {
+        if (m_shiftedRows.at(i).series == series)
+            m_shiftedRows.remove(i);
+    }
+
     if (m_selectedBarSeries == series)
         setSelectedBar(invalidSelectionPosition(), 0, false);
 
@@ -54,6 +54,7 @@ struct Bars3DChangeBitField {
     bool selectedBarChanged         : 1;
     bool rowsChanged                : 1;
     bool itemChanged                : 1;
+    bool rowsShifted                : 1;
     bool floorLevelChanged          : 1;
 
     Bars3DChangeBitField() :
@@ -62,6 +63,7 @@ struct Bars3DChangeBitField {
         selectedBarChanged(true),
         rowsChanged(false),
         itemChanged(false),
+        rowsShifted(false),
         floorLevelChanged(false)
     {
     }
@@ -80,11 +82,16 @@ public:
         QBar3DSeries *series;
         int row;
     };
+    struct ChangeShift {
+        QBar3DSeries *series;
+        int count;
+    };
 
 private:
     Bars3DChangeBitField m_changeTracker;
     QVector<ChangeItem> m_changedItems;
     QVector<ChangeRow> m_changedRows;
+    QVector<ChangeShift> m_shiftedRows;
 
     // Interaction
     QPoint m_selectedBar;     // Points to row & column in data window.
@@ -157,6 +164,7 @@ public Q_SLOTS:
     void handleRowsRemoved(int startIndex, int count);
     void handleRowsInserted(int startIndex, int count);
     void handleItemChanged(int rowIndex, int columnIndex);
+    void handleRowsShifted(int count);
     void handleDataRowLabelsChanged();
     void handleDataColumnLabelsChanged();
 
@@ -35,6 +35,7 @@
 #include "barseriesrendercache_p.h"
 
 #include <QtCore/qmath.h>
+#include <algorithm>
 
 // You can verify that depth buffer drawing works correctly by uncommenting this.
 // You should see the scene from  where the light is
@@ -90,7 +91,8 @@ Bars3DRenderer::Bars3DRenderer(Bars3DController *controller)
       m_xScaleFactor(1.0f),
       m_zScaleFactor(1.0f),
       m_floorLevel(0.0f),
-      m_actualFloorLevel(0.0f)
+      m_actualFloorLevel(0.0f),
+      m_heightsDirty(false)
 {
     m_axisCacheY.setScale(2.0f);
     m_axisCacheY.setTranslate(-1.0f);
@@ -251,9 +253,17 @@ void Bars3DRenderer::updateData()
                     dataRowIndex++;
                 }
                 cache->setDataDirty(false);
+            } else if (m_heightsDirty) {
+                // Only the value range changed, so the cached values are still valid
+                for (int i = 0; i < renderArray.size(); i++) {
+                    BarRenderItemRow &renderRow = renderArray[i];
+                    for (int j = 0; j < renderRow.size(); j++)
+                        renderRow[j].setHeight(calculateHeight(renderRow.at(j).value()));
+                }
             }
         }
     }
+    m_heightsDirty = false;
 
     // Reset selected bar to update selection
     updateSelectedBar(m_selectedBarPos,
@@ -284,6 +294,21 @@ void Bars3DRenderer::updateRenderRow(const QBarDataRow *dataRow, BarRenderItemRo
 void Bars3DRenderer::updateRenderItem(const QBarDataItem &dataItem, BarRenderItem &renderItem)
 {
     float value = dataItem.value();
+    renderItem.setValue(value);
+    renderItem.setHeight(calculateHeight(value));
+
+    float angle = dataItem.rotation();
+    if (angle) {
+        renderItem.setRotation(
+                    QQuaternion::fromAxisAndAngle(
+                        upVector, angle));
+    } else {
+        renderItem.setRotation(identityQuaternion);
+    }
+}
+
+float Bars3DRenderer::calculateHeight(float value) const
+{
     float heightValue = m_axisCacheY.formatter()->positionAt(value);
     if (m_noZeroInRange) {
         if (m_hasNegativeValues) {
@@ -300,17 +325,7 @@ void Bars3DRenderer::updateRenderItem(const QBarDataItem &dataItem, BarRenderIte
     if (m_axisCacheY.reversed())
         heightValue = -heightValue;
 
-    renderItem.setValue(value);
-    renderItem.setHeight(heightValue);
-
-    float angle = dataItem.rotation();
-    if (angle) {
-        renderItem.setRotation(
-                    QQuaternion::fromAxisAndAngle(
-                        upVector, angle));
-    } else {
-        renderItem.setRotation(identityQuaternion);
-    }
+    return heightValue;
 }
 
 void Bars3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
@@ -425,6 +440,51 @@ void Bars3DRenderer::updateItems(const QVector<Bars3DController::ChangeItem> &it
     }
 }
 
+void Bars3DRenderer::updateRowShifts(const QVector<Bars3DController::ChangeShift> &shifts)
+{
+    int minRow = m_axisCacheZ.min();
+
+    foreach (Bars3DController::ChangeShift shift, shifts) {
+        BarSeriesRenderCache *cache =
+                static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(shift.series));
+        // Dirty caches get fully recalculated in the next data update anyway
+        if (!cache || cache->dataDirty())
+            continue;
+        // Invisible series render caches are not updated, but instead just marked dirty, so that
+        // they can be completely recalculated when they are turned visible.
+        if (!cache->isVisible()) {
+            cache->setDataDirty(true);
+            continue;
+        }
+
+        BarRenderItemArray &renderArray = cache->renderArray();
+        const int renderRowCount = renderArray.size();
+        const int count = shift.count;
+        if (count >= renderRowCount) {
+            // Nothing to reuse, so let the next data update recalculate everything
+            cache->setDataDirty(true);
+            continue;
+        }
+
+        // Rows that are still visible after the shift only move up in the render array.
+        // Swapping the rows around avoids recalculating their items.
+        std::rotate(renderArray.begin(), renderArray.begin() + count, renderArray.end());
+
+        const QBarDataProxy *dataProxy = shift.series->dataProxy();
+        const int dataRowCount = dataProxy->rowCount();
+        for (int i = renderRowCount - count; i < renderRowCount; i++) {
+            const int dataRowIndex = minRow + i;
+            const QBarDataRow *dataRow = 0;
+            if (dataRowIndex < dataRowCount)
+                dataRow = dataProxy->rowAt(dataRowIndex);
+            updateRenderRow(dataRow, renderArray[i]);
+        }
+
+        if (m_cachedIsSlicingActivated && cache == m_selectedSeriesCache)
+            m_selectionDirty = true; // Need to update slice view
+    }
+}
+
 void Bars3DRenderer::updateScene(Q3DScene *scene)
 {
     if (!m_noZeroInRange) {
@@ -1083,8 +1143,10 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                     const BarRenderItemRow &renderRow = renderArray.at(row);
                     for (int bar = startBar; bar != stopBar; bar += stepBar) {
                         const BarRenderItem &item = renderRow.at(bar);
-                        if (!item.value())
+                        if (!item.value()
+                                || isProgressivelySkipped(row * renderRow.size() + bar)) {
                             continue;
+                        }
                         GLfloat shadowOffset = 0.0f;
                         // Set front face culling for negative valued bars and back face culling
                         // for positive valued bars to remove peter-panning issues
@@ -1627,7 +1689,10 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
                         }
                     }
 
-                    if (item.height() == 0) {
+                    // Progressive frames draw only a subset of the bars, but always the selected one
+                    if (item.height() == 0
+                            || (isProgressivelySkipped(row * renderRow.size() + bar)
+                                && *selectedBar != &item)) {
                         continue;
                     } else if ((m_reflectionEnabled
                                 && (reflection == 1.0f
@@ -2461,10 +2526,21 @@ void Bars3DRenderer::updateBarSpecs(GLfloat thicknessRatio, const QSizeF &spacin
 void Bars3DRenderer::updateAxisRange(QAbstract3DAxis::AxisOrientation orientation, float min,
                                      float max)
 {
-    Abstract3DRenderer::updateAxisRange(orientation, min, max);
-
-    if (orientation == QAbstract3DAxis::AxisOrientationY)
+    if (orientation == QAbstract3DAxis::AxisOrientationY) {
+        // Bar heights are the only render data that depend on the value range, so they are
+        // recalculated from the cached values instead of reading all data again. This keeps
+        // row shifts and other partial updates valid when the value axis auto adjusts.
+        m_axisCacheY.setMin(min);
+        m_axisCacheY.setMax(max);
+        foreach (SeriesRenderCache *cache, m_renderCacheList) {
+            if (!cache->isVisible())
+                cache->setDataDirty(true);
+        }
+        m_heightsDirty = true;
         calculateHeightAdjustment();
+    } else {
+        Abstract3DRenderer::updateAxisRange(orientation, min, max);
+    }
 }
 
 void Bars3DRenderer::updateAxisReversed(QAbstract3DAxis::AxisOrientation orientation, bool enable)
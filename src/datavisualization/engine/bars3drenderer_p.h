@@ -114,6 +114,7 @@ private:
     float m_zScaleFactor;
     float m_floorLevel;
     float m_actualFloorLevel;
+    bool m_heightsDirty;
 
 public:
     explicit Bars3DRenderer(Bars3DController *controller);
@@ -124,6 +125,7 @@ public:
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series);
     void updateRows(const QVector<Bars3DController::ChangeRow> &rows);
     void updateItems(const QVector<Bars3DController::ChangeItem> &items);
+    void updateRowShifts(const QVector<Bars3DController::ChangeShift> &shifts);
     void updateScene(Q3DScene *scene);
     void render(GLuint defaultFboHandle = 0);
 
@@ -192,6 +194,7 @@ private:
 
     inline void updateRenderRow(const QBarDataRow *dataRow, BarRenderItemRow &renderRow);
     inline void updateRenderItem(const QBarDataItem &dataItem, BarRenderItem &renderItem);
+    inline float calculateHeight(float value) const;
 
     Q_DISABLE_COPY(Bars3DRenderer)
 };
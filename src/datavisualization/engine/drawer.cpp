@@ -34,8 +34,10 @@
 #include "texturehelper_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
 
 #include <QtGui/QMatrix4x4>
+#include <QtGui/QOpenGLExtraFunctions>
 #include <QtCore/qmath.h>
 
 // Resources need to be explicitly initialized when building as static library
@@ -182,6 +184,97 @@ void Drawer::drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLui
     }
 }
 
+void Drawer::drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                                 ScatterInstanceBufferHelper *instances, GLuint textureId,
+                                 GLuint depthTextureId)
+{
+    // Requires OpenGL 3.3 or OpenGL ES 3.0, the caller is responsible for checking the support
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // 1st attribute buffer : vertices
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 2nd attribute buffer : normals
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // 3rd attribute buffer : UVs
+    if (shader->uvAtt() >= 0) {
+        glEnableVertexAttribArray(shader->uvAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->uvBuf());
+        glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // Per-instance attributes, interleaved in a single buffer
+    const GLsizei stride = sizeof(ScatterInstanceBufferHelper::InstanceData);
+    const GLint instanceAtts[3] = { shader->instancePosAtt(), shader->instanceRotationAtt(),
+                                    shader->instanceGradientAtt() };
+    const GLint instanceSizes[3] = { 3, 4, 2 };
+    const size_t instanceOffsets[3] = { 0, sizeof(QVector3D), sizeof(QVector3D) + sizeof(QVector4D) };
+    glBindBuffer(GL_ARRAY_BUFFER, instances->instanceBuf());
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            glEnableVertexAttribArray(instanceAtts[i]);
+            glVertexAttribPointer(instanceAtts[i], instanceSizes[i], GL_FLOAT, GL_FALSE, stride,
+                                  (void *)instanceOffsets[i]);
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 1);
+        }
+    }
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw all instances
+    extraFuncs->glDrawElementsInstanced(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT,
+                                        (void*)0, instances->instanceCount());
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Divisors are attribute state, so reset them for the shaders using the same locations
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 0);
+            glDisableVertexAttribArray(instanceAtts[i]);
+        }
+    }
+    if (shader->uvAtt() >= 0)
+        glDisableVertexAttribArray(shader->uvAtt());
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
 void Drawer::drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *object)
 {
     glEnableVertexAttribArray(shader->posAtt());
@@ -214,10 +307,75 @@ void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
     glDisableVertexAttribArray(shader->posAtt());
 }
 
-void Drawer::drawPoint(ShaderHelper *shader)
+void Drawer::drawSurfaceHeightfield(ShaderHelper *shader, SurfaceObject *object,
+                                    GLuint textureId, GLuint depthTextureId)
+{
+    // Requires vertex texture fetch, the caller is responsible for checking the support
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    bindSurfaceHeightfield(shader, object);
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw the triangles
+    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void*)0);
+
+    // Free buffers
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    releaseSurfaceHeightfield(shader);
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Drawer::drawSurfaceHeightfieldGrid(ShaderHelper *shader, SurfaceObject *object)
+{
+    bindSurfaceHeightfield(shader, object);
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->gridElementBuf());
+
+    // Draw the lines
+    glDrawElements(GL_LINES, object->gridIndexCount(), GL_UNSIGNED_INT, (void*)0);
+
+    // Free buffers
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    releaseSurfaceHeightfield(shader);
+}
+
+void Drawer::drawPoint(ShaderHelper *shader, GLuint textureId)
 {
     // Draw a single point
 
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
     // Generate vertex buffer for point if it does not exist
     if (!m_pointbuffer) {
         glGenBuffers(1, &m_pointbuffer);
@@ -237,6 +395,11 @@ void Drawer::drawPoint(ShaderHelper *shader)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glDisableVertexAttribArray(shader->posAtt());
+
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
 }
 
 void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId)
@@ -253,13 +416,6 @@ void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object,
     glBindBuffer(GL_ARRAY_BUFFER, object->pointBuf());
     glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
-    // 2nd attribute buffer : UVs
-    if (textureId) {
-        glEnableVertexAttribArray(shader->uvAtt());
-        glBindBuffer(GL_ARRAY_BUFFER, object->uvBuf());
-        glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
-    }
-
     // Draw the points
     glDrawArrays(GL_POINTS, 0, object->indexCount());
 
@@ -269,7 +425,6 @@ void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object,
     glDisableVertexAttribArray(shader->posAtt());
 
     if (textureId) {
-        glDisableVertexAttribArray(shader->uvAtt());
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, 0);
     }
@@ -421,6 +576,31 @@ void Drawer::drawLabel(const AbstractRenderItem &item, const LabelItem &labelIte
     }
 }
 
+void Drawer::bindSurfaceHeightfield(ShaderHelper *shader, SurfaceObject *object)
+{
+    // Activate height texture, units 0-2 are reserved for the shared textures
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, object->heightTexture());
+    shader->setUniformValue(shader->heightSampler(), 3);
+    shader->setUniformValue(shader->heightfieldRect(), object->heightfieldRect());
+    shader->setUniformValue(shader->heightfieldSize(), object->heightfieldSize());
+
+    // Only attribute buffer : grid coordinates, positions and normals come from the texture
+    glEnableVertexAttribArray(shader->uvAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->heightfieldGridBuf());
+    glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Drawer::releaseSurfaceHeightfield(ShaderHelper *shader)
+{
+    glDisableVertexAttribArray(shader->uvAtt());
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
 void Drawer::generateSelectionLabelTexture(Abstract3DRenderer *renderer)
 {
     LabelItem &labelItem = renderer->selectionLabelItem();
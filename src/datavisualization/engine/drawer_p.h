@@ -56,6 +56,7 @@ class TextureHelper;
 class Q3DCamera;
 class Abstract3DRenderer;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
 
 class Drawer : public QObject, public QOpenGLFunctions
 {
@@ -87,9 +88,15 @@ public:
 
     void drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLuint textureId = 0,
                     GLuint depthTextureId = 0, GLuint textureId3D = 0);
+    void drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                             ScatterInstanceBufferHelper *instances, GLuint textureId = 0,
+                             GLuint depthTextureId = 0);
     void drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *object);
     void drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object);
-    void drawPoint(ShaderHelper *shader);
+    void drawSurfaceHeightfield(ShaderHelper *shader, SurfaceObject *object,
+                                GLuint textureId = 0, GLuint depthTextureId = 0);
+    void drawSurfaceHeightfieldGrid(ShaderHelper *shader, SurfaceObject *object);
+    void drawPoint(ShaderHelper *shader, GLuint textureId = 0);
     void drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId);
     void drawLine(ShaderHelper *shader);
     void drawLabel(const AbstractRenderItem &item, const LabelItem &labelItem,
@@ -108,6 +115,9 @@ Q_SIGNALS:
     void drawerChanged();
 
 private:
+    void bindSurfaceHeightfield(ShaderHelper *shader, SurfaceObject *object);
+    void releaseSurfaceHeightfield(ShaderHelper *shader);
+
     Q3DTheme *m_theme;
     TextureHelper *m_textureHelper;
     GLuint m_pointbuffer;
@@ -164,6 +164,12 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
            Provides the full feature set at a reasonable performance.
     \value OptimizationStatic
            Optimizes the rendering of static data sets at the expense of some features.
+    \value OptimizationInstanced
+           Draws all items of a scatter series with a single instanced draw call, keeping
+           item updates as cheap as in the default mode. Requires OpenGL 3.3 or
+           OpenGL ES 3.0; otherwise the default mode is used. Has no effect on series
+           using the point mesh or when combined with OptimizationStatic.
+           This value was added in Qt Data Visualization 1.3.
 */
 
 /*!
@@ -699,13 +705,16 @@ qreal QAbstract3DGraph::aspectRatio() const
 /*!
  * \property QAbstract3DGraph::optimizationHints
  *
- * \brief Whether the default or static mode is used for rendering optimization.
+ * \brief Whether the default, static, or instanced mode is used for rendering optimization.
  *
  * The default mode provides the full feature set at a reasonable level of
  * performance. The static mode optimizes graph rendering and is ideal for
  * large non-changing data sets. It is slower with dynamic data changes and item rotations.
  * Selection is not optimized, so using the static mode with massive data sets is not advisable.
  * Static optimization works only on scatter graphs.
+ * The instanced mode uploads the item mesh once and per-item positions, rotations, and
+ * gradient positions into a separate buffer, which makes it suitable for large scatter data
+ * sets that change often. It also works only on scatter graphs.
  * Defaults to \l{OptimizationDefault}.
  *
  * \note On some environments, large graphs using static optimization may not render, because
@@ -930,6 +939,36 @@ qreal QAbstract3DGraph::margin() const
     return d_ptr->m_visualController->margin();
 }
 
+/*!
+ * \property QAbstract3DGraph::progressiveFrameBudget
+ * \since QtDataVisualization 1.3
+ *
+ * \brief The time budget in milliseconds for drawing a frame while the camera
+ * is moving.
+ *
+ * When the budget is set and drawing the whole scene takes longer than the
+ * budget, only an evenly spread subset of the graph items is drawn while the
+ * camera moves, so that the graph stays responsive during rotation and zooming
+ * of very large data sets. The whole scene is drawn again once the camera has
+ * stayed still for a short while. The selected item is always drawn.
+ *
+ * The budget is approximate, as the subset size is estimated from the time
+ * taken by the previous fully drawn frame. Only items that are drawn one by
+ * one are affected, so series drawn with QAbstract3DGraph::OptimizationStatic
+ * or QAbstract3DGraph::OptimizationInstanced and surfaces are always fully drawn.
+ *
+ * Defaults to \c{0}, which disables progressive rendering.
+ */
+void QAbstract3DGraph::setProgressiveFrameBudget(int budget)
+{
+    d_ptr->m_visualController->setProgressiveFrameBudget(budget);
+}
+
+int QAbstract3DGraph::progressiveFrameBudget() const
+{
+    return d_ptr->m_visualController->progressiveFrameBudget();
+}
+
 /*!
  * Returns \c{true} if the OpenGL context of the graph has been successfully initialized.
  * Trying to use a graph when the context initialization has failed typically results in a crash.
@@ -1116,6 +1155,8 @@ void QAbstract3DGraphPrivate::setVisualController(Abstract3DController *controll
                      &QAbstract3DGraph::queriedGraphPositionChanged);
     QObject::connect(m_visualController, &Abstract3DController::marginChanged, q_ptr,
                      &QAbstract3DGraph::marginChanged);
+    QObject::connect(m_visualController, &Abstract3DController::progressiveFrameBudgetChanged,
+                     q_ptr, &QAbstract3DGraph::progressiveFrameBudgetChanged);
 }
 
 void QAbstract3DGraphPrivate::handleDevicePixelRatioChange()
@@ -70,6 +70,7 @@ class QT_DATAVISUALIZATION_EXPORT QAbstract3DGraph : public QWindow, protected Q
     Q_PROPERTY(QLocale locale READ locale WRITE setLocale NOTIFY localeChanged)
     Q_PROPERTY(QVector3D queriedGraphPosition READ queriedGraphPosition NOTIFY queriedGraphPositionChanged)
     Q_PROPERTY(qreal margin READ margin WRITE setMargin NOTIFY marginChanged)
+    Q_PROPERTY(int progressiveFrameBudget READ progressiveFrameBudget WRITE setProgressiveFrameBudget NOTIFY progressiveFrameBudgetChanged)
 
 protected:
     explicit QAbstract3DGraph(QAbstract3DGraphPrivate *d, const QSurfaceFormat *format,
@@ -111,7 +112,8 @@ public:
 
     enum OptimizationHint {
         OptimizationDefault = 0,
-        OptimizationStatic  = 1
+        OptimizationStatic  = 1,
+        OptimizationInstanced = 2
     };
     Q_DECLARE_FLAGS(OptimizationHints, OptimizationHint)
 
@@ -194,6 +196,9 @@ public:
     void setMargin(qreal margin);
     qreal margin() const;
 
+    void setProgressiveFrameBudget(int budget);
+    int progressiveFrameBudget() const;
+
     bool hasContext() const;
 
 protected:
@@ -229,6 +234,7 @@ Q_SIGNALS:
     void localeChanged(const QLocale &locale);
     void queriedGraphPositionChanged(const QVector3D &data);
     void marginChanged(qreal margin);
+    void progressiveFrameBudgetChanged(int budget);
 
 private:
     Q_DISABLE_COPY(QAbstract3DGraph)
@@ -35,6 +35,11 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "scatterspatialindex_p.h"
+#include "scatterdensitygrid_p.h"
+#include "qscatterdataproxy_p.h"
+#include "parallelrangejob_p.h"
 
 #include <QtCore/qmath.h>
 
@@ -47,6 +52,50 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 const GLfloat defaultMinSize = 0.01f;
 const GLfloat defaultMaxSize = 0.1f;
 const GLfloat itemScaler = 3.0f;
+const float defaultFullUploadFraction = 0.25f;
+// Minimum number of render items in a series for culling the items with a spatial index
+const int minSpatialIndexItems = 16384;
+// Bounding sphere radius of the built-in meshes relative to the item size
+const float itemBoundingRadius = 1.75f;
+// Minimum number of render items updated as a single band in parallel updates
+const int minRenderItemBandSize = 8192;
+
+// Updates the render items of a series in parallel bands
+class ScatterRenderItemUpdateJob : public ParallelRangeJob
+{
+public:
+    ScatterRenderItemUpdateJob(Scatter3DRenderer *renderer,
+                               const QScatterDataProxyPrivate *dataProxy,
+                               ScatterRenderItem *renderItems)
+        : m_renderer(renderer),
+          m_dataProxy(dataProxy),
+          m_renderItems(renderItems)
+    {
+    }
+
+protected:
+    void processRange(int begin, int end)
+    {
+        for (int i = begin; i < end; i++) {
+            m_renderer->updateRenderItem(m_dataProxy->positionAt(i), m_dataProxy->rotationAt(i),
+                                         m_renderItems[i]);
+        }
+    }
+
+private:
+    Scatter3DRenderer *m_renderer;
+    const QScatterDataProxyPrivate *m_dataProxy;
+    ScatterRenderItem *m_renderItems;
+};
+
+// Resolves the level of detail of an item from its projected size in pixels
+static inline ScatterSeriesRenderCache::LodLevel itemLodLevel(
+        const ScatterSeriesRenderCache *cache, const ScatterRenderItem &item,
+        const QVector4D &clipWRow, float itemSizeScale)
+{
+    const float clipW = QVector4D::dotProduct(clipWRow, QVector4D(item.translation(), 1.0f));
+    return cache->lodLevel(clipW > 0.0f ? itemSizeScale / clipW : 0.0f);
+}
 
 Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
     : Abstract3DRenderer(controller),
@@ -60,7 +109,10 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_depthShader(0),
       m_selectionShader(0),
       m_backgroundShader(0),
-      m_staticGradientPointShader(0),
+      m_pointGradientShader(0),
+      m_instancedDotShader(0),
+      m_instancedDotGradientShader(0),
+      m_instancedDepthShader(0),
       m_bgrTexture(0),
       m_selectionTexture(0),
       m_depthFrameBuffer(0),
@@ -80,7 +132,10 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_havePointSeries(false),
       m_haveMeshSeries(false),
       m_haveUniformColorMeshSeries(false),
-      m_haveGradientMeshSeries(false)
+      m_haveGradientMeshSeries(false),
+      m_instancingSupported(false),
+      m_fullUploadFraction(defaultFullUploadFraction),
+      m_densityVolumeObj(0)
 {
     initializeOpenGL();
 }
@@ -103,13 +158,25 @@ Scatter3DRenderer::~Scatter3DRenderer()
     delete m_depthShader;
     delete m_selectionShader;
     delete m_backgroundShader;
-    delete m_staticGradientPointShader;
+    delete m_pointGradientShader;
+    delete m_instancedDotShader;
+    delete m_instancedDotGradientShader;
+    delete m_instancedDepthShader;
+
+    ObjectHelper::releaseObjectHelper(this, m_densityVolumeObj);
 }
 
 void Scatter3DRenderer::initializeOpenGL()
 {
     Abstract3DRenderer::initializeOpenGL();
 
+    // Instanced drawing needs OpenGL 3.3 or OpenGL ES 3.0
+    const QSurfaceFormat format = QOpenGLContext::currentContext()->format();
+    if (m_isOpenGLES)
+        m_instancingSupported = format.majorVersion() >= 3;
+    else
+        m_instancingSupported = format.version() >= qMakePair(3, 3);
+
     // Initialize shaders
 
     if (!m_isOpenGLES) {
@@ -122,6 +189,9 @@ void Scatter3DRenderer::initializeOpenGL()
     // Init selection shader
     initSelectionShader();
 
+    // Init range gradient point shader
+    initPointGradientShader();
+
     // Set view port
     glViewport(m_primarySubViewport.x(),
                m_primarySubViewport.y(),
@@ -183,25 +253,43 @@ void Scatter3DRenderer::updateData()
 {
     calculateSceneScalingFactors();
     int totalDataSize = 0;
+    const bool parallelUpdate = hasReentrantFormatters();
 
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
         if (cache->isVisible()) {
             const QScatter3DSeries *currentSeries = cache->series();
             ScatterRenderItemArray &renderArray = cache->renderArray();
-            QScatterDataProxy *dataProxy = currentSeries->dataProxy();
-            const QScatterDataArray &dataArray = *dataProxy->array();
-            int dataSize = dataArray.size();
+            const QScatterDataProxyPrivate *dataProxy =
+                    static_cast<QScatterDataProxyPrivate *>(currentSeries->d_ptr->dataProxyPrivate());
+            int dataSize = dataProxy->itemCount();
             totalDataSize += dataSize;
             if (cache->dataDirty()) {
                 if (dataSize != renderArray.size())
                     renderArray.resize(dataSize);
 
-                for (int i = 0; i < dataSize; i++)
-                    updateRenderItem(dataArray.at(i), renderArray[i]);
+                if (parallelUpdate) {
+                    // Detach the array before the items are written from several threads
+                    QSharedPointer<ParallelRangeJob> job(
+                                new ScatterRenderItemUpdateJob(this, dataProxy,
+                                                               renderArray.data()));
+                    ParallelRangeJob::run(job, dataSize, minRenderItemBandSize);
+                } else {
+                    for (int i = 0; i < dataSize; i++) {
+                        updateRenderItem(dataProxy->positionAt(i), dataProxy->rotationAt(i),
+                                         renderArray[i]);
+                    }
+                }
 
                 if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic))
                     cache->setStaticBufferDirty(true);
+                else if (isInstancingActive())
+                    cache->setInstanceBufferDirty(true);
+                if (cache->spatialIndex())
+                    cache->spatialIndex()->setDirty();
+                if (cache->densityGrid())
+                    cache->densityGrid()->setDirty();
+                cache->setItemMatricesDirty();
 
                 cache->setDataDirty(false);
             }
@@ -217,38 +305,9 @@ void Scatter3DRenderer::updateData()
     if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
-            if (cache->isVisible()) {
-                ScatterRenderItemArray &renderArray = cache->renderArray();
-                const int renderArraySize = renderArray.size();
-
-                if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
-                    ScatterPointBufferHelper *points = cache->bufferPoints();
-                    if (!points) {
-                        points = new ScatterPointBufferHelper();
-                        cache->setBufferPoints(points);
-                    }
-                    points->setScaleY(m_scaleY);
-                    points->load(cache);
-                } else {
-                    ScatterObjectBufferHelper *object = cache->bufferObject();
-                    if (!object) {
-                        object = new ScatterObjectBufferHelper();
-                        cache->setBufferObject(object);
-                    }
-                    if (renderArraySize != cache->oldArraySize()
-                            || cache->object()->objectFile() != cache->oldMeshFileName()
-                            || cache->staticBufferDirty()) {
-                        object->setScaleY(m_scaleY);
-                        object->fullLoad(cache, m_dotSizeScale);
-                        cache->setOldArraySize(renderArraySize);
-                        cache->setOldMeshFileName(cache->object()->objectFile());
-                    } else {
-                        object->update(cache, m_dotSizeScale);
-                    }
-                }
-
-                cache->setStaticBufferDirty(false);
-            }
+            // Density series are drawn as volumes, so they have no item buffers
+            if (cache->isVisible() && !cache->isDensityRendering())
+                loadStaticBuffers(cache);
         }
     }
 
@@ -256,6 +315,41 @@ void Scatter3DRenderer::updateData()
                        m_selectedSeriesCache ? m_selectedSeriesCache->series() : 0);
 }
 
+void Scatter3DRenderer::loadStaticBuffers(ScatterSeriesRenderCache *cache)
+{
+    ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int renderArraySize = renderArray.size();
+
+    if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
+        ScatterPointBufferHelper *points = cache->bufferPoints();
+        if (!points) {
+            points = new ScatterPointBufferHelper();
+            points->setUploadStats(&m_uploadStats);
+            cache->setBufferPoints(points);
+        }
+        points->load(cache);
+    } else {
+        ScatterObjectBufferHelper *object = cache->bufferObject();
+        if (!object) {
+            object = new ScatterObjectBufferHelper();
+            object->setUploadStats(&m_uploadStats);
+            cache->setBufferObject(object);
+            cache->setStaticBufferDirty(true);
+        }
+        if (renderArraySize != cache->oldArraySize()
+                || cache->seriesLodObject()->objectFile() != cache->oldMeshFileName()
+                || cache->staticBufferDirty()) {
+            object->fullLoad(cache, m_dotSizeScale);
+            cache->setOldArraySize(renderArraySize);
+            cache->setOldMeshFileName(cache->seriesLodObject()->objectFile());
+        } else {
+            object->update(cache, m_dotSizeScale);
+        }
+    }
+
+    cache->setStaticBufferDirty(false);
+}
+
 void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
 {
     int seriesCount = seriesList.size();
@@ -269,7 +363,7 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 ScatterSeriesRenderCache *cache =
                         static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(scatterSeries));
                 if (cache) {
-                    if (changeTracker.baseGradientChanged || changeTracker.colorStyleChanged)
+                    if (changeTracker.colorStyleChanged)
                         cache->setStaticObjectUVDirty(true);
                     if (cache->itemSize() != scatterSeries->itemSize())
                         cache->setStaticBufferDirty(true);
@@ -278,6 +372,17 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
         }
     }
 
+    // Gradient positions of instances depend on the color style
+    if (isInstancingActive()) {
+        for (int i = 0; i < seriesCount; i++) {
+            QScatter3DSeries *scatterSeries = static_cast<QScatter3DSeries *>(seriesList[i]);
+            ScatterSeriesRenderCache *cache =
+                    static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(scatterSeries));
+            if (cache && scatterSeries->d_ptr->m_changeTracker.colorStyleChanged)
+                cache->setInstanceBufferDirty(true);
+        }
+    }
+
     Abstract3DRenderer::updateSeries(seriesList);
 
     float maxItemSize = 0.0f;
@@ -299,6 +404,8 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 maxItemSize = itemSize;
             if (cache->itemSize() != itemSize)
                 cache->setItemSize(itemSize);
+            cache->setLodThresholds(scatterSeries->lodThreshold(),
+                                    scatterSeries->lodPointThreshold());
             if (noSelection
                     && scatterSeries->selectedItem() != QScatter3DSeries::invalidSelectionIndex()) {
                 if (m_selectionLabel != cache->itemLabel())
@@ -316,22 +423,26 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                     m_haveGradientMeshSeries = true;
             }
 
-            if (cache->staticBufferDirty()) {
-                if (cache->mesh() != QAbstract3DSeries::MeshPoint) {
-                    ScatterObjectBufferHelper *object = cache->bufferObject();
-                    object->update(cache, m_dotSizeScale);
+            // Density series keep their static buffers dirty until they are drawn as items
+            // again, as populate() releases the buffers when switching to density rendering.
+            if (!cache->isDensityRendering()) {
+                if (cache->staticBufferDirty()) {
+                    if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
+                        if (cache->bufferObject() || cache->bufferPoints()) {
+                            if (cache->mesh() != QAbstract3DSeries::MeshPoint)
+                                cache->bufferObject()->update(cache, m_dotSizeScale);
+                        } else {
+                            loadStaticBuffers(cache);
+                        }
+                    }
+                    cache->setStaticBufferDirty(false);
                 }
-                cache->setStaticBufferDirty(false);
-            }
-            if (cache->staticObjectUVDirty()) {
-                if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
-                    ScatterPointBufferHelper *object = cache->bufferPoints();
-                    object->updateUVs(cache);
-                } else {
-                    ScatterObjectBufferHelper *object = cache->bufferObject();
-                    object->updateUVs(cache);
+                if (cache->staticObjectUVDirty()) {
+                    // Point gradients don't use UVs
+                    if (cache->mesh() != QAbstract3DSeries::MeshPoint && cache->bufferObject())
+                        cache->bufferObject()->updateUVs(cache);
+                    cache->setStaticObjectUVDirty(false);
                 }
-                cache->setStaticObjectUVDirty(false);
             }
         }
     }
@@ -354,16 +465,18 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
 {
     ScatterSeriesRenderCache *cache = 0;
     const QScatter3DSeries *prevSeries = 0;
-    const QScatterDataArray *dataArray = 0;
+    const QScatterDataProxyPrivate *dataProxy = 0;
     const bool optimizationStatic = m_cachedOptimizationHint.testFlag(
                 QAbstract3DGraph::OptimizationStatic);
+    const bool optimizationInstanced = isInstancingActive();
 
     foreach (Scatter3DController::ChangeItem item, items) {
         QScatter3DSeries *currentSeries = item.series;
         if (currentSeries != prevSeries) {
             cache = static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
             prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
+            dataProxy = static_cast<QScatterDataProxyPrivate *>(
+                        currentSeries->d_ptr->dataProxyPrivate());
             // Invisible series render caches are not updated, but instead just marked dirty, so that
             // they can be completely recalculated when they are turned visible.
             if (!cache->isVisible() && !cache->dataDirty())
@@ -377,11 +490,29 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
             ScatterRenderItem &item = cache->renderArray()[index];
             if (optimizationStatic)
                 oldVisibility = item.isVisible();
-            updateRenderItem(dataArray->at(index), item);
-            if (optimizationStatic) {
+            updateRenderItem(dataProxy->positionAt(index), dataProxy->rotationAt(index), item);
+            if (cache->spatialIndex())
+                cache->spatialIndex()->updateItem(index, item);
+            if (cache->densityGrid())
+                cache->densityGrid()->updateItem(index, item);
+            cache->setItemMatrixDirty(index);
+            if (optimizationStatic && !cache->isDensityRendering()) {
                 if (!cache->visibilityChanged() && oldVisibility != item.isVisible())
                     cache->setVisibilityChanged(true);
                 cache->updateIndices().append(index);
+            } else if (optimizationInstanced && cache->bufferInstances()
+                       && !cache->instanceBufferDirty()) {
+                cache->updateIndices().append(index);
+            }
+        }
+    }
+    if (optimizationInstanced) {
+        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+            ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+            if (cache->isVisible() && cache->updateIndices().size()) {
+                prepareUpdateIndices(cache);
+                cache->bufferInstances()->update(cache);
+                cache->updateIndices().clear();
             }
         }
     }
@@ -389,10 +520,9 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
             if (cache->isVisible() && cache->updateIndices().size()) {
+                prepareUpdateIndices(cache);
                 if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
                     cache->bufferPoints()->update(cache);
-                    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-                        cache->bufferPoints()->updateUVs(cache);
                 } else {
                     if (cache->visibilityChanged()) {
                         // If any change changes item visibility, full load is needed to
@@ -401,8 +531,6 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
                         cache->bufferObject()->fullLoad(cache, m_dotSizeScale);
                     } else {
                         cache->bufferObject()->update(cache, m_dotSizeScale);
-                        if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-                            cache->bufferObject()->updateUVs(cache);
                     }
                 }
                 cache->updateIndices().clear();
@@ -412,6 +540,20 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
     }
 }
 
+void Scatter3DRenderer::prepareUpdateIndices(ScatterSeriesRenderCache *cache)
+{
+    // Sorted indices let the buffer helpers merge neighboring items into single uploads.
+    // When most of the items have changed, clearing the indices makes the helpers upload
+    // the whole buffer in one go instead.
+    QVector<int> &updateIndices = cache->updateIndices();
+    BufferUploadHelper::sortIndices(updateIndices);
+    if (BufferUploadHelper::isFullUploadPreferred(updateIndices.size(),
+                                                  cache->renderArray().size(),
+                                                  m_fullUploadFraction)) {
+        updateIndices.clear();
+    }
+}
+
 void Scatter3DRenderer::updateScene(Q3DScene *scene)
 {
     scene->activeCamera()->d_ptr->setMinYRotation(-90.0f);
@@ -445,10 +587,15 @@ void Scatter3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHin
 
     Abstract3DRenderer::reInitShaders();
 
-    if (m_isOpenGLES && hint.testFlag(QAbstract3DGraph::OptimizationStatic)
-            && !m_staticGradientPointShader) {
-        initStaticPointShaders(QStringLiteral(":/shaders/vertexPointES2_UV"),
-                               QStringLiteral(":/shaders/fragmentLabel"));
+    if (hint.testFlag(QAbstract3DGraph::OptimizationInstanced) && !m_instancingSupported)
+        qWarning("Instanced rendering requires OpenGL 3.3 or OpenGL ES 3.0, using default mode");
+
+    initInstancedShaders();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        cache->setInstanceBufferDirty(true);
+        // Item matrices are only needed when the items are drawn one by one
+        cache->clearItemMatrices();
     }
 }
 
@@ -478,6 +625,10 @@ void Scatter3DRenderer::render(GLuint defaultFboHandle)
 
     // Draw dots scene
     drawScene(defaultFboHandle);
+
+    // Buffer uploads done since the previous frame, including data synchronization
+    m_lastFrameUploadStats = m_uploadStats;
+    m_uploadStats.reset();
 }
 
 void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
@@ -488,6 +639,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
     // Get the optimization flag
     const bool optimizationDefault =
             !m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+    const bool optimizationInstanced = isInstancingActive();
+    if (optimizationInstanced)
+        updateInstanceBuffers();
 
     const Q3DCamera *activeCamera = m_cachedScene->activeCamera();
 
@@ -516,6 +670,14 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
     QMatrix4x4 viewMatrix = activeCamera->d_ptr->viewMatrix();
     QMatrix4x4 projectionViewMatrix = projectionMatrix * viewMatrix;
 
+    // The projected size of an item in pixels is its item size multiplied by lodSizeScale and
+    // divided by the clip space w of its translation
+    const float lodSizeScale = viewMatrix.column(0).toVector3D().length() * projectionMatrix(1, 1)
+            * float(m_primarySubViewport.height());
+    const QVector4D lodClipWRow = projectionViewMatrix.row(3);
+    if (!optimizationDefault || optimizationInstanced)
+        updateSeriesLodLevels(lodClipWRow.w(), lodSizeScale);
+
     // Calculate label flipping
     if (viewMatrix.row(0).x() > 0)
         m_zFlipped = false;
@@ -591,8 +753,10 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 if (baseCache->isVisible()) {
                     ScatterSeriesRenderCache *cache =
                             static_cast<ScatterSeriesRenderCache *>(baseCache);
+                    // Density volumes don't cast shadows
+                    if (cache->isDensityRendering())
+                        continue;
                     ObjectHelper *dotObj = cache->object();
-                    QQuaternion seriesRotation(cache->meshRotation());
                     const ScatterRenderItemArray &renderArray = cache->renderArray();
                     const int renderArraySize = renderArray.size();
                     bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
@@ -604,6 +768,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         m_funcs_2_1->glPointSize(itemSize * 100.0f * m_shadowQualityMultiplier);
                     }
                     QVector3D modelScaler(itemSize, itemSize, itemSize);
+                    const bool lodActive = optimizationDefault && !drawingPoints
+                            && cache->isLodEnabled();
+                    const float lodItemScale = itemSize * lodSizeScale;
 
                     if (!optimizationDefault
                             && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
@@ -611,24 +778,54 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         continue;
                     }
 
+                    if (optimizationInstanced && !drawingPoints) {
+                        ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                        if (instances->instanceCount() > 0) {
+                            QMatrix4x4 scaleMatrix;
+                            scaleMatrix.scale(modelScaler);
+                            m_instancedDepthShader->bind();
+                            m_instancedDepthShader->setUniformValue(m_instancedDepthShader->MVP(),
+                                                                    depthProjectionViewMatrix);
+                            m_instancedDepthShader->setUniformValue(m_instancedDepthShader->model(),
+                                                                    scaleMatrix);
+                            m_drawer->drawInstancedObject(m_instancedDepthShader,
+                                                          cache->seriesLodObject(), instances);
+                            m_depthShader->bind();
+                        }
+                        continue;
+                    }
+
                     int loopCount = 1;
-                    if (optimizationDefault)
+                    const QVector<int> *culledIndices = 0;
+                    if (optimizationDefault) {
+                        if (!drawingPoints)
+                            cache->updateItemMatrices(modelScaler);
                         loopCount = renderArraySize;
-                    for (int dot = 0; dot < loopCount; dot++) {
+                        ScatterSpatialIndex *spatialIndex = cullingIndex(cache);
+                        if (spatialIndex) {
+                            spatialIndex->findVisibleItems(renderArray, depthProjectionViewMatrix,
+                                                           itemSize * itemBoundingRadius, -1,
+                                                           m_culledIndices);
+                            culledIndices = &m_culledIndices;
+                            loopCount = m_culledIndices.size();
+                        }
+                    }
+                    for (int n = 0; n < loopCount; n++) {
+                        const int dot = culledIndices ? culledIndices->at(n) : n;
                         const ScatterRenderItem &item = renderArray.at(dot);
-                        if (!item.isVisible() && optimizationDefault)
+                        if (optimizationDefault
+                                && (!item.isVisible() || isProgressivelySkipped(dot))) {
                             continue;
+                        }
 
                         QMatrix4x4 modelMatrix;
                         QMatrix4x4 MVPMatrix;
 
                         if (optimizationDefault) {
-                            modelMatrix.translate(item.translation());
-                            if (!drawingPoints) {
-                                if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                                    modelMatrix.rotate(seriesRotation * item.rotation());
-                                modelMatrix.scale(modelScaler);
-                            }
+                            if (drawingPoints)
+                                modelMatrix.translate(item.translation());
+                            else
+                                modelMatrix = cache->itemModelMatrix(dot);
                         }
 
                         MVPMatrix = depthProjectionViewMatrix * modelMatrix;
@@ -642,17 +839,23 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                                 m_drawer->drawPoints(m_depthShader, cache->bufferPoints(), 0);
                         } else {
                             if (optimizationDefault) {
+                                // Point level items cast shadows with the low detail mesh
+                                ObjectHelper *itemObj = dotObj;
+                                if (lodActive)
+                                    itemObj = cache->lodObject(itemLodLevel(cache, item, lodClipWRow,
+                                                                            lodItemScale));
+
                                 // 1st attribute buffer : vertices
                                 glEnableVertexAttribArray(m_depthShader->posAtt());
-                                glBindBuffer(GL_ARRAY_BUFFER, dotObj->vertexBuf());
+                                glBindBuffer(GL_ARRAY_BUFFER, itemObj->vertexBuf());
                                 glVertexAttribPointer(m_depthShader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0,
                                                       (void *)0);
 
                                 // Index buffer
-                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, dotObj->elementBuf());
+                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, itemObj->elementBuf());
 
                                 // Draw the triangles
-                                glDrawElements(GL_TRIANGLES, dotObj->indexCount(),
+                                glDrawElements(GL_TRIANGLES, itemObj->indexCount(),
                                                GL_UNSIGNED_INT, (void *)0);
 
                                 // Free buffers
@@ -740,6 +943,11 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
             if (baseCache->isVisible()) {
                 ScatterSeriesRenderCache *cache =
                         static_cast<ScatterSeriesRenderCache *>(baseCache);
+                // Density volumes are not selectable, so they take no selection indices
+                if (cache->isDensityRendering()) {
+                    cache->setSelectionIndexOffset(totalIndex);
+                    continue;
+                }
                 ObjectHelper *dotObj = cache->object();
                 QQuaternion seriesRotation(cache->meshRotation());
                 const ScatterRenderItemArray &renderArray = cache->renderArray();
@@ -753,6 +961,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
 #endif
                 QVector3D modelScaler(itemSize, itemSize, itemSize);
+                const bool lodActive = !drawingPoints && cache->isLodEnabled();
+                const float lodItemScale = itemSize * lodSizeScale;
 
                 // Rebind selection shader if it has changed
                 if (!totalIndex || drawingPoints != previousDrawingPoints) {
@@ -764,13 +974,25 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
 
                     selectionShader->bind();
                 }
-                cache->setSelectionIndexOffset(totalIndex);
-                for (int dot = 0; dot < renderArraySize; dot++) {
+                const int selectionIndexOffset = totalIndex;
+                cache->setSelectionIndexOffset(selectionIndexOffset);
+                totalIndex += renderArraySize;
+
+                int loopCount = renderArraySize;
+                const QVector<int> *culledIndices = 0;
+                ScatterSpatialIndex *spatialIndex = cullingIndex(cache);
+                if (spatialIndex) {
+                    spatialIndex->findVisibleItems(renderArray, projectionViewMatrix,
+                                                   itemSize * itemBoundingRadius, -1,
+                                                   m_culledIndices);
+                    culledIndices = &m_culledIndices;
+                    loopCount = m_culledIndices.size();
+                }
+                for (int n = 0; n < loopCount; n++) {
+                    const int dot = culledIndices ? culledIndices->at(n) : n;
                     const ScatterRenderItem &item = renderArray.at(dot);
-                    if (!item.isVisible()) {
-                        totalIndex++;
+                    if (!item.isVisible())
                         continue;
-                    }
 
                     QMatrix4x4 modelMatrix;
                     QMatrix4x4 MVPMatrix;
@@ -784,16 +1006,22 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
 
                     MVPMatrix = projectionViewMatrix * modelMatrix;
 
-                    QVector4D dotColor = indexToSelectionColor(totalIndex++);
+                    QVector4D dotColor = indexToSelectionColor(selectionIndexOffset + dot);
                     dotColor /= 255.0f;
 
                     selectionShader->setUniformValue(selectionShader->MVP(), MVPMatrix);
                     selectionShader->setUniformValue(selectionShader->color(), dotColor);
 
-                    if (drawingPoints)
+                    if (drawingPoints) {
                         m_drawer->drawPoint(selectionShader);
-                    else
+                    } else if (lodActive) {
+                        m_drawer->drawSelectionObject(
+                                    selectionShader,
+                                    cache->lodObject(itemLodLevel(cache, item, lodClipWRow,
+                                                                  lodItemScale)));
+                    } else {
                         m_drawer->drawSelectionObject(selectionShader, dotObj);
+                    }
                 }
             }
         }
@@ -866,6 +1094,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         if (baseCache->isVisible()) {
             ScatterSeriesRenderCache *cache =
                     static_cast<ScatterSeriesRenderCache *>(baseCache);
+            // Density volumes are drawn after the other transparent content
+            if (cache->isDensityRendering())
+                continue;
             ObjectHelper *dotObj = cache->object();
             QQuaternion seriesRotation(cache->meshRotation());
             ScatterRenderItemArray &renderArray = cache->renderArray();
@@ -886,8 +1117,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
 #endif
             QVector3D modelScaler(itemSize, itemSize, itemSize);
-            int gradientImageHeight = cache->gradientImage().height();
-            int maxGradientPositition = gradientImageHeight - 1;
+            const bool lodActive = optimizationDefault && !drawingPoints && cache->isLodEnabled();
+            const float lodItemScale = itemSize * lodSizeScale;
 
             if (!optimizationDefault
                     && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
@@ -900,17 +1131,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     || (!drawingPoints &&
                         (colorStyleIsUniform != (previousMeshColorStyle
                                                  == Q3DTheme::ColorStyleUniform)))
-                    || (!optimizationDefault && drawingPoints)) {
+                    || drawingPoints) {
                 previousDrawingPoints = drawingPoints;
                 if (drawingPoints) {
-                    if (!optimizationDefault && rangeGradientPoints) {
-                        if (m_isOpenGLES)
-                            dotShader = m_staticGradientPointShader;
-                        else
-                            dotShader = m_labelShader;
-                    } else {
+                    if (rangeGradientPoints)
+                        dotShader = m_pointGradientShader;
+                    else
                         dotShader = pointSelectionShader;
-                    }
                 } else {
                     if (colorStyleIsUniform)
                         dotShader = m_dotShader;
@@ -920,7 +1147,25 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 dotShader->bind();
             }
 
-            if (!drawingPoints && !colorStyleIsUniform && previousMeshColorStyle != colorStyle) {
+            if (rangeGradientPoints) {
+                // Gradient positions are resolved in the shader from the point Y-coordinate
+                gradientTexture = cache->baseGradientTexture();
+                dotShader->setUniformValue(dotShader->gradientMin(), 0.5f);
+                dotShader->setUniformValue(dotShader->gradientHeight(), rangeGradientYScaler);
+            } else if (!drawingPoints && !colorStyleIsUniform && !optimizationDefault) {
+                // Static gradient coordinates are resolved in the shader from the mesh
+                // Y-coordinate or the item Y-coordinate, depending on the color style
+                if (colorStyle == Q3DTheme::ColorStyleObjectGradient) {
+                    dotShader->setUniformValue(dotShader->gradientMin(), 0.0f);
+                    dotShader->setUniformValue(dotShader->gradientHeight(), 0.5f);
+                } else {
+                    dotShader->setUniformValue(dotShader->gradientMin(),
+                                               0.5f - rangeGradientYScaler);
+                    dotShader->setUniformValue(dotShader->gradientHeight(),
+                                               rangeGradientYScaler);
+                }
+            } else if (!drawingPoints && !colorStyleIsUniform
+                       && previousMeshColorStyle != colorStyle) {
                 if (colorStyle == Q3DTheme::ColorStyleObjectGradient) {
                     dotShader->setUniformValue(dotShader->gradientMin(), 0.0f);
                     dotShader->setUniformValue(dotShader->gradientHeight(),
@@ -939,29 +1184,145 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 baseColor = cache->baseColor();
                 dotColor = baseColor;
             }
+            int firstIndex = 0;
             int loopCount = 1;
             if (optimizationDefault)
                 loopCount = renderArraySize;
 
-            for (int i = 0; i < loopCount; i++) {
+            const bool drawInstanced = optimizationInstanced && !drawingPoints;
+            if (drawInstanced) {
+                ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                if (instances->instanceCount() > 0) {
+                    ShaderHelper *instancedShader = colorStyleIsUniform
+                            ? m_instancedDotShader : m_instancedDotGradientShader;
+                    QMatrix4x4 scaleMatrix;
+                    scaleMatrix.scale(modelScaler);
+
+                    instancedShader->bind();
+                    instancedShader->setUniformValue(instancedShader->lightP(), lightPos);
+                    instancedShader->setUniformValue(instancedShader->view(), viewMatrix);
+                    instancedShader->setUniformValue(instancedShader->ambientS(),
+                                                     m_cachedTheme->ambientLightStrength());
+                    instancedShader->setUniformValue(instancedShader->lightColor(), lightColor);
+                    instancedShader->setUniformValue(instancedShader->model(), scaleMatrix);
+                    instancedShader->setUniformValue(instancedShader->nModel(),
+                                                     scaleMatrix.inverted().transposed());
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                    instancedShader->setUniformValue(instancedShader->MVP(),
+                                                     depthProjectionViewMatrix);
+#else
+                    instancedShader->setUniformValue(instancedShader->MVP(), projectionViewMatrix);
+#endif
+                    if (useColor) {
+                        instancedShader->setUniformValue(instancedShader->color(), baseColor);
+                    } else {
+                        // Range gradient positions are resolved from the item y stored per
+                        // instance
+                        gradientTexture = cache->baseGradientTexture();
+                        if (colorStyle == Q3DTheme::ColorStyleObjectGradient) {
+                            instancedShader->setUniformValue(instancedShader->gradientMin(),
+                                                             0.0f);
+                            instancedShader->setUniformValue(instancedShader->gradientHeight(),
+                                                             0.5f);
+                        } else {
+                            instancedShader->setUniformValue(instancedShader->gradientMin(),
+                                                             0.5f - rangeGradientYScaler);
+                            instancedShader->setUniformValue(instancedShader->gradientHeight(),
+                                                             rangeGradientYScaler);
+                        }
+                    }
+
+                    if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone
+                            && !m_isOpenGLES) {
+                        instancedShader->setUniformValue(instancedShader->shadowQ(),
+                                                         m_shadowQualityToShader);
+                        instancedShader->setUniformValue(instancedShader->depth(),
+                                                         depthProjectionViewMatrix);
+                        instancedShader->setUniformValue(instancedShader->lightS(),
+                                                         m_cachedTheme->lightStrength() / 10.0f);
+                        m_drawer->drawInstancedObject(instancedShader, cache->seriesLodObject(),
+                                                      instances, useColor ? 0 : gradientTexture,
+                                                      m_depthTexture);
+                    } else {
+                        instancedShader->setUniformValue(instancedShader->lightS(),
+                                                         m_cachedTheme->lightStrength());
+                        m_drawer->drawInstancedObject(instancedShader, cache->seriesLodObject(),
+                                                      instances, useColor ? 0 : gradientTexture);
+                    }
+                    dotShader->bind();
+                }
+
+                // Only the selected item is drawn separately, on top of its instance
+                if (selectedSeries
+                        && m_selectedItemIndex != Scatter3DController::invalidSelectionIndex()) {
+                    firstIndex = m_selectedItemIndex;
+                    loopCount = m_selectedItemIndex + 1;
+                    glEnable(GL_POLYGON_OFFSET_FILL);
+                    glPolygonOffset(-1.0f, 1.0f);
+                } else {
+                    loopCount = 0;
+                }
+            }
+
+            // The selected item is always collected, as the selection label is positioned on it
+            const QVector<int> *culledIndices = 0;
+            if (optimizationDefault && !drawInstanced) {
+                if (!drawingPoints)
+                    cache->updateItemMatrices(modelScaler);
+                ScatterSpatialIndex *spatialIndex = cullingIndex(cache);
+                if (spatialIndex) {
+                    spatialIndex->findVisibleItems(renderArray, projectionViewMatrix,
+                                                   itemSize * itemBoundingRadius,
+                                                   selectedSeries ? m_selectedItemIndex : -1,
+                                                   m_culledIndices);
+                    culledIndices = &m_culledIndices;
+                    loopCount = m_culledIndices.size();
+                }
+            }
+
+            for (int n = firstIndex; n < loopCount; n++) {
+                const int i = culledIndices ? culledIndices->at(n) : n;
                 ScatterRenderItem &item = renderArray[i];
                 if (!item.isVisible() && optimizationDefault)
                     continue;
 
+                // Progressive frames draw only a subset of the items, but always the selected one
+                if (optimizationDefault && isProgressivelySkipped(i)
+                        && !(selectedSeries && m_selectedItemIndex == i)) {
+                    continue;
+                }
+
+                // The selected range gradient point is drawn with the highlight color below
+                if (optimizationDefault && rangeGradientPoints && selectedSeries
+                        && m_selectedItemIndex == i) {
+                    continue;
+                }
+
+                // The selected item is always drawn with the full mesh
+                ObjectHelper *itemObj = dotObj;
+                if (lodActive && !(selectedSeries && m_selectedItemIndex == i)) {
+                    ScatterSeriesRenderCache::LodLevel level =
+                            itemLodLevel(cache, item, lodClipWRow, lodItemScale);
+                    if (level == ScatterSeriesRenderCache::LodPoint && !m_isOpenGLES) {
+                        m_lodPointIndices.append(i);
+                        continue;
+                    }
+                    itemObj = cache->lodObject(level);
+                }
+
                 QMatrix4x4 modelMatrix;
                 QMatrix4x4 MVPMatrix;
-                QMatrix4x4 itModelMatrix;
+                QMatrix4x4 normalMatrix;
 
                 if (optimizationDefault) {
-                    modelMatrix.translate(item.translation());
-                    if (!drawingPoints) {
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
-                            QQuaternion totalRotation = seriesRotation * item.rotation();
-                            modelMatrix.rotate(totalRotation);
-                            itModelMatrix.rotate(totalRotation);
-                        }
-                        modelMatrix.scale(modelScaler);
-                        itModelMatrix.scale(modelScaler);
+                    if (drawingPoints) {
+                        modelMatrix.translate(item.translation());
+                    } else if (drawInstanced) {
+                        // Only the selected item is drawn one by one
+                        cache->calculateItemMatrices(item, modelScaler, modelMatrix, normalMatrix);
+                    } else {
+                        modelMatrix = cache->itemModelMatrix(i);
+                        normalMatrix = cache->itemNormalMatrix(i);
                     }
                 }
 #ifdef SHOW_DEPTH_TEXTURE_SCENE
@@ -970,22 +1331,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 MVPMatrix = projectionViewMatrix * modelMatrix;
 #endif
 
-                if (useColor) {
-                    if (rangeGradientPoints) {
-                        // Drawing points with range gradient
-                        // Get color from gradient based on items y position converted to percent
-                        int position = ((item.translation().y() + m_scaleY) * rangeGradientYScaler) * gradientImageHeight;
-                        position = qMin(maxGradientPositition, position); // clamp to edge
-                        dotColor = Utils::vectorFromColor(
-                                    cache->gradientImage().pixel(0, position));
-                    } else {
-                        dotColor = baseColor;
-                    }
-                } else {
-                    gradientTexture = cache->baseGradientTexture();
-                }
-
-                if (!optimizationDefault && rangeGradientPoints)
+                if (useColor)
+                    dotColor = baseColor;
+                else
                     gradientTexture = cache->baseGradientTexture();
 
                 GLfloat lightStrength = m_cachedTheme->lightStrength();
@@ -1006,14 +1354,16 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 if (!drawingPoints) {
                     // Set shader bindings
                     dotShader->setUniformValue(dotShader->model(), modelMatrix);
-                    dotShader->setUniformValue(dotShader->nModel(),
-                                               itModelMatrix.inverted().transposed());
+                    dotShader->setUniformValue(dotShader->nModel(), normalMatrix);
                 }
 
                 dotShader->setUniformValue(dotShader->MVP(), MVPMatrix);
-                if (useColor) {
+                if (rangeGradientPoints) {
+                    dotShader->setUniformValue(dotShader->model(), modelMatrix);
+                } else if (useColor) {
                     dotShader->setUniformValue(dotShader->color(), dotColor);
-                } else if (colorStyle == Q3DTheme::ColorStyleRangeGradient) {
+                } else if (optimizationDefault
+                           && colorStyle == Q3DTheme::ColorStyleRangeGradient) {
                     dotShader->setUniformValue(dotShader->gradientMin(),
                                                (item.translation().y() + m_scaleY)
                                                * rangeGradientYScaler);
@@ -1028,7 +1378,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
 
                         // Draw the object
                         if (optimizationDefault) {
-                            m_drawer->drawObject(dotShader, dotObj, gradientTexture,
+                            m_drawer->drawObject(dotShader, itemObj, gradientTexture,
                                                  m_depthTexture);
                         } else {
                             m_drawer->drawObject(dotShader, cache->bufferObject(), gradientTexture,
@@ -1036,10 +1386,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         }
                     } else {
                         // Draw the object
-                        if (optimizationDefault)
-                            m_drawer->drawPoint(dotShader);
-                        else
-                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture);
+                        if (optimizationDefault) {
+                            m_drawer->drawPoint(dotShader,
+                                                rangeGradientPoints ? gradientTexture : 0);
+                        } else {
+                            m_drawer->drawPoints(dotShader, cache->bufferPoints(),
+                                                 rangeGradientPoints ? gradientTexture : 0);
+                        }
                     }
                 } else {
                     if (!drawingPoints) {
@@ -1047,22 +1400,33 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         dotShader->setUniformValue(dotShader->lightS(), lightStrength);
                         // Draw the object
                         if (optimizationDefault)
-                            m_drawer->drawObject(dotShader, dotObj, gradientTexture);
+                            m_drawer->drawObject(dotShader, itemObj, gradientTexture);
                         else
                             m_drawer->drawObject(dotShader, cache->bufferObject(), gradientTexture);
                     } else {
                         // Draw the object
-                        if (optimizationDefault)
-                            m_drawer->drawPoint(dotShader);
-                        else
-                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture);
+                        if (optimizationDefault) {
+                            m_drawer->drawPoint(dotShader,
+                                                rangeGradientPoints ? gradientTexture : 0);
+                        } else {
+                            m_drawer->drawPoints(dotShader, cache->bufferPoints(),
+                                                 rangeGradientPoints ? gradientTexture : 0);
+                        }
                     }
                 }
             }
 
+            if (drawInstanced && loopCount)
+                glDisable(GL_POLYGON_OFFSET_FILL);
 
-            // Draw the selected item on static optimization
-            if (!optimizationDefault && selectedSeries
+            if (!m_lodPointIndices.isEmpty()) {
+                drawLodPoints(cache, projectionViewMatrix, lodClipWRow, lodItemScale);
+                m_lodPointIndices.clear();
+                dotShader->bind();
+            }
+
+            // Draw the selected item on static optimization and the selected range gradient point
+            if ((!optimizationDefault || rangeGradientPoints) && selectedSeries
                     && m_selectedItemIndex != Scatter3DController::invalidSelectionIndex()) {
                 ScatterRenderItem &item = renderArray[m_selectedItemIndex];
                 if (item.isVisible()) {
@@ -1607,6 +1971,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                                         projectionViewMatrix, depthProjectionViewMatrix,
                                         m_depthTexture, m_shadowQualityToShader);
 
+    drawDensityVolumes(activeCamera, projectionViewMatrix);
+
     drawLabels(false, activeCamera, viewMatrix, projectionMatrix);
 
     // Handle selection clearing and selection label drawing
@@ -2153,7 +2519,8 @@ void Scatter3DRenderer::updateSelectedItem(int index, QScatter3DSeries *series)
 
     if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
             && m_oldSelectedSeriesCache
-            && m_oldSelectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint) {
+            && m_oldSelectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint
+            && m_oldSelectedSeriesCache->bufferPoints()) {
         m_oldSelectedSeriesCache->bufferPoints()->popPoint();
         m_oldSelectedSeriesCache = 0;
     }
@@ -2164,7 +2531,8 @@ void Scatter3DRenderer::updateSelectedItem(int index, QScatter3DSeries *series)
             m_selectedItemIndex = index;
 
             if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
-                    && m_selectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint) {
+                    && m_selectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint
+                    && m_selectedSeriesCache->bufferPoints()) {
                 m_selectedSeriesCache->bufferPoints()->pushPoint(m_selectedItemIndex);
                 m_oldSelectedSeriesCache = m_selectedSeriesCache;
             }
@@ -2207,6 +2575,7 @@ void Scatter3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality qual
     }
 
     handleShadowQualityChange();
+    initInstancedShaders();
 
     // Re-init depth buffer
     updateDepthBuffer();
@@ -2240,10 +2609,9 @@ void Scatter3DRenderer::fixMeshFileName(QString &fileName, QAbstract3DSeries::Me
     }
 }
 
-void Scatter3DRenderer::calculateTranslation(ScatterRenderItem &item)
+void Scatter3DRenderer::calculateTranslation(const QVector3D &pos, ScatterRenderItem &item)
 {
     // We need to normalize translations
-    const QVector3D &pos = item.position();
     float xTrans;
     float yTrans = m_axisCacheY.positionAt(pos.y());
     float zTrans;
@@ -2418,13 +2786,290 @@ void Scatter3DRenderer::initBackgroundShaders(const QString &vertexShader,
     m_backgroundShader->initialize();
 }
 
-void Scatter3DRenderer::initStaticPointShaders(const QString &vertexShader,
-                                               const QString &fragmentShader)
+void Scatter3DRenderer::initPointGradientShader()
+{
+    if (m_pointGradientShader)
+        delete m_pointGradientShader;
+    if (m_isOpenGLES) {
+        m_pointGradientShader = new ShaderHelper(this,
+                                                 QStringLiteral(":/shaders/vertexPointColorOnYES2"),
+                                                 QStringLiteral(":/shaders/fragmentLabel"));
+    } else {
+        m_pointGradientShader = new ShaderHelper(this,
+                                                 QStringLiteral(":/shaders/vertexPointColorOnY"),
+                                                 QStringLiteral(":/shaders/fragmentLabel"));
+    }
+    m_pointGradientShader->initialize();
+}
+
+void Scatter3DRenderer::initInstancedShaders()
+{
+    delete m_instancedDotShader;
+    delete m_instancedDotGradientShader;
+    delete m_instancedDepthShader;
+    m_instancedDotShader = 0;
+    m_instancedDotGradientShader = 0;
+    m_instancedDepthShader = 0;
+
+    if (!isInstancingActive())
+        return;
+
+    QString vertexShader;
+    QString fragmentShader;
+    QString gradientFragmentShader;
+    if (m_isOpenGLES) {
+        vertexShader = QStringLiteral(":/shaders/vertexInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragmentES2");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentColorOnYES2");
+    } else if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+        vertexShader = QStringLiteral(":/shaders/vertexShadowInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragmentShadowNoTex");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentShadowNoTexColorOnY");
+    } else {
+        vertexShader = QStringLiteral(":/shaders/vertexInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragment");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentColorOnY");
+    }
+
+    m_instancedDotShader = new ShaderHelper(this, vertexShader, fragmentShader);
+    m_instancedDotShader->initialize();
+    m_instancedDotGradientShader = new ShaderHelper(this, vertexShader, gradientFragmentShader);
+    m_instancedDotGradientShader->initialize();
+
+    if (!m_isOpenGLES) {
+        m_instancedDepthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexDepthInstanced"),
+                                                  QStringLiteral(":/shaders/fragmentDepth"));
+        m_instancedDepthShader->initialize();
+    }
+}
+
+void Scatter3DRenderer::updateInstanceBuffers()
+{
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (cache->isVisible() && cache->mesh() != QAbstract3DSeries::MeshPoint
+                && !cache->isDensityRendering()) {
+            ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+            if (!instances) {
+                instances = new ScatterInstanceBufferHelper();
+                instances->setUploadStats(&m_uploadStats);
+                cache->setBufferInstances(instances);
+                cache->setInstanceBufferDirty(true);
+            }
+            if (cache->instanceBufferDirty()) {
+                instances->fullLoad(cache);
+                cache->setInstanceBufferDirty(false);
+            }
+        }
+    }
+}
+
+// Large series are culled against the view frustum with a spatial index. Items outside the
+// axis ranges are not visible, so they are never in the index.
+ScatterSpatialIndex *Scatter3DRenderer::cullingIndex(ScatterSeriesRenderCache *cache)
 {
-    if (m_staticGradientPointShader)
-        delete m_staticGradientPointShader;
-    m_staticGradientPointShader = new ShaderHelper(this, vertexShader, fragmentShader);
-    m_staticGradientPointShader->initialize();
+    if (cache->renderArray().size() < minSpatialIndexItems)
+        return 0;
+
+    ScatterSpatialIndex *spatialIndex = cache->spatialIndex();
+    if (!spatialIndex) {
+        spatialIndex = new ScatterSpatialIndex();
+        cache->setSpatialIndex(spatialIndex);
+    }
+    if (spatialIndex->isDirty())
+        spatialIndex->build(cache->renderArray());
+    return spatialIndex;
+}
+
+// The density grid is rebuilt when the data, the resolution, or the graph area changes.
+// Otherwise it is kept up to date by the item changes.
+ScatterDensityGrid *Scatter3DRenderer::densityGrid(ScatterSeriesRenderCache *cache)
+{
+    ScatterDensityGrid *grid = cache->densityGrid();
+    if (!grid) {
+        grid = new ScatterDensityGrid();
+        cache->setDensityGrid(grid);
+    }
+    const QVector3D scale(m_scaleX, m_scaleY, m_scaleZ);
+    if (grid->isDirty() || grid->resolution() != cache->densityResolution()
+            || grid->scale() != scale) {
+        grid->build(cache->renderArray(), cache->densityResolution(), scale);
+    }
+    return grid;
+}
+
+void Scatter3DRenderer::drawDensityVolumes(const Q3DCamera *activeCamera,
+                                           const QMatrix4x4 &projectionViewMatrix)
+{
+#if !defined(QT_OPENGL_ES_2)
+    if (m_isOpenGLES)
+        return;
+
+    ShaderHelper *shader = m_volumeTextureLowDefShader;
+    bool shaderBound = false;
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (!cache->isVisible() || !cache->isDensityRendering())
+            continue;
+
+        ScatterDensityGrid *grid = densityGrid(cache);
+        GLuint &texture = cache->densityTexture();
+        const int resolution = grid->resolution();
+        if (grid->isTextureDirty() || !texture) {
+            grid->textureData(m_densityTextureData);
+            m_textureHelper->deleteTexture(&texture);
+            texture = m_textureHelper->create3DTexture(&m_densityTextureData, resolution,
+                                                       resolution, resolution,
+                                                       QImage::Format_Indexed8);
+        }
+        if (!texture)
+            continue;
+
+        if (!shaderBound) {
+            if (!m_densityVolumeObj) {
+                ObjectHelper::resetObjectHelper(this, m_densityVolumeObj,
+                                                QStringLiteral(":/defaultMeshes/barFull"));
+            }
+            shader->bind();
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            shaderBound = true;
+        }
+
+        // The volume fills the whole graph area
+        QMatrix4x4 modelMatrix;
+        modelMatrix.scale(QVector3D(m_scaleX, m_scaleY, m_scaleZ));
+        QMatrix4x4 MVPMatrix = projectionViewMatrix * modelMatrix;
+        QVector3D cameraPos = MVPMatrix.inverted().map(activeCamera->position());
+
+        // Worst case sample count, every other sample dropped like for custom volumes
+        int sampleCount = resolution;
+        if (sampleCount > 256)
+            sampleCount /= 2;
+        const float textureStep = 1.0f / float(resolution);
+
+        shader->setUniformValue(shader->model(), modelMatrix);
+        shader->setUniformValue(shader->MVP(), MVPMatrix);
+        shader->setUniformValue(shader->cameraPositionRelativeToModel(), -cameraPos);
+        shader->setUniformValueArray(shader->colorIndex(),
+                                     cache->densityColorTable().constData(), 256);
+        shader->setUniformValue(shader->color8Bit(), 1);
+        shader->setUniformValue(shader->alphaMultiplier(), 1.0f);
+        shader->setUniformValue(shader->preserveOpacity(), 0);
+        shader->setUniformValue(shader->minBounds(), QVector3D(-1.0f, 1.0f, 1.0f));
+        shader->setUniformValue(shader->maxBounds(), QVector3D(1.0f, -1.0f, -1.0f));
+        shader->setUniformValue(shader->textureDimensions(),
+                                QVector3D(textureStep, textureStep, textureStep));
+        shader->setUniformValue(shader->sampleCount(), sampleCount);
+
+        m_drawer->drawObject(shader, m_densityVolumeObj, 0, 0, texture);
+    }
+
+    if (shaderBound)
+        glDisable(GL_BLEND);
+#else
+    Q_UNUSED(activeCamera)
+    Q_UNUSED(projectionViewMatrix)
+#endif
+}
+
+// Static and instanced buffers use a single level of detail for the whole series, selected by
+// the projected item size at the center of the graph. Points cannot be mixed into the buffers,
+// so the lowest level is the low detail mesh.
+void Scatter3DRenderer::updateSeriesLodLevels(float centerClipW, float lodSizeScale)
+{
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (!cache->isVisible() || cache->mesh() == QAbstract3DSeries::MeshPoint)
+            continue;
+
+        ScatterSeriesRenderCache::LodLevel level = ScatterSeriesRenderCache::LodFull;
+        if (cache->isLodEnabled() && centerClipW > 0.0f) {
+            float itemSize = cache->itemSize() / itemScaler;
+            if (itemSize == 0.0f)
+                itemSize = m_dotSizeScale;
+            level = cache->lodLevel(itemSize * lodSizeScale / centerClipW);
+            if (level == ScatterSeriesRenderCache::LodPoint)
+                level = ScatterSeriesRenderCache::LodLow;
+        }
+
+        if (level != cache->seriesLodLevel()) {
+            cache->setSeriesLodLevel(level);
+            ScatterObjectBufferHelper *object = cache->bufferObject();
+            if (optimizationStatic && object) {
+                object->fullLoad(cache, m_dotSizeScale);
+                cache->setOldMeshFileName(cache->seriesLodObject()->objectFile());
+            }
+        }
+    }
+}
+
+// Draws the items collected to m_lodPointIndices as points sized to their projected size
+void Scatter3DRenderer::drawLodPoints(ScatterSeriesRenderCache *cache,
+                                      const QMatrix4x4 &projectionViewMatrix,
+                                      const QVector4D &clipWRow, float itemSizeScale)
+{
+#if !defined(QT_OPENGL_ES_2)
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+    ShaderHelper *pointShader = rangeGradient ? m_pointGradientShader : m_selectionShader;
+    GLuint gradientTexture = 0;
+
+    pointShader->bind();
+    if (rangeGradient) {
+        // Gradient positions are resolved in the shader from the point Y-coordinate
+        gradientTexture = cache->baseGradientTexture();
+        pointShader->setUniformValue(pointShader->gradientMin(), 0.5f);
+        pointShader->setUniformValue(pointShader->gradientHeight(), 0.5f / m_scaleY);
+    } else {
+        QVector4D pointColor = cache->baseColor();
+        if (cache->colorStyle() == Q3DTheme::ColorStyleObjectGradient) {
+            // Use the color at the middle of the item
+            const QImage &gradientImage = cache->gradientImage();
+            pointColor = Utils::vectorFromColor(gradientImage.pixel(0,
+                                                                    gradientImage.height() / 2));
+        }
+        pointShader->setUniformValue(pointShader->color(), pointColor);
+    }
+    glEnable(GL_POINT_SMOOTH);
+
+    foreach (int index, m_lodPointIndices) {
+        const ScatterRenderItem &item = renderArray.at(index);
+        const float clipW = QVector4D::dotProduct(clipWRow,
+                                                  QVector4D(item.translation(), 1.0f));
+        if (clipW <= 0.0f)
+            continue;
+
+        QMatrix4x4 modelMatrix;
+        modelMatrix.translate(item.translation());
+
+        m_funcs_2_1->glPointSize(qMax(1.0f, itemSizeScale / clipW));
+        pointShader->setUniformValue(pointShader->MVP(), projectionViewMatrix * modelMatrix);
+        if (rangeGradient)
+            pointShader->setUniformValue(pointShader->model(), modelMatrix);
+        m_drawer->drawPoint(pointShader, gradientTexture);
+    }
+
+    if (!m_havePointSeries)
+        glDisable(GL_POINT_SMOOTH);
+#else
+    Q_UNUSED(cache)
+    Q_UNUSED(projectionViewMatrix)
+    Q_UNUSED(clipWRow)
+    Q_UNUSED(itemSizeScale)
+#endif
+}
+
+bool Scatter3DRenderer::isInstancingActive() const
+{
+    // Static optimization takes precedence, as it already draws each series with one call
+    return m_instancingSupported
+            && m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationInstanced)
+            && !m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
 }
 
 void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
@@ -2466,6 +3111,8 @@ void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
                 if (baseCache->isVisible()) {
                     ScatterSeriesRenderCache *cache =
                             static_cast<ScatterSeriesRenderCache *>(baseCache);
+                    if (cache->isDensityRendering())
+                        continue;
                     int offset = cache->selectionIndexOffset();
                     if (totalIndex >= offset
                             && totalIndex < (offset + cache->renderArray().size())) {
@@ -2484,20 +3131,18 @@ void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
     series = 0;
 }
 
-void Scatter3DRenderer::updateRenderItem(const QScatterDataItem &dataItem,
+void Scatter3DRenderer::updateRenderItem(const QVector3D &dotPos, const QQuaternion &rotation,
                                          ScatterRenderItem &renderItem)
 {
-    QVector3D dotPos = dataItem.position();
     if ((dotPos.x() >= m_axisCacheX.min() && dotPos.x() <= m_axisCacheX.max() )
             && (dotPos.y() >= m_axisCacheY.min() && dotPos.y() <= m_axisCacheY.max())
             && (dotPos.z() >= m_axisCacheZ.min() && dotPos.z() <= m_axisCacheZ.max())) {
-        renderItem.setPosition(dotPos);
         renderItem.setVisible(true);
-        if (!dataItem.rotation().isIdentity())
-            renderItem.setRotation(dataItem.rotation().normalized());
+        if (!rotation.isIdentity())
+            renderItem.setRotation(rotation.normalized());
         else
             renderItem.setRotation(identityQuaternion);
-        calculateTranslation(renderItem);
+        calculateTranslation(dotPos, renderItem);
     } else {
         renderItem.setVisible(false);
     }
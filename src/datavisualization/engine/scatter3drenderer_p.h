@@ -44,6 +44,7 @@
 #include "scatter3dcontroller_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterrenderitem_p.h"
+#include "bufferuploadhelper_p.h"
 
 QT_FORWARD_DECLARE_CLASS(QSizeF)
 
@@ -52,7 +53,8 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 class ShaderHelper;
 class Q3DScene;
 class ScatterSeriesRenderCache;
-class QScatterDataItem;
+class ScatterSpatialIndex;
+class ScatterDensityGrid;
 
 class QT_DATAVISUALIZATION_EXPORT Scatter3DRenderer : public Abstract3DRenderer
 {
@@ -70,7 +72,10 @@ private:
     ShaderHelper *m_depthShader;
     ShaderHelper *m_selectionShader;
     ShaderHelper *m_backgroundShader;
-    ShaderHelper *m_staticGradientPointShader;
+    ShaderHelper *m_pointGradientShader;
+    ShaderHelper *m_instancedDotShader;
+    ShaderHelper *m_instancedDotGradientShader;
+    ShaderHelper *m_instancedDepthShader;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
     GLuint m_depthFrameBuffer;
@@ -92,6 +97,14 @@ private:
     bool m_haveMeshSeries;
     bool m_haveUniformColorMeshSeries;
     bool m_haveGradientMeshSeries;
+    bool m_instancingSupported;
+    float m_fullUploadFraction;
+    BufferUploadStats m_uploadStats;
+    BufferUploadStats m_lastFrameUploadStats;
+    QVector<int> m_lodPointIndices; // Used as temporary cache while drawing
+    QVector<int> m_culledIndices; // Used as temporary cache while drawing
+    ObjectHelper *m_densityVolumeObj;
+    QVector<uchar> m_densityTextureData; // Used as temporary cache while uploading densities
 
 public:
     explicit Scatter3DRenderer(Scatter3DController *controller);
@@ -112,6 +125,12 @@ public:
     QVector3D convertPositionToTranslation(const QVector3D &position, bool isAbsolute);
 
     inline int clickedIndex() const { return m_clickedIndex; }
+
+    // Fraction of changed items above which item changes are uploaded as a whole buffer
+    inline void setFullUploadFraction(float fraction) { m_fullUploadFraction = fraction; }
+    inline float fullUploadFraction() const { return m_fullUploadFraction; }
+    // Number of buffer uploads and uploaded bytes during the last rendered frame
+    inline const BufferUploadStats &lastFrameUploadStats() const { return m_lastFrameUploadStats; }
     void resetClickedStatus();
 
     void render(GLuint defaultFboHandle);
@@ -142,19 +161,33 @@ private:
     void loadBackgroundMesh();
     void initSelectionShader();
     void initBackgroundShaders(const QString &vertexShader, const QString &fragmentShader);
-    void initStaticPointShaders(const QString &vertexShader, const QString &fragmentShader);
+    void initPointGradientShader();
+    void initInstancedShaders();
+    void loadStaticBuffers(ScatterSeriesRenderCache *cache);
+    void updateInstanceBuffers();
+    void prepareUpdateIndices(ScatterSeriesRenderCache *cache);
+    bool isInstancingActive() const;
+    void updateSeriesLodLevels(float centerClipW, float lodSizeScale);
+    ScatterSpatialIndex *cullingIndex(ScatterSeriesRenderCache *cache);
+    ScatterDensityGrid *densityGrid(ScatterSeriesRenderCache *cache);
+    void drawDensityVolumes(const Q3DCamera *activeCamera, const QMatrix4x4 &projectionViewMatrix);
+    void drawLodPoints(ScatterSeriesRenderCache *cache, const QMatrix4x4 &projectionViewMatrix,
+                       const QVector4D &clipWRow, float itemSizeScale);
     void initSelectionBuffer();
     void initDepthShader();
     void updateDepthBuffer();
     void initPointShader();
-    void calculateTranslation(ScatterRenderItem &item);
+    void calculateTranslation(const QVector3D &pos, ScatterRenderItem &item);
     void calculateSceneScalingFactors();
 
     void selectionColorToSeriesAndIndex(const QVector4D &color, int &index,
                                         QAbstract3DSeries *&series);
-    inline void updateRenderItem(const QScatterDataItem &dataItem, ScatterRenderItem &renderItem);
+    inline void updateRenderItem(const QVector3D &dotPos, const QQuaternion &rotation,
+                                 ScatterRenderItem &renderItem);
 
     Q_DISABLE_COPY(Scatter3DRenderer)
+
+    friend class ScatterRenderItemUpdateJob;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
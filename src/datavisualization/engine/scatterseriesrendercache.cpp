@@ -30,9 +30,18 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "scatterspatialindex_p.h"
+#include "scatterdensitygrid_p.h"
+#include "objecthelper_p.h"
+#include "texturehelper_p.h"
+#include "utils_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+const QString sphereString(QStringLiteral("sphere"));
+const QString lowDetailString(QStringLiteral("Low"));
+
 ScatterSeriesRenderCache::ScatterSeriesRenderCache(QAbstract3DSeries *series,
                                                    Abstract3DRenderer *renderer)
     : SeriesRenderCache(series, renderer),
@@ -43,7 +52,19 @@ ScatterSeriesRenderCache::ScatterSeriesRenderCache(QAbstract3DSeries *series,
       m_oldMeshFileName(QString()),
       m_scatterBufferObj(0),
       m_scatterBufferPoints(0),
-      m_visibilityChanged(false)
+      m_scatterBufferInstances(0),
+      m_spatialIndex(0),
+      m_instanceBufferDirty(false),
+      m_visibilityChanged(false),
+      m_lowDetailObject(0),
+      m_lodThreshold(0.0f),
+      m_lodPointThreshold(0.0f),
+      m_seriesLodLevel(LodFull),
+      m_densityRendering(false),
+      m_densityResolution(0),
+      m_densityGrid(0),
+      m_densityTexture(0),
+      m_itemMatricesDirty(true)
 {
 }
 
@@ -51,11 +72,156 @@ ScatterSeriesRenderCache::~ScatterSeriesRenderCache()
 {
     delete m_scatterBufferObj;
     delete m_scatterBufferPoints;
+    delete m_scatterBufferInstances;
+    delete m_spatialIndex;
+    delete m_densityGrid;
+}
+
+void ScatterSeriesRenderCache::populate(bool newSeries)
+{
+    SeriesRenderCache::populate(newSeries);
+
+    // Only the sphere has enough vertices to benefit from a lower detail version
+    QString lowDetailFileName;
+    if (m_mesh == QAbstract3DSeries::MeshSphere && m_object) {
+        lowDetailFileName = m_object->objectFile();
+        lowDetailFileName.insert(lowDetailFileName.lastIndexOf(QLatin1Char('/')) + 1
+                                 + sphereString.size(), lowDetailString);
+    }
+    ObjectHelper::resetObjectHelper(m_renderer, m_lowDetailObject, lowDetailFileName);
+
+    // Volume textures are not supported on OpenGL ES2, so density series are drawn as items there
+    m_densityRendering = series()->renderingMode() == QScatter3DSeries::RenderingModeDensity
+            && !Utils::isOpenGLES();
+    if (m_densityRendering) {
+        // Density series have no use for the item buffers. The static buffers are fully
+        // loaded again if the series is drawn as items later.
+        delete m_scatterBufferObj;
+        m_scatterBufferObj = 0;
+        delete m_scatterBufferPoints;
+        m_scatterBufferPoints = 0;
+        delete m_scatterBufferInstances;
+        m_scatterBufferInstances = 0;
+        m_staticBufferDirty = true;
+
+        // Indexed texture rows are padded to four bytes
+        int resolution = (series()->densityResolution() + 3) & ~3;
+        if (resolution != m_densityResolution) {
+            m_densityResolution = resolution;
+            if (m_densityGrid)
+                m_densityGrid->setDirty();
+        }
+
+        // Zero density is fully transparent, higher densities get more opaque
+        m_densityColorTable.resize(256);
+        m_densityColorTable[0] = QVector4D();
+        const int gradientHeight = m_gradientImage.height();
+        for (int i = 1; i < 256; i++) {
+            float density = float(i) / 255.0f;
+            QVector4D color;
+            if (m_colorStyle == Q3DTheme::ColorStyleUniform || !gradientHeight) {
+                color = m_baseColor;
+            } else {
+                // Densities map to gradient positions the same way as range gradient heights
+                int row = int(density * float(gradientHeight - 1));
+                color = Utils::vectorFromColor(m_gradientImage.pixel(0, row));
+            }
+            color.setW(density);
+            m_densityColorTable[i] = color;
+        }
+    } else {
+        m_densityColorTable.clear();
+        delete m_densityGrid;
+        m_densityGrid = 0;
+    }
+
+    // Points are drawn without rotation or scaling, so they don't need the matrices
+    if (m_mesh == QAbstract3DSeries::MeshPoint)
+        clearItemMatrices();
+}
+
+void ScatterSeriesRenderCache::updateItemMatrices(const QVector3D &modelScaler)
+{
+    const int itemCount = m_renderArray.size();
+    if (m_itemMatricesDirty || m_matrixSlots.size() != itemCount
+            || m_matrixScaler != modelScaler || m_matrixRotation != m_meshRotation) {
+        m_matrixScaler = modelScaler;
+        m_matrixRotation = m_meshRotation;
+
+        m_seriesModelMatrix.setToIdentity();
+        if (!m_meshRotation.isIdentity())
+            m_seriesModelMatrix.rotate(m_meshRotation);
+        m_seriesModelMatrix.scale(modelScaler);
+        m_seriesNormalMatrix = m_seriesModelMatrix.inverted().transposed();
+
+        m_matrixSlots.fill(-1, itemCount);
+        m_modelMatrices.clear();
+        m_normalMatrices.clear();
+        for (int i = 0; i < itemCount; i++)
+            updateItemMatrix(i);
+        m_itemMatricesDirty = false;
+    } else {
+        foreach (int index, m_dirtyMatrixIndices) {
+            if (index < itemCount)
+                updateItemMatrix(index);
+        }
+    }
+    m_dirtyMatrixIndices.clear();
+}
+
+void ScatterSeriesRenderCache::updateItemMatrix(int index)
+{
+    const ScatterRenderItem &item = m_renderArray.at(index);
+    int &slot = m_matrixSlots[index];
+    if (item.rotation().isIdentity()) {
+        // Matrices of items that lost their rotation are left unused until the next full update
+        slot = -1;
+    } else {
+        if (slot < 0) {
+            slot = m_modelMatrices.size();
+            m_modelMatrices.append(QMatrix4x4());
+            m_normalMatrices.append(QMatrix4x4());
+        }
+        calculateItemMatrices(item, m_matrixScaler, m_modelMatrices[slot],
+                              m_normalMatrices[slot]);
+    }
+}
+
+void ScatterSeriesRenderCache::clearItemMatrices()
+{
+    m_matrixSlots.clear();
+    m_modelMatrices.clear();
+    m_normalMatrices.clear();
+    m_dirtyMatrixIndices.clear();
+    m_itemMatricesDirty = true;
+}
+
+void ScatterSeriesRenderCache::calculateItemMatrices(const ScatterRenderItem &item,
+                                                     const QVector3D &modelScaler,
+                                                     QMatrix4x4 &modelMatrix,
+                                                     QMatrix4x4 &normalMatrix) const
+{
+    QMatrix4x4 itModelMatrix;
+
+    modelMatrix.setToIdentity();
+    modelMatrix.translate(item.translation());
+    if (!m_meshRotation.isIdentity() || !item.rotation().isIdentity()) {
+        QQuaternion totalRotation = m_meshRotation * item.rotation();
+        modelMatrix.rotate(totalRotation);
+        itModelMatrix.rotate(totalRotation);
+    }
+    modelMatrix.scale(modelScaler);
+    itModelMatrix.scale(modelScaler);
+    normalMatrix = itModelMatrix.inverted().transposed();
 }
 
 void ScatterSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     m_renderArray.clear();
+    clearItemMatrices();
+    ObjectHelper::releaseObjectHelper(m_renderer, m_lowDetailObject);
+    if (QOpenGLContext::currentContext())
+        texHelper->deleteTexture(&m_densityTexture);
 
     SeriesRenderCache::cleanup(texHelper);
 }
@@ -49,13 +49,23 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 class ScatterObjectBufferHelper;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
+class ScatterSpatialIndex;
+class ScatterDensityGrid;
 
 class ScatterSeriesRenderCache : public SeriesRenderCache
 {
 public:
+    enum LodLevel {
+        LodFull = 0,
+        LodLow,
+        LodPoint
+    };
+
     ScatterSeriesRenderCache(QAbstract3DSeries *series, Abstract3DRenderer *renderer);
     virtual ~ScatterSeriesRenderCache();
 
+    virtual void populate(bool newSeries);
     void cleanup(TextureHelper *texHelper);
 
     inline ScatterRenderItemArray &renderArray() { return m_renderArray; }
@@ -74,12 +84,88 @@ public:
     inline ScatterObjectBufferHelper *bufferObject() const { return m_scatterBufferObj; }
     inline void setBufferPoints(ScatterPointBufferHelper *object) { m_scatterBufferPoints = object; }
     inline ScatterPointBufferHelper *bufferPoints() const { return m_scatterBufferPoints; }
+    inline void setBufferInstances(ScatterInstanceBufferHelper *object) { m_scatterBufferInstances = object; }
+    inline ScatterInstanceBufferHelper *bufferInstances() const { return m_scatterBufferInstances; }
+    inline void setSpatialIndex(ScatterSpatialIndex *index) { m_spatialIndex = index; }
+    inline ScatterSpatialIndex *spatialIndex() const { return m_spatialIndex; }
+    inline void setInstanceBufferDirty(bool state) { m_instanceBufferDirty = state; }
+    inline bool instanceBufferDirty() const { return m_instanceBufferDirty; }
     inline QVector<int> &updateIndices() { return m_updateIndices; }
     inline QVector<int> &bufferIndices() { return m_bufferIndices; }
     inline void setVisibilityChanged(bool changed) { m_visibilityChanged = changed; }
     inline bool visibilityChanged() const { return m_visibilityChanged; }
+    inline void setLodThresholds(float lodThreshold, float lodPointThreshold)
+    {
+        m_lodThreshold = lodThreshold;
+        m_lodPointThreshold = lodPointThreshold;
+    }
+    inline bool isLodEnabled() const { return m_lodThreshold > 0.0f || m_lodPointThreshold > 0.0f; }
+    inline LodLevel lodLevel(float projectedSize) const
+    {
+        if (projectedSize < m_lodPointThreshold)
+            return LodPoint;
+        if (projectedSize < m_lodThreshold)
+            return LodLow;
+        return LodFull;
+    }
+    // Point level items use the low detail mesh where points cannot be drawn
+    inline ObjectHelper *lodObject(LodLevel level) const
+    {
+        return (level == LodFull || !m_lowDetailObject) ? m_object : m_lowDetailObject;
+    }
+    inline void setSeriesLodLevel(LodLevel level) { m_seriesLodLevel = level; }
+    inline LodLevel seriesLodLevel() const { return m_seriesLodLevel; }
+    inline ObjectHelper *seriesLodObject() const { return lodObject(m_seriesLodLevel); }
+    inline bool isDensityRendering() const { return m_densityRendering; }
+    inline int densityResolution() const { return m_densityResolution; }
+    inline const QVector<QVector4D> &densityColorTable() const { return m_densityColorTable; }
+    inline void setDensityGrid(ScatterDensityGrid *grid) { m_densityGrid = grid; }
+    inline ScatterDensityGrid *densityGrid() const { return m_densityGrid; }
+    inline GLuint &densityTexture() { return m_densityTexture; }
+
+    // Model and normal matrices of the items for drawing them one by one. Items without a
+    // rotation of their own share the rotation and scale of the series, so only the items
+    // with a rotation keep matrices of their own.
+    void updateItemMatrices(const QVector3D &modelScaler);
+    void calculateItemMatrices(const ScatterRenderItem &item, const QVector3D &modelScaler,
+                               QMatrix4x4 &modelMatrix, QMatrix4x4 &normalMatrix) const;
+    void clearItemMatrices();
+    inline void setItemMatricesDirty() { m_itemMatricesDirty = true; }
+    inline void setItemMatrixDirty(int index)
+    {
+        // Recalculate everything if more items have changed than there are items
+        if (m_itemMatricesDirty) {
+            return;
+        } else if (m_dirtyMatrixIndices.size() >= m_matrixSlots.size()) {
+            m_dirtyMatrixIndices.clear();
+            m_itemMatricesDirty = true;
+        } else {
+            m_dirtyMatrixIndices.append(index);
+        }
+    }
+    inline QMatrix4x4 itemModelMatrix(int index) const
+    {
+        const int slot = m_matrixSlots.at(index);
+        if (slot >= 0)
+            return m_modelMatrices.at(slot);
+
+        // The series matrix has no translation, so translating it only sets the last column
+        QMatrix4x4 modelMatrix = m_seriesModelMatrix;
+        const QVector3D translation = m_renderArray.at(index).translation();
+        modelMatrix(0, 3) = translation.x();
+        modelMatrix(1, 3) = translation.y();
+        modelMatrix(2, 3) = translation.z();
+        return modelMatrix;
+    }
+    inline const QMatrix4x4 &itemNormalMatrix(int index) const
+    {
+        const int slot = m_matrixSlots.at(index);
+        return (slot >= 0) ? m_normalMatrices.at(slot) : m_seriesNormalMatrix;
+    }
 
 protected:
+    void updateItemMatrix(int index);
+
     ScatterRenderItemArray m_renderArray;
     float m_itemSize;
     int m_selectionIndexOffset; // Temporarily cached value for selection color calculations
@@ -88,9 +174,30 @@ protected:
     QString m_oldMeshFileName; // Used to detect if full buffer change needed
     ScatterObjectBufferHelper *m_scatterBufferObj;
     ScatterPointBufferHelper *m_scatterBufferPoints;
+    ScatterInstanceBufferHelper *m_scatterBufferInstances;
+    ScatterSpatialIndex *m_spatialIndex;
+    bool m_instanceBufferDirty; // Used to detect if full instance buffer load needed
     QVector<int> m_updateIndices; // Used as temporary cache during item updates
     QVector<int> m_bufferIndices; // Cache for mapping renderarray to mesh buffer
     bool m_visibilityChanged; // Used to detect if full buffer change needed
+    ObjectHelper *m_lowDetailObject; // Shared reference, null if the mesh has no low detail version
+    float m_lodThreshold;
+    float m_lodPointThreshold;
+    LodLevel m_seriesLodLevel; // Used for the static and instanced buffers
+    bool m_densityRendering;
+    int m_densityResolution; // Rounded up to the texture row alignment
+    QVector<QVector4D> m_densityColorTable; // Maps 8-bit densities to colors
+    ScatterDensityGrid *m_densityGrid;
+    GLuint m_densityTexture;
+    QMatrix4x4 m_seriesModelMatrix; // Rotation and scale shared by items without own rotation
+    QMatrix4x4 m_seriesNormalMatrix;
+    QVector<int> m_matrixSlots; // Index to the item matrices per item, -1 for the series matrices
+    QVector<QMatrix4x4> m_modelMatrices;
+    QVector<QMatrix4x4> m_normalMatrices;
+    bool m_itemMatricesDirty;
+    QVector<int> m_dirtyMatrixIndices; // Items changed since the matrices were last updated
+    QVector3D m_matrixScaler; // Item scale the matrices were calculated with
+    QQuaternion m_matrixRotation; // Mesh rotation the matrices were calculated with
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,38 @@
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec2 vertexUV;
+attribute highp vec3 vertexNormal_mdl;
+attribute highp vec3 instancePosition_wrld;
+attribute highp vec4 instanceRotation;
+attribute highp vec2 instanceGradient;
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 M;
+uniform highp mat4 itM;
+uniform highp vec3 lightPosition_wrld;
+
+varying highp vec3 lightPosition_wrld_frag;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec2 coords_mdl;
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    position_wrld = instancePosition_wrld
+            + rotate(instanceRotation, vec4(M * vec4(vertexPosition_mdl, 1.0)).xyz);
+    gl_Position = MVP * vec4(position_wrld, 1.0);
+    coords_mdl = vec2(vertexPosition_mdl.x,
+                      vertexPosition_mdl.y * instanceGradient.x + instanceGradient.y);
+    vec3 vertexPosition_cmr = vec4(V * vec4(position_wrld, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    vec3 lightPosition_cmr = vec4(V * vec4(lightPosition_wrld, 1.0)).xyz;
+    lightDirection_cmr = lightPosition_cmr + eyeDirection_cmr;
+    vec3 normal_wrld = rotate(instanceRotation, vec4(itM * vec4(vertexNormal_mdl, 0.0)).xyz);
+    normal_cmr = vec4(V * vec4(normal_wrld, 0.0)).xyz;
+    lightPosition_wrld_frag = lightPosition_wrld;
+}
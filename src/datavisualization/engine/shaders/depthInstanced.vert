@@ -0,0 +1,16 @@
+uniform highp mat4 MVP;
+uniform highp mat4 M;
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec3 instancePosition_wrld;
+attribute highp vec4 instanceRotation;
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    highp vec3 position_wrld = instancePosition_wrld
+            + rotate(instanceRotation, vec4(M * vec4(vertexPosition_mdl, 1.0)).xyz);
+    gl_Position = MVP * vec4(position_wrld, 1.0);
+}
@@ -0,0 +1,14 @@
+uniform highp mat4 MVP;
+uniform highp mat4 M;
+uniform highp float gradMin;
+uniform highp float gradHeight;
+
+attribute highp vec3 vertexPosition_mdl;
+
+varying highp vec2 UV;
+
+void main() {
+    gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
+    highp float y = vec4(M * vec4(vertexPosition_mdl, 1.0)).y;
+    UV = vec2(0.0, gradMin + y * gradHeight);
+}
@@ -0,0 +1,53 @@
+#version 120
+
+attribute highp vec2 vertexUV;
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 M;
+uniform highp mat4 itM;
+uniform highp vec3 lightPosition_wrld;
+uniform highp sampler2D heightSampler;
+uniform highp vec4 heightfieldRect;
+uniform highp vec2 heightfieldSize;
+
+varying highp vec3 lightPosition_wrld_frag;
+varying highp vec2 UV;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec2 coords_mdl;
+
+highp float heightAt(highp vec2 grid) {
+    return texture2DLod(heightSampler, (grid * (heightfieldSize - 1.0) + 0.5) / heightfieldSize,
+                        0.0).r;
+}
+
+void main() {
+    // Position from the grid coordinates and the sampled height
+    highp vec3 vertexPosition_mdl = vec3(heightfieldRect.x + vertexUV.x * heightfieldRect.z,
+                                         heightAt(vertexUV),
+                                         heightfieldRect.y + vertexUV.y * heightfieldRect.w);
+
+    // Normal from the slopes to the neighboring samples
+    highp vec2 gridStep = 1.0 / (heightfieldSize - 1.0);
+    highp vec2 low = max(vertexUV - gridStep, vec2(0.0));
+    highp vec2 high = min(vertexUV + gridStep, vec2(1.0));
+    highp float slopeX = (heightAt(vec2(high.x, vertexUV.y)) - heightAt(vec2(low.x, vertexUV.y)))
+            / ((high.x - low.x) * heightfieldRect.z);
+    highp float slopeZ = (heightAt(vec2(vertexUV.x, high.y)) - heightAt(vec2(vertexUV.x, low.y)))
+            / ((high.y - low.y) * heightfieldRect.w);
+    highp vec3 vertexNormal_mdl = vec3(-slopeX, 1.0, -slopeZ);
+
+    gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
+    coords_mdl = vertexPosition_mdl.xy;
+    position_wrld = vec4(M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    vec3 vertexPosition_cmr = vec4(V * M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    vec3 lightPosition_cmr = vec4(V * vec4(lightPosition_wrld, 1.0)).xyz;
+    lightDirection_cmr = lightPosition_cmr + eyeDirection_cmr;
+    normal_cmr = vec4(V * itM * vec4(vertexNormal_mdl, 0.0)).xyz;
+    lightPosition_wrld_frag = lightPosition_wrld;
+    UV = vertexUV;
+}
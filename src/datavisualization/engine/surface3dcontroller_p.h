@@ -52,6 +52,7 @@ struct Surface3DChangeBitField {
     bool selectedPointChanged      : 1;
     bool rowsChanged               : 1;
     bool itemChanged               : 1;
+    bool rowsShifted               : 1;
     bool flipHorizontalGridChanged : 1;
     bool surfaceTextureChanged     : 1;
 
@@ -59,6 +60,7 @@ struct Surface3DChangeBitField {
         selectedPointChanged(true),
         rowsChanged(false),
         itemChanged(false),
+        rowsShifted(false),
         flipHorizontalGridChanged(true),
         surfaceTextureChanged(true)
     {
@@ -78,6 +80,10 @@ public:
         QSurface3DSeries *series;
         int row;
     };
+    struct ChangeShift {
+        QSurface3DSeries *series;
+        int count;
+    };
 
 private:
     Surface3DChangeBitField m_changeTracker;
@@ -88,6 +94,7 @@ private:
     bool m_flatShadingSupported;
     QVector<ChangeItem> m_changedItems;
     QVector<ChangeRow> m_changedRows;
+    QVector<ChangeShift> m_shiftedRows;
     bool m_flipHorizontalGrid;
     QVector<QSurface3DSeries *> m_changedTextures;
 
@@ -130,6 +137,7 @@ public Q_SLOTS:
     void handleRowsRemoved(int startIndex, int count);
     void handleRowsInserted(int startIndex, int count);
     void handleItemChanged(int rowIndex, int columnIndex);
+    void handleRowsShifted(int count);
 
     void handleFlatShadingSupportedChange(bool supported);
 
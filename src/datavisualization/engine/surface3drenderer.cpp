@@ -47,6 +47,18 @@ const uint greenMultiplier = 256;
 const uint blueMultiplier = 65536;
 const uint alphaMultiplier = 16777216;
 
+// Copies the sampled part of a proxy row into a render cache row. Rows that are fully inside
+// the sample space share their item storage with the proxy, so no items are copied. The proxy
+// detaches the row on write.
+static inline void sampleRow(QSurfaceDataRow &dstRow, const QSurfaceDataRow &srcRow,
+                             const QRect &sampleSpace)
+{
+    if (sampleSpace.x() == 0 && sampleSpace.width() == srcRow.size())
+        dstRow = srcRow;
+    else
+        dstRow = srcRow.mid(sampleSpace.x(), sampleSpace.width());
+}
+
 Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
     : Abstract3DRenderer(controller),
       m_cachedIsSlicingActivated(false),
@@ -60,6 +72,10 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_surfaceSliceFlatShader(0),
       m_surfaceSliceSmoothShader(0),
       m_selectionShader(0),
+      m_surfaceHeightfieldShader(0),
+      m_heightfieldDepthShader(0),
+      m_heightfieldSelectionShader(0),
+      m_heightfieldGridShader(0),
       m_heightNormalizer(0.0f),
       m_scaleX(0.0f),
       m_scaleY(0.0f),
@@ -70,6 +86,8 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_selectionResultTexture(0),
       m_shadowQualityToShader(33.3f),
       m_flatSupported(true),
+      m_heightfieldSupported(false),
+      m_maxHeightfieldSize(0),
       m_selectionActive(false),
       m_shadowQualityMultiplier(3),
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
@@ -116,12 +134,27 @@ Surface3DRenderer::~Surface3DRenderer()
     delete m_surfaceGridShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_surfaceHeightfieldShader;
+    delete m_heightfieldDepthShader;
+    delete m_heightfieldSelectionShader;
+    delete m_heightfieldGridShader;
 }
 
 void Surface3DRenderer::initializeOpenGL()
 {
     Abstract3DRenderer::initializeOpenGL();
 
+    // Heightfields need float textures and texture lookups in the vertex shader
+#if !defined(QT_OPENGL_ES_2)
+    if (!m_isOpenGLES
+            && QOpenGLContext::currentContext()->format().version() >= qMakePair(3, 0)) {
+        GLint vertexTextureUnits = 0;
+        glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexTextureUnits);
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxHeightfieldSize);
+        m_heightfieldSupported = vertexTextureUnits > 0;
+    }
+#endif
+
     // Initialize shaders
     initSurfaceShaders();
 
@@ -227,14 +260,10 @@ void Surface3DRenderer::updateData()
                 if (dimensionsChanged) {
                     dataArray.reserve(sampleSpace.height());
                     for (int i = 0; i < sampleSpace.height(); i++)
-                        dataArray << new QSurfaceDataRow(sampleSpace.width());
-                }
-                for (int i = 0; i < sampleSpace.height(); i++) {
-                    for (int j = 0; j < sampleSpace.width(); j++) {
-                        (*(dataArray.at(i)))[j] = array.at(i + sampleSpace.y())->at(
-                                    j + sampleSpace.x());
-                    }
+                        dataArray << new QSurfaceDataRow;
                 }
+                for (int i = 0; i < sampleSpace.height(); i++)
+                    sampleRow(*dataArray.at(i), *array.at(i + sampleSpace.y()), sampleSpace);
 
                 checkFlatSupport(cache);
                 updateObjects(cache, dimensionsChanged);
@@ -329,6 +358,14 @@ void Surface3DRenderer::updateSurfaceTextures(QVector<QSurface3DSeries *> series
                 else
                     cache->surfaceObject()->smoothUVs(array, cache->dataArray());
             }
+
+            // Adding or removing the texture may switch the heightfield on or off
+            if (!cache->isFlatShadingEnabled() && cache->sampleSpace().width() >= 2
+                    && cache->sampleSpace().height() >= 2
+                    && cache->surfaceObject()->isHeightfieldEnabled()
+                    != isHeightfieldWanted(cache)) {
+                updateObjects(cache, false);
+            }
         }
     }
 }
@@ -360,15 +397,11 @@ void Surface3DRenderer::updateRows(const QVector<Surface3DController::ChangeRow>
 
         if (cache && srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
-            bool updateBuffers = false;
             int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
             int row = item.row;
             if (row >= sampleSpace.y() && row <= sampleSpaceTop) {
-                updateBuffers = true;
-                for (int j = 0; j < sampleSpace.width(); j++) {
-                    (*(dstArray.at(row - sampleSpace.y())))[j] =
-                            srcArray->at(row)->at(j + sampleSpace.x());
-                }
+                // Writing the items one by one would detach a shared row and copy it first
+                sampleRow(*dstArray.at(row - sampleSpace.y()), *srcArray->at(row), sampleSpace);
 
                 if (cache->isFlatShadingEnabled()) {
                     cache->surfaceObject()->updateCoarseRow(dstArray, row - sampleSpace.y(),
@@ -378,8 +411,6 @@ void Surface3DRenderer::updateRows(const QVector<Surface3DController::ChangeRow>
                                                             m_polarGraph);
                 }
             }
-            if (updateBuffers)
-                cache->surfaceObject()->uploadBuffers();
         }
     }
 
@@ -403,24 +434,24 @@ void Surface3DRenderer::updateItems(const QVector<Surface3DController::ChangeIte
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
             int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
             int sampleSpaceRight = sampleSpace.x() + sampleSpace.width();
-            bool updateBuffers = false;
             // Note: Point is (row, column), samplespace is (columns x rows)
             QPoint point = item.point;
 
             if (point.x() <= sampleSpaceTop && point.x() >= sampleSpace.y() &&
                     point.y() <= sampleSpaceRight && point.y() >= sampleSpace.x()) {
-                updateBuffers = true;
                 int x = point.y() - sampleSpace.x();
                 int y = point.x() - sampleSpace.y();
-                (*(dstArray.at(y)))[x] = srcArray->at(point.x())->at(point.y());
+                const QSurfaceDataRow &srcRow = *srcArray->at(point.x());
+                if (sampleSpace.x() == 0 && sampleSpace.width() == srcRow.size())
+                    *dstArray.at(y) = srcRow; // Share the row again instead of detaching it
+                else
+                    (*(dstArray.at(y)))[x] = srcRow.at(point.y());
 
                 if (cache->isFlatShadingEnabled())
                     cache->surfaceObject()->updateCoarseItem(dstArray, y, x, m_polarGraph);
                 else
                     cache->surfaceObject()->updateSmoothItem(dstArray, y, x, m_polarGraph);
             }
-            if (updateBuffers)
-                cache->surfaceObject()->uploadBuffers();
         }
 
     }
@@ -428,6 +459,64 @@ void Surface3DRenderer::updateItems(const QVector<Surface3DController::ChangeIte
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
+void Surface3DRenderer::updateRowShifts(const QVector<Surface3DController::ChangeShift> &shifts)
+{
+    bool fullUpdateNeeded = false;
+
+    foreach (Surface3DController::ChangeShift shift, shifts) {
+        SurfaceSeriesRenderCache *cache =
+                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(shift.series));
+        // Caches already waiting for a full update will pick up the shifted rows anyway
+        if (!cache || cache->dataDirty())
+            continue;
+        if (!cache->isVisible()) {
+            cache->setDataDirty(true);
+            continue;
+        }
+
+        const QSurfaceDataArray &srcArray = *shift.series->dataProxy()->array();
+        QSurfaceDataArray &dstArray = cache->dataArray();
+        const QRect &sampleSpace = cache->sampleSpace();
+
+        // The rows can only be shifted in place if all of them are drawn both before and
+        // after the shift. Otherwise the sample space changes and the surface is rebuilt.
+        if (sampleSpace.width() < 2 || sampleSpace.y() != 0
+                || sampleSpace.height() != srcArray.size()
+                || sampleSpace.height() - shift.count < 2
+                || calculateSampleRect(srcArray) != sampleSpace) {
+            cache->setDataDirty(true);
+            fullUpdateNeeded = true;
+            continue;
+        }
+
+        for (int i = 0; i < shift.count; i++)
+            delete dstArray.at(i);
+        dstArray.remove(0, shift.count);
+        for (int i = srcArray.size() - shift.count; i < srcArray.size(); i++) {
+            QSurfaceDataRow *row = new QSurfaceDataRow;
+            sampleRow(*row, *srcArray.at(i), sampleSpace);
+            dstArray << row;
+        }
+
+        if (!cache->surfaceObject()->shiftRows(dstArray, shift.count, m_polarGraph)) {
+            cache->setDataDirty(true);
+            fullUpdateNeeded = true;
+            continue;
+        }
+
+        if (cache->surfaceTexture()) {
+            if (cache->isFlatShadingEnabled())
+                cache->surfaceObject()->coarseUVs(srcArray, dstArray);
+            else
+                cache->surfaceObject()->smoothUVs(srcArray, dstArray);
+        }
+        cache->surfaceObject()->uploadBuffers();
+    }
+
+    if (fullUpdateNeeded)
+        updateData();
+}
+
 void Surface3DRenderer::updateSliceDataModel(const QPoint &point)
 {
     foreach (SeriesRenderCache *baseCache, m_renderCacheList)
@@ -760,6 +849,10 @@ void Surface3DRenderer::render(GLuint defaultFboHandle)
     if (m_axisCacheZ.positionsDirty())
         m_axisCacheZ.updateAllPositions();
 
+    // Row and item changes only mark the surface rows dirty, upload them all at once
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList)
+        static_cast<SurfaceSeriesRenderCache *>(baseCache)->surfaceObject()->uploadDirtyBuffers();
+
     drawScene(defaultFboHandle);
     if (m_cachedIsSlicingActivated)
         drawSlicedScene();
@@ -1122,13 +1215,18 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
     QMatrix4x4 projectionMatrix;
     GLfloat viewPortRatio = (GLfloat)m_primarySubViewport.width()
             / (GLfloat)m_primarySubViewport.height();
+    // Pixels per scene unit at unit distance, for the surface level of detail
+    GLfloat lodPixelScale;
     if (m_useOrthoProjection) {
         GLfloat orthoRatio = 2.0f;
         projectionMatrix.ortho(-viewPortRatio * orthoRatio, viewPortRatio * orthoRatio,
                                -orthoRatio, orthoRatio,
                                0.0f, 100.0f);
+        lodPixelScale = GLfloat(m_primarySubViewport.height()) / (2.0f * orthoRatio);
     } else {
         projectionMatrix.perspective(45.0f, viewPortRatio, 0.1f, 100.0f);
+        lodPixelScale = GLfloat(m_primarySubViewport.height())
+                / (2.0f * qTan(qDegreesToRadians(22.5f)));
     }
 
     const Q3DCamera *activeCamera = m_cachedScene->activeCamera();
@@ -1138,6 +1236,17 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
     QMatrix4x4 projectionViewMatrix = projectionMatrix * viewMatrix;
 
+    // Surface vertices are in scene coordinates, so the camera position is found directly
+    // from the view matrix
+    QVector3D cameraPosition = viewMatrix.inverted() * QVector3D();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (cache->isVisible()) {
+            cache->surfaceObject()->updateLevelOfDetail(cameraPosition, lodPixelScale,
+                                                        !m_useOrthoProjection);
+        }
+    }
+
     // Calculate flipping indicators
     if (viewMatrix.row(0).x() > 0)
         m_zFlipped = false;
@@ -1221,6 +1330,15 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                     && cache->sampleSpace().width() >= 2 && cache->sampleSpace().height() >= 2) {
                 // No translation nor scaling for surfaces, therefore no modelMatrix
                 // Use directly projectionViewMatrix
+                if (object->isHeightfield()) {
+                    glDisableVertexAttribArray(m_depthShader->posAtt());
+                    m_heightfieldDepthShader->bind();
+                    m_heightfieldDepthShader->setUniformValue(m_heightfieldDepthShader->MVP(),
+                                                              depthProjectionViewMatrix);
+                    m_drawer->drawSurfaceHeightfield(m_heightfieldDepthShader, object);
+                    m_depthShader->bind();
+                    continue;
+                }
                 m_depthShader->setUniformValue(m_depthShader->MVP(), depthProjectionViewMatrix);
 
                 // 1st attribute buffer : vertices
@@ -1299,8 +1417,18 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
                 cache->surfaceObject()->activateSurfaceTexture(false);
 
-                m_drawer->drawObject(m_selectionShader, cache->surfaceObject(),
-                                     cache->selectionTexture());
+                if (cache->surfaceObject()->isHeightfield()) {
+                    m_heightfieldSelectionShader->bind();
+                    m_heightfieldSelectionShader->setUniformValue(
+                                m_heightfieldSelectionShader->MVP(), projectionViewMatrix);
+                    m_drawer->drawSurfaceHeightfield(m_heightfieldSelectionShader,
+                                                     cache->surfaceObject(),
+                                                     cache->selectionTexture());
+                    m_selectionShader->bind();
+                } else {
+                    m_drawer->drawObject(m_selectionShader, cache->surfaceObject(),
+                                         cache->selectionTexture());
+                }
             }
         }
         m_surfaceGridShader->bind();
@@ -1405,6 +1533,9 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                         if (cache->surfaceTexture())
                             shader = m_surfaceTexturedSmoothShader;
                     }
+                    const bool heightfield = cache->surfaceObject()->isHeightfield();
+                    if (heightfield)
+                        shader = m_surfaceHeightfieldShader;
                     shader->bind();
 
                     // Set shader bindings
@@ -1454,13 +1585,21 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                         shader->setUniformValue(shader->lightS(), adjustedLightStrength);
 
                         // Draw the objects
-                        m_drawer->drawObject(shader, cache->surfaceObject(), texture,
-                                             m_depthTexture);
+                        if (heightfield) {
+                            m_drawer->drawSurfaceHeightfield(shader, cache->surfaceObject(),
+                                                             texture, m_depthTexture);
+                        } else {
+                            m_drawer->drawObject(shader, cache->surfaceObject(), texture,
+                                                 m_depthTexture);
+                        }
                     } else {
                         // Set shadowless shader bindings
                         shader->setUniformValue(shader->lightS(), m_cachedTheme->lightStrength());
                         // Draw the objects
-                        m_drawer->drawObject(shader, cache->surfaceObject(), texture);
+                        if (heightfield)
+                            m_drawer->drawSurfaceHeightfield(shader, cache->surfaceObject(), texture);
+                        else
+                            m_drawer->drawObject(shader, cache->surfaceObject(), texture);
                     }
                 }
             }
@@ -1484,7 +1623,19 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 if (cache->surfaceObject()->indexCount() && cache->surfaceGridVisible()
                         && cache->isVisible() && sampleSpace.width() >= 2
                         && sampleSpace.height() >= 2) {
-                    m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    if (cache->surfaceObject()->isHeightfield()) {
+                        m_heightfieldGridShader->bind();
+                        m_heightfieldGridShader->setUniformValue(
+                                    m_heightfieldGridShader->color(),
+                                    Utils::vectorFromColor(m_cachedTheme->gridLineColor()));
+                        m_heightfieldGridShader->setUniformValue(m_heightfieldGridShader->MVP(),
+                                                                 cache->MVPMatrix());
+                        m_drawer->drawSurfaceHeightfieldGrid(m_heightfieldGridShader,
+                                                             cache->surfaceObject());
+                        m_surfaceGridShader->bind();
+                    } else {
+                        m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    }
                 }
             }
         }
@@ -2629,6 +2780,7 @@ void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dime
         if (cache->surfaceTexture())
             cache->surfaceObject()->coarseUVs(array, dataArray);
     } else {
+        cache->surfaceObject()->setHeightfieldEnabled(isHeightfieldWanted(cache));
         cache->surfaceObject()->setUpSmoothData(dataArray, sampleSpace, dimensionChanged,
                                                 m_polarGraph);
         if (cache->surfaceTexture())
@@ -2636,6 +2788,15 @@ void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dime
     }
 }
 
+bool Surface3DRenderer::isHeightfieldWanted(SurfaceSeriesRenderCache *cache) const
+{
+    // Textured surfaces keep their own texture coordinates, so they are not heightfields
+    const QRect &sampleSpace = cache->sampleSpace();
+    return m_heightfieldSupported && cache->isHeightfieldRenderingEnabled()
+            && !cache->surfaceTexture() && sampleSpace.width() <= m_maxHeightfieldSize
+            && sampleSpace.height() <= m_maxHeightfieldSize;
+}
+
 void Surface3DRenderer::updateSelectedPoint(const QPoint &position, QSurface3DSeries *series)
 {
     m_selectedPoint = position;
@@ -2894,6 +3055,19 @@ void Surface3DRenderer::initShaders(const QString &vertexShader, const QString &
     delete m_surfaceTexturedFlatShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_surfaceHeightfieldShader;
+    m_surfaceHeightfieldShader = 0;
+
+    if (m_heightfieldSupported) {
+        if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+            m_surfaceHeightfieldShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightfieldShadow"),
+                                                          QStringLiteral(":/shaders/fragmentSurfaceShadowNoTex"));
+        } else {
+            m_surfaceHeightfieldShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightfield"),
+                                                          QStringLiteral(":/shaders/fragmentSurface"));
+        }
+        m_surfaceHeightfieldShader->initialize();
+    }
 
     if (!m_isOpenGLES) {
         if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
@@ -2969,6 +3143,13 @@ void Surface3DRenderer::initSelectionShaders()
     m_selectionShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexLabel"),
                                          QStringLiteral(":/shaders/fragmentLabel"));
     m_selectionShader->initialize();
+
+    if (m_heightfieldSupported) {
+        delete m_heightfieldSelectionShader;
+        m_heightfieldSelectionShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightfield"),
+                                                        QStringLiteral(":/shaders/fragmentLabel"));
+        m_heightfieldSelectionShader->initialize();
+    }
 }
 
 void Surface3DRenderer::initSurfaceShaders()
@@ -2980,6 +3161,13 @@ void Surface3DRenderer::initSurfaceShaders()
                                            QStringLiteral(":/shaders/fragmentPlainColor"));
     m_surfaceGridShader->initialize();
 
+    if (m_heightfieldSupported) {
+        delete m_heightfieldGridShader;
+        m_heightfieldGridShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightfield"),
+                                                   QStringLiteral(":/shaders/fragmentPlainColor"));
+        m_heightfieldGridShader->initialize();
+    }
+
     // Triggers surface shader selection by shadow setting
     handleShadowQualityChange();
 }
@@ -2992,6 +3180,13 @@ void Surface3DRenderer::initDepthShader()
                                          QStringLiteral(":/shaders/fragmentDepth"));
         m_depthShader->initialize();
     }
+
+    if (m_heightfieldSupported) {
+        delete m_heightfieldDepthShader;
+        m_heightfieldDepthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightfield"),
+                                                    QStringLiteral(":/shaders/fragmentDepth"));
+        m_heightfieldDepthShader->initialize();
+    }
 }
 
 void Surface3DRenderer::updateDepthBuffer()
@@ -68,6 +68,10 @@ private:
     ShaderHelper *m_surfaceSliceFlatShader;
     ShaderHelper *m_surfaceSliceSmoothShader;
     ShaderHelper *m_selectionShader;
+    ShaderHelper *m_surfaceHeightfieldShader;
+    ShaderHelper *m_heightfieldDepthShader;
+    ShaderHelper *m_heightfieldSelectionShader;
+    ShaderHelper *m_heightfieldGridShader;
     float m_heightNormalizer;
     float m_scaleX;
     float m_scaleY;
@@ -78,6 +82,8 @@ private:
     GLuint m_selectionResultTexture;
     GLfloat m_shadowQualityToShader;
     bool m_flatSupported;
+    bool m_heightfieldSupported;
+    GLint m_maxHeightfieldSize;
     bool m_selectionActive;
     AbstractRenderItem m_dummyRenderItem;
     GLint m_shadowQualityMultiplier;
@@ -100,6 +106,7 @@ public:
     void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode);
     void updateRows(const QVector<Surface3DController::ChangeRow> &rows);
     void updateItems(const QVector<Surface3DController::ChangeItem> &points);
+    void updateRowShifts(const QVector<Surface3DController::ChangeShift> &shifts);
     void updateScene(Q3DScene *scene);
     void updateSlicingActive(bool isSlicing);
     void updateSelectedPoint(const QPoint &position, QSurface3DSeries *series);
@@ -125,6 +132,7 @@ Q_SIGNALS:
 
 private:
     void checkFlatSupport(SurfaceSeriesRenderCache *cache);
+    bool isHeightfieldWanted(SurfaceSeriesRenderCache *cache) const;
     void updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged);
     void updateSliceDataModel(const QPoint &point);
     QPoint mapCoordsToSampleSpace(SurfaceSeriesRenderCache *cache, const QPointF &coords);
@@ -51,7 +51,8 @@ SurfaceSeriesRenderCache::SurfaceSeriesRenderCache(QAbstract3DSeries *series,
       m_mainSelectionPointer(0),
       m_slicePointerActive(false),
       m_mainPointerActive(false),
-      m_surfaceTexture(0)
+      m_surfaceTexture(0),
+      m_heightfieldRendering(false)
 {
 }
 
@@ -70,6 +71,11 @@ void SurfaceSeriesRenderCache::populate(bool newSeries)
         m_surfaceFlatShading = series()->isFlatShadingEnabled();
         m_flatStatusDirty = true;
     }
+    m_surfaceObj->setLodThreshold(series()->lodThreshold());
+    if (m_heightfieldRendering != series()->isHeightfieldRenderingEnabled()) {
+        m_heightfieldRendering = series()->isHeightfieldRenderingEnabled();
+        m_flatStatusDirty = true;
+    }
 }
 
 void SurfaceSeriesRenderCache::cleanup(TextureHelper *texHelper)
@@ -66,6 +66,7 @@ public:
     inline bool isFlatShadingEnabled() const { return m_surfaceFlatShading; }
     inline void setFlatShadingEnabled(bool enabled) { m_surfaceFlatShading = enabled; }
     inline void setFlatChangeAllowed(bool allowed) { m_flatChangeAllowed = allowed; }
+    inline bool isHeightfieldRenderingEnabled() const { return m_heightfieldRendering; }
     inline SurfaceObject *surfaceObject() { return m_surfaceObj; }
     inline SurfaceObject *sliceSurfaceObject() { return m_sliceSurfaceObj; }
     inline const QRect &sampleSpace() const { return m_sampleSpace; }
@@ -119,6 +120,7 @@ protected:
     bool m_slicePointerActive;
     bool m_mainPointerActive;
     GLuint m_surfaceTexture;
+    bool m_heightfieldRendering;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
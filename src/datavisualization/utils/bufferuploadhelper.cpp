@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "bufferuploadhelper_p.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+BufferUploadHelper::BufferUploadHelper()
+    : m_stats(0)
+{
+    initializeOpenGLFunctions();
+}
+
+// Sorts the indices and drops duplicates, which allows merging them into ranges
+void BufferUploadHelper::sortIndices(QVector<int> &indices)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+bool BufferUploadHelper::isFullUploadPreferred(int dirtyCount, int totalCount, float fraction)
+{
+    return totalCount > 0 && float(dirtyCount) > float(totalCount) * fraction;
+}
+
+void BufferUploadHelper::bufferData(GLenum target, qint64 size, const void *data, GLenum usage)
+{
+    // Re-specifying the whole store lets the driver orphan the old one instead of syncing
+    glBufferData(target, size, data, usage);
+    if (m_stats) {
+        m_stats->uploadCalls++;
+        m_stats->uploadBytes += size;
+    }
+}
+
+// Uploads items from an array mirroring the whole buffer. The indices must be sorted.
+void BufferUploadHelper::uploadItems(GLenum target, const void *data, int itemSize,
+                                     const QVector<int> &indices)
+{
+    uploadRanges(target, static_cast<const char *>(data), itemSize, indices, false);
+}
+
+// Uploads items stored consecutively in packedData to the given buffer positions.
+// The positions must be sorted.
+void BufferUploadHelper::uploadPackedItems(GLenum target, const void *packedData, int itemSize,
+                                           const QVector<int> &positions)
+{
+    uploadRanges(target, static_cast<const char *>(packedData), itemSize, positions, true);
+}
+
+void BufferUploadHelper::uploadRanges(GLenum target, const char *data, int itemSize,
+                                      const QVector<int> &positions, bool packed)
+{
+    const int count = positions.size();
+    int rangeStart = 0;
+    while (rangeStart < count) {
+        int rangeEnd = rangeStart + 1;
+        while (rangeEnd < count && positions.at(rangeEnd) == positions.at(rangeEnd - 1) + 1)
+            rangeEnd++;
+
+        const qint64 offset = qint64(positions.at(rangeStart)) * itemSize;
+        const qint64 size = qint64(rangeEnd - rangeStart) * itemSize;
+        const char *source = packed ? data + qint64(rangeStart) * itemSize : data + offset;
+        glBufferSubData(target, offset, size, source);
+        if (m_stats) {
+            m_stats->uploadCalls++;
+            m_stats->uploadBytes += size;
+        }
+
+        rangeStart = rangeEnd;
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
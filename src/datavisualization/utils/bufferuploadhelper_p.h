@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef BUFFERUPLOADHELPER_P_H
+#define BUFFERUPLOADHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtGui/QOpenGLFunctions>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+struct BufferUploadStats
+{
+    BufferUploadStats() : uploadCalls(0), uploadBytes(0) {}
+
+    inline void reset() { uploadCalls = 0; uploadBytes = 0; }
+
+    int uploadCalls;
+    qint64 uploadBytes;
+};
+
+// Uploads partial buffer changes with as few calls as possible by merging consecutive buffer
+// positions into single ranges. The target buffer must be bound by the caller.
+class BufferUploadHelper : protected QOpenGLFunctions
+{
+public:
+    BufferUploadHelper();
+
+    inline void setStats(BufferUploadStats *stats) { m_stats = stats; }
+
+    static void sortIndices(QVector<int> &indices);
+    static bool isFullUploadPreferred(int dirtyCount, int totalCount, float fraction);
+
+    void bufferData(GLenum target, qint64 size, const void *data, GLenum usage);
+    void uploadItems(GLenum target, const void *data, int itemSize, const QVector<int> &indices);
+    void uploadPackedItems(GLenum target, const void *packedData, int itemSize,
+                           const QVector<int> &positions);
+
+private:
+    void uploadRanges(GLenum target, const char *data, int itemSize,
+                      const QVector<int> &positions, bool packed);
+
+    BufferUploadStats *m_stats;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
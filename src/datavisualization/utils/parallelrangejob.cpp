@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "parallelrangejob_p.h"
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Number of bands per thread, more bands balance the load better between threads
+const int bandsPerThread = 4;
+
+// Helps processing the bands of a job
+class ParallelRangeBandTask : public QRunnable
+{
+public:
+    ParallelRangeBandTask(const QSharedPointer<ParallelRangeJob> &job) : m_job(job) {}
+
+    void run()
+    {
+        m_job->processBands();
+    }
+
+private:
+    QSharedPointer<ParallelRangeJob> m_job;
+};
+
+ParallelRangeJob::ParallelRangeJob()
+    : m_count(0),
+      m_bandSize(0),
+      m_bandCount(0),
+      m_nextBand(0),
+      m_doneBandCount(0)
+{
+}
+
+ParallelRangeJob::~ParallelRangeJob()
+{
+}
+
+// Processes the range [0, count) and returns when all of it is done. Ranges too small to be
+// split into at least two bands of minBandSize are processed directly in the calling thread.
+void ParallelRangeJob::run(const QSharedPointer<ParallelRangeJob> &job, int count,
+                           int minBandSize)
+{
+    if (count <= 0)
+        return;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threadCount = pool->maxThreadCount();
+    if (threadCount < 2 || count < 2 * minBandSize) {
+        job->processRange(0, count);
+        return;
+    }
+
+    job->m_count = count;
+    job->m_bandSize = qMax(minBandSize, count / (threadCount * bandsPerThread) + 1);
+    job->m_bandCount = (count + job->m_bandSize - 1) / job->m_bandSize;
+
+    // Helpers starting late find no bands left and return right away, so the job itself is
+    // shared with them.
+    const int helperCount = qMin(threadCount, job->m_bandCount) - 1;
+    for (int i = 0; i < helperCount; i++)
+        pool->start(new ParallelRangeBandTask(job));
+
+    job->processBands();
+
+    QMutexLocker locker(&job->m_mutex);
+    while (job->m_doneBandCount < job->m_bandCount)
+        job->m_bandsDone.wait(&job->m_mutex);
+}
+
+void ParallelRangeJob::processBands()
+{
+    int band;
+    while ((band = m_nextBand.fetchAndAddRelaxed(1)) < m_bandCount) {
+        const int begin = band * m_bandSize;
+        processRange(begin, qMin(begin + m_bandSize, m_count));
+
+        QMutexLocker locker(&m_mutex);
+        if (++m_doneBandCount == m_bandCount)
+            m_bandsDone.wakeAll();
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef PARALLELRANGEJOB_P_H
+#define PARALLELRANGEJOB_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QSharedPointer>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Processes an index range split into bands. The calling thread and helper tasks in the global
+// thread pool claim the bands from a shared counter, so a busy pool never stalls the job.
+// Derived classes implement processRange(), which must only touch data of its own range.
+class ParallelRangeJob
+{
+public:
+    virtual ~ParallelRangeJob();
+
+    static void run(const QSharedPointer<ParallelRangeJob> &job, int count, int minBandSize);
+    void processBands();
+
+protected:
+    ParallelRangeJob();
+
+    virtual void processRange(int begin, int end) = 0;
+
+private:
+    int m_count;
+    int m_bandSize;
+    int m_bandCount;
+    QAtomicInt m_nextBand;
+
+    QMutex m_mutex;
+    QWaitCondition m_bandsDone;
+    int m_doneBandCount;
+
+    Q_DISABLE_COPY(ParallelRangeJob)
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
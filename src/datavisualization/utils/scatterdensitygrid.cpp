@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatterdensitygrid_p.h"
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const int uncountedVoxel = -1;
+
+ScatterDensityGrid::ScatterDensityGrid()
+    : m_dirty(true),
+      m_textureDirty(true),
+      m_resolution(0)
+{
+}
+
+void ScatterDensityGrid::build(const ScatterRenderItemArray &renderArray, int resolution,
+                               const QVector3D &scale)
+{
+    const int itemCount = renderArray.size();
+
+    m_dirty = false;
+    m_textureDirty = true;
+    m_resolution = resolution;
+    m_scale = scale;
+    m_counts.fill(0, resolution * resolution * resolution);
+    m_itemVoxels.resize(itemCount);
+
+    for (int i = 0; i < itemCount; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
+        int voxel = uncountedVoxel;
+        if (item.isVisible()) {
+            voxel = voxelIndex(item.translation());
+            m_counts[voxel]++;
+        }
+        m_itemVoxels[i] = voxel;
+    }
+}
+
+void ScatterDensityGrid::updateItem(int index, const ScatterRenderItem &item)
+{
+    if (m_dirty)
+        return;
+    if (index >= m_itemVoxels.size()) {
+        m_dirty = true;
+        return;
+    }
+
+    const int voxel = item.isVisible() ? voxelIndex(item.translation()) : uncountedVoxel;
+    int &currentVoxel = m_itemVoxels[index];
+    if (voxel == currentVoxel)
+        return;
+
+    if (currentVoxel != uncountedVoxel)
+        m_counts[currentVoxel]--;
+    if (voxel != uncountedVoxel)
+        m_counts[voxel]++;
+    currentVoxel = voxel;
+    m_textureDirty = true;
+}
+
+void ScatterDensityGrid::textureData(QVector<uchar> &data)
+{
+    const int voxelCount = m_counts.size();
+
+    int maxCount = 0;
+    for (int i = 0; i < voxelCount; i++)
+        maxCount = qMax(maxCount, m_counts.at(i));
+
+    // Logarithmic scale keeps sparse areas visible next to dense clusters
+    data.resize(voxelCount);
+    const qreal densityScale = maxCount ? 255.0 / qLn(qreal(maxCount) + 1.0) : 0.0;
+    for (int i = 0; i < voxelCount; i++) {
+        const int count = m_counts.at(i);
+        data[i] = count ? uchar(qMax(1, qRound(qLn(qreal(count) + 1.0) * densityScale))) : 0;
+    }
+
+    m_textureDirty = false;
+}
+
+int ScatterDensityGrid::voxelIndex(const QVector3D &translation) const
+{
+    // Translations are within [-scale, scale]. The volume shaders expect the rows from top
+    // to bottom and the slices from front to back, so Y and Z are flipped.
+    const float halfResolution = float(m_resolution) / 2.0f;
+    const int maxVoxel = m_resolution - 1;
+    int x = 0;
+    int y = 0;
+    int z = 0;
+    if (m_scale.x() > 0.0f)
+        x = int((translation.x() / m_scale.x() + 1.0f) * halfResolution);
+    if (m_scale.y() > 0.0f)
+        y = int((1.0f - translation.y() / m_scale.y()) * halfResolution);
+    if (m_scale.z() > 0.0f)
+        z = int((1.0f - translation.z() / m_scale.z()) * halfResolution);
+    x = qBound(0, x, maxVoxel);
+    y = qBound(0, y, maxVoxel);
+    z = qBound(0, z, maxVoxel);
+    return (z * m_resolution + y) * m_resolution + x;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
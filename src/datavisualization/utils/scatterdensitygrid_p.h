@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERDENSITYGRID_P_H
+#define SCATTERDENSITYGRID_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Voxel grid of item counts over the graph area of a scatter series, used for rendering the
+// series as a density volume. Changed items move their count from the old voxel to the new
+// one, so the grid only needs rebuilding when the whole data or the graph area changes.
+// Items outside the axis ranges are not visible, so they are not counted.
+class ScatterDensityGrid
+{
+public:
+    ScatterDensityGrid();
+
+    // Scale is the extent of the item translations from the origin on each axis
+    void build(const ScatterRenderItemArray &renderArray, int resolution,
+               const QVector3D &scale);
+    void updateItem(int index, const ScatterRenderItem &item);
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+    inline bool isTextureDirty() const { return m_textureDirty; }
+    inline int resolution() const { return m_resolution; }
+    inline const QVector3D &scale() const { return m_scale; }
+
+    // Maps the voxel counts to 8-bit densities on a logarithmic scale, ordered for the volume
+    // shaders with rows from top to bottom and slices from front to back.
+    void textureData(QVector<uchar> &data);
+
+private:
+    int voxelIndex(const QVector3D &translation) const;
+
+    bool m_dirty;
+    bool m_textureDirty;
+    int m_resolution;
+    QVector3D m_scale;
+    QVector<int> m_counts;
+    QVector<int> m_itemVoxels; // Voxel of each item, or -1 if the item is not counted
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
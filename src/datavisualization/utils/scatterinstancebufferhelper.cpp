@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatterinstancebufferhelper_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const QVector3D hiddenPos(-1000.0f, -1000.0f, -1000.0f);
+
+ScatterInstanceBufferHelper::ScatterInstanceBufferHelper()
+    : m_instanceBuffer(0),
+      m_instanceCount(0)
+{
+    initializeOpenGLFunctions();
+}
+
+ScatterInstanceBufferHelper::~ScatterInstanceBufferHelper()
+{
+    if (QOpenGLContext::currentContext())
+        glDeleteBuffers(1, &m_instanceBuffer);
+}
+
+void ScatterInstanceBufferHelper::fullLoad(ScatterSeriesRenderCache *cache)
+{
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int renderArraySize = renderArray.size();
+    const QQuaternion &seriesRotation = cache->meshRotation();
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+
+    m_instances.resize(renderArraySize);
+    bool itemsVisible = false;
+    for (int i = 0; i < renderArraySize; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
+        createInstance(item, seriesRotation, rangeGradient, m_instances[i]);
+        if (item.isVisible())
+            itemsVisible = true;
+    }
+
+    m_instanceCount = itemsVisible ? renderArraySize : 0;
+
+    if (m_instanceCount > 0) {
+        if (!m_instanceBuffer)
+            glGenBuffers(1, &m_instanceBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        m_uploader.bufferData(GL_ARRAY_BUFFER, m_instanceCount * sizeof(InstanceData),
+                              &m_instances.at(0), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void ScatterInstanceBufferHelper::update(ScatterSeriesRenderCache *cache)
+{
+    // The buffer is not initialized if all items of the series were hidden at load time.
+    // Item becoming visible requires a full load in that case. Empty update indices request
+    // a full load, too.
+    if (!m_instanceCount || cache->updateIndices().isEmpty()) {
+        fullLoad(cache);
+        return;
+    }
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const QQuaternion &seriesRotation = cache->meshRotation();
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+    const QVector<int> &updateIndices = cache->updateIndices();
+    const int updateSize = updateIndices.size();
+
+    for (int i = 0; i < updateSize; i++) {
+        const int index = updateIndices.at(i);
+        createInstance(renderArray.at(index), seriesRotation, rangeGradient, m_instances[index]);
+    }
+
+    // Update indices are expected sorted
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    m_uploader.uploadItems(GL_ARRAY_BUFFER, m_instances.constData(), sizeof(InstanceData),
+                           updateIndices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ScatterInstanceBufferHelper::createInstance(const ScatterRenderItem &item,
+                                                 const QQuaternion &seriesRotation,
+                                                 bool rangeGradient,
+                                                 InstanceData &instance) const
+{
+    if (!item.isVisible()) {
+        instance.translation = hiddenPos;
+        instance.rotation = QVector4D(0.0f, 0.0f, 0.0f, 1.0f);
+        instance.gradient = QVector2D(1.0f, 0.0f);
+        return;
+    }
+
+    instance.translation = item.translation();
+    instance.rotation = (seriesRotation * item.rotation()).toVector4D();
+    if (rangeGradient) {
+        // The shaders resolve the gradient position from mesh y scaled by the first component
+        // and offset by the second one, with the range gradient using the item y for the
+        // whole item. The gradient uniforms map the item y to the axis range, so range
+        // changes don't require reloading the instances.
+        instance.gradient = QVector2D(0.0f, item.translation().y());
+    } else {
+        instance.gradient = QVector2D(1.0f, 0.0f);
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERINSTANCEBUFFERHELPER_P_H
+#define SCATTERINSTANCEBUFFERHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterseriesrendercache_p.h"
+#include "bufferuploadhelper_p.h"
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector4D>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Holds the per-instance attributes of a scatter series drawn with a single instanced call.
+// The mesh itself comes from the series ObjectHelper.
+class ScatterInstanceBufferHelper : protected QOpenGLFunctions
+{
+public:
+    struct InstanceData {
+        QVector3D translation;
+        QVector4D rotation; // Quaternion as (x, y, z, scalar)
+        QVector2D gradient; // Scale and offset applied to mesh y for gradient lookup
+    };
+
+    ScatterInstanceBufferHelper();
+    virtual ~ScatterInstanceBufferHelper();
+
+    GLuint instanceBuf() const { return m_instanceBuffer; }
+    int instanceCount() const { return m_instanceCount; }
+
+    void fullLoad(ScatterSeriesRenderCache *cache);
+    void update(ScatterSeriesRenderCache *cache);
+    void setUploadStats(BufferUploadStats *stats) { m_uploader.setStats(stats); }
+
+private:
+    void createInstance(const ScatterRenderItem &item, const QQuaternion &seriesRotation,
+                        bool rangeGradient, InstanceData &instance) const;
+
+    QVector<InstanceData> m_instances;
+    GLuint m_instanceBuffer;
+    int m_instanceCount;
+    BufferUploadHelper m_uploader;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
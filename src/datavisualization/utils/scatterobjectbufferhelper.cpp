@@ -29,16 +29,135 @@
 
 #include "scatterobjectbufferhelper_p.h"
 #include "objecthelper_p.h"
+#include "parallelrangejob_p.h"
 #include <QtGui/QVector2D>
 #include <QtGui/QMatrix4x4>
-#include <QtCore/qmath.h>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 const GLfloat itemScaler = 3.0f;
+// Minimum number of items written to the buffers as a single band in parallel loads
+const int minFillBandSize = 2048;
+static const GLfloat zeroTranslation[3] = { 0.0f, 0.0f, 0.0f };
+
+// Stores the upper left 3x3 part of the matrix in row-major order
+static inline void linearPart(const QMatrix4x4 &matrix, GLfloat *linear)
+{
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++)
+            linear[row * 3 + column] = matrix(row, column);
+    }
+}
+
+// Transforms packed xyz triplets by a linear part and a translation. Plain float arithmetic
+// over packed arrays lets the compiler vectorize the loop.
+static inline void transformPoints(const GLfloat *linear, const GLfloat *translation,
+                                   const GLfloat *source, GLfloat *target, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const GLfloat x = source[0];
+        const GLfloat y = source[1];
+        const GLfloat z = source[2];
+        target[0] = linear[0] * x + linear[1] * y + linear[2] * z + translation[0];
+        target[1] = linear[3] * x + linear[4] * y + linear[5] * z + translation[1];
+        target[2] = linear[6] * x + linear[7] * y + linear[8] * z + translation[2];
+        source += 3;
+        target += 3;
+    }
+}
+
+static inline void translatePoints(const GLfloat *translation, const GLfloat *source,
+                                   GLfloat *target, int count)
+{
+    for (int i = 0; i < count; i++) {
+        target[0] = source[0] + translation[0];
+        target[1] = source[1] + translation[1];
+        target[2] = source[2] + translation[2];
+        source += 3;
+        target += 3;
+    }
+}
+
+// Gradient coordinates are the mesh Y-coordinates on object gradient and the item Y-coordinate
+// on range gradient. The shader maps them to the gradient texture, so changing the gradient or
+// the axis ranges doesn't require updating the UVs.
+static inline void gradientUVs(Q3DTheme::ColorStyle colorStyle, const GLfloat *vertices,
+                               GLfloat itemY, QVector2D *target, int count)
+{
+    if (colorStyle == Q3DTheme::ColorStyleObjectGradient) {
+        for (int i = 0; i < count; i++)
+            target[i] = QVector2D(0.0f, vertices[i * 3 + 1]);
+    } else {
+        const QVector2D uv(0.0f, colorStyle == Q3DTheme::ColorStyleRangeGradient ? itemY : 0.0f);
+        for (int i = 0; i < count; i++)
+            target[i] = uv;
+    }
+}
+
+// Writes the mesh data of the visible items to their resolved buffer positions
+class ScatterObjectFillJob : public ParallelRangeJob
+{
+public:
+    const ScatterRenderItem *renderItems;
+    const int *bufferIndices;
+    QQuaternion seriesRotation;
+    QVector3D modelScaler;
+    const GLfloat *vertices;
+    const GLfloat *scaledVertices;
+    const GLfloat *normals;
+    const GLuint *indices;
+    int verticeCount;
+    int indicesCount;
+    int uvsCount;
+    Q3DTheme::ColorStyle colorStyle;
+    GLfloat *bufferedVertices;
+    GLfloat *bufferedNormals;
+    QVector2D *bufferedUVs;
+    GLuint *bufferedIndices;
+
+protected:
+    void processRange(int begin, int end)
+    {
+        for (int i = begin; i < end; i++) {
+            const ScatterRenderItem &item = renderItems[i];
+            if (!item.isVisible())
+                continue;
+
+            const int itemIndex = bufferIndices[i];
+            const QVector3D &itemTranslation = item.translation();
+            const GLfloat translation[3] = { itemTranslation.x(), itemTranslation.y(),
+                                             itemTranslation.z() };
+            const int offset = itemIndex * verticeCount * 3;
+            if (item.rotation().isIdentity()) {
+                translatePoints(translation, scaledVertices, bufferedVertices + offset,
+                                verticeCount);
+                memcpy(bufferedNormals + offset, normals, verticeCount * 3 * sizeof(GLfloat));
+            } else {
+                QMatrix4x4 matrix;
+                matrix.rotate(seriesRotation * item.rotation());
+                matrix.scale(modelScaler);
+                GLfloat linear[9];
+                GLfloat normalLinear[9];
+                linearPart(matrix, linear);
+                linearPart(matrix.inverted().transposed(), normalLinear);
+                transformPoints(linear, translation, vertices, bufferedVertices + offset,
+                                verticeCount);
+                transformPoints(normalLinear, zeroTranslation, normals,
+                                bufferedNormals + offset, verticeCount);
+            }
+
+            gradientUVs(colorStyle, vertices, itemTranslation.y(),
+                        bufferedUVs + itemIndex * uvsCount, uvsCount);
+
+            const GLuint offsetVertice = GLuint(itemIndex * verticeCount);
+            GLuint *itemIndices = bufferedIndices + itemIndex * indicesCount;
+            for (int j = 0; j < indicesCount; j++)
+                itemIndices[j] = indices[j] + offsetVertice;
+        }
+    }
+};
 
 ScatterObjectBufferHelper::ScatterObjectBufferHelper()
-    : m_scaleY(0.0f)
 {
 }
 
@@ -51,7 +170,7 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
     m_meshDataLoaded = false;
     m_indexCount = 0;
 
-    ObjectHelper *dotObj = cache->object();
+    ObjectHelper *dotObj = cache->seriesLodObject();
     const ScatterRenderItemArray &renderArray = cache->renderArray();
     const uint renderArraySize = renderArray.size();
 
@@ -88,103 +207,79 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
         itemSize = dotScale;
     QVector3D modelScaler(itemSize, itemSize, itemSize);
     QMatrix4x4 modelMatrix;
-    if (!seriesRotation.isIdentity()) {
-        QMatrix4x4 matrix;
-        matrix.rotate(seriesRotation);
-        modelMatrix = matrix.transposed();
-    }
+    modelMatrix.rotate(seriesRotation);
     modelMatrix.scale(modelScaler);
+    GLfloat seriesLinear[9];
+    linearPart(modelMatrix, seriesLinear);
 
     QVector<QVector3D> scaled_vertices;
     scaled_vertices.resize(verticeCount);
-    for (int i = 0; i < verticeCount; i++)
-        scaled_vertices[i] = indexed_vertices[i] * modelMatrix;
+    transformPoints(seriesLinear, zeroTranslation,
+                    reinterpret_cast<const GLfloat *>(indexed_vertices.constData()),
+                    reinterpret_cast<GLfloat *>(scaled_vertices.data()), verticeCount);
+
+    // Resolve the buffer position of each visible item first, so that the items can be
+    // written to the buffers independently of each other.
+    QVector<int> &bufferIndices = cache->bufferIndices();
+    bufferIndices.resize(renderArraySize);
+    for (uint i = 0; i < renderArraySize; i++) {
+        if (renderArray.at(i).isVisible())
+            bufferIndices[i] = itemCount++;
+    }
 
     QVector<GLuint> buffered_indices;
     QVector<QVector3D> buffered_vertices;
     QVector<QVector2D> buffered_uvs;
     QVector<QVector3D> buffered_normals;
 
-    buffered_indices.resize(indicesCount * renderArraySize);
-    buffered_vertices.resize(verticeCount * renderArraySize);
-    buffered_normals.resize(normalsCount * renderArraySize);
-    buffered_uvs.resize(uvsCount * renderArraySize);
-
-    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-        createRangeGradientUVs(cache, buffered_uvs);
-    else if (cache->colorStyle() == Q3DTheme::ColorStyleObjectGradient)
-        createObjectGradientUVs(cache, buffered_uvs, indexed_vertices);
-
-    QVector2D dummyUV(0.0f, 0.0f);
-
-    cache->bufferIndices().resize(renderArraySize);
-
-    for (uint i = 0; i < renderArraySize; i++) {
-        const ScatterRenderItem &item = renderArray.at(i);
-        if (!item.isVisible())
-            continue;
-        else
-            cache->bufferIndices()[i] = itemCount;
-
-        int offset = itemCount * verticeCount;
-        if (item.rotation().isIdentity()) {
-            for (int j = 0; j < verticeCount; j++) {
-                buffered_vertices[j + offset] = scaled_vertices[j] + item.translation();
-                buffered_normals[j + offset] = indexed_normals[j];
-            }
-        } else {
-            QMatrix4x4 matrix;
-            QQuaternion totalRotation = seriesRotation * item.rotation();
-            matrix.rotate(totalRotation);
-            matrix.scale(modelScaler);
-            QMatrix4x4 itModelMatrix = matrix.inverted();
-            modelMatrix = matrix.transposed(); // Because of row-column major difference
-
-            for (int j = 0; j < verticeCount; j++) {
-                buffered_vertices[j + offset] = indexed_vertices[j] * modelMatrix
-                        + item.translation();
-                buffered_normals[j + offset] = indexed_normals[j] * itModelMatrix;
-            }
-        }
-
-        if (cache->colorStyle() == Q3DTheme::ColorStyleUniform) {
-            offset = itemCount * uvsCount;
-            for (int j = 0; j < uvsCount; j++)
-                buffered_uvs[j + offset] = dummyUV;
-        }
-
-        int offsetVertice = itemCount * verticeCount;
-        offset = itemCount * indicesCount;
-        for (int j = 0; j < indicesCount; j++)
-            buffered_indices[j + offset] = GLuint(indices[j] + offsetVertice);
-
-        itemCount++;
-    }
+    buffered_indices.resize(indicesCount * itemCount);
+    buffered_vertices.resize(verticeCount * itemCount);
+    buffered_normals.resize(normalsCount * itemCount);
+    buffered_uvs.resize(uvsCount * itemCount);
+
+    ScatterObjectFillJob *fillJob = new ScatterObjectFillJob;
+    fillJob->renderItems = renderArray.constData();
+    fillJob->bufferIndices = bufferIndices.constData();
+    fillJob->seriesRotation = seriesRotation;
+    fillJob->modelScaler = modelScaler;
+    fillJob->vertices = reinterpret_cast<const GLfloat *>(indexed_vertices.constData());
+    fillJob->scaledVertices = reinterpret_cast<const GLfloat *>(scaled_vertices.constData());
+    fillJob->normals = reinterpret_cast<const GLfloat *>(indexed_normals.constData());
+    fillJob->indices = indices.constData();
+    fillJob->verticeCount = verticeCount;
+    fillJob->indicesCount = indicesCount;
+    fillJob->uvsCount = uvsCount;
+    fillJob->colorStyle = cache->colorStyle();
+    fillJob->bufferedVertices = reinterpret_cast<GLfloat *>(buffered_vertices.data());
+    fillJob->bufferedNormals = reinterpret_cast<GLfloat *>(buffered_normals.data());
+    fillJob->bufferedUVs = buffered_uvs.data();
+    fillJob->bufferedIndices = buffered_indices.data();
+
+    QSharedPointer<ParallelRangeJob> job(fillJob);
+    ParallelRangeJob::run(job, int(renderArraySize), minFillBandSize);
 
     m_indexCount = indicesCount * itemCount;
 
     if (itemCount > 0) {
         glGenBuffers(1, &m_vertexbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
-        glBufferData(GL_ARRAY_BUFFER, verticeCount * itemCount * sizeof(QVector3D),
-                     &buffered_vertices.at(0),
-                     GL_STATIC_DRAW);
+        m_uploader.bufferData(GL_ARRAY_BUFFER, verticeCount * itemCount * sizeof(QVector3D),
+                              &buffered_vertices.at(0), GL_STATIC_DRAW);
 
         glGenBuffers(1, &m_normalbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
-        glBufferData(GL_ARRAY_BUFFER, normalsCount * itemCount * sizeof(QVector3D),
-                     &buffered_normals.at(0),
-                     GL_STATIC_DRAW);
+        m_uploader.bufferData(GL_ARRAY_BUFFER, normalsCount * itemCount * sizeof(QVector3D),
+                              &buffered_normals.at(0), GL_STATIC_DRAW);
 
         glGenBuffers(1, &m_uvbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
-        glBufferData(GL_ARRAY_BUFFER, uvsCount * itemCount * sizeof(QVector2D),
-                     &buffered_uvs.at(0), GL_STATIC_DRAW);
+        m_uploader.bufferData(GL_ARRAY_BUFFER, uvsCount * itemCount * sizeof(QVector2D),
+                              &buffered_uvs.at(0), GL_STATIC_DRAW);
 
         glGenBuffers(1, &m_elementbuffer);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesCount * itemCount * sizeof(GLint),
-                     &buffered_indices.at(0), GL_STATIC_DRAW);
+        m_uploader.bufferData(GL_ELEMENT_ARRAY_BUFFER, indicesCount * itemCount * sizeof(GLint),
+                              &buffered_indices.at(0), GL_STATIC_DRAW);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -195,118 +290,57 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
 
 void ScatterObjectBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
 {
-    ObjectHelper *dotObj = cache->object();
+    // UVs only depend on the color style, so all of them are rewritten
+    ObjectHelper *dotObj = cache->seriesLodObject();
+    const QVector<QVector3D> indexed_vertices = dotObj->indexedvertices();
     const int uvsCount = dotObj->indexedUVs().count();
     const ScatterRenderItemArray &renderArray = cache->renderArray();
-    const bool updateAll = (cache->updateIndices().size() == 0);
-    const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
-
-    if (!updateSize)
-        return;
+    const int renderArraySize = renderArray.size();
+    const GLfloat *vertices = reinterpret_cast<const GLfloat *>(indexed_vertices.constData());
 
     QVector<QVector2D> buffered_uvs;
-    buffered_uvs.resize(uvsCount * updateSize);
+    buffered_uvs.resize(uvsCount * renderArraySize);
 
     uint itemCount = 0;
-    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient) {
-        itemCount = createRangeGradientUVs(cache, buffered_uvs);
-    } else if (cache->colorStyle() == Q3DTheme::ColorStyleObjectGradient) {
-        const QVector<QVector3D> indexed_vertices = dotObj->indexedvertices();
-        itemCount = createObjectGradientUVs(cache, buffered_uvs, indexed_vertices);
-    }
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
-    int itemSize = uvsCount * sizeof(QVector2D);
-    if (cache->updateIndices().size()) {
-        int pos = 0;
-        for (int i = 0; i < updateSize; i++) {
-            int index = cache->updateIndices().at(i);
-            if (renderArray.at(index).isVisible()) {
-                int dataPos = cache->bufferIndices().at(index);
-                glBufferSubData(GL_ARRAY_BUFFER, itemSize * dataPos, itemSize,
-                                &buffered_uvs.at(uvsCount * pos++));
-            }
-        }
-    } else {
-        glBufferData(GL_ARRAY_BUFFER, itemSize * itemCount, &buffered_uvs.at(0), GL_STATIC_DRAW);
-    }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
-uint ScatterObjectBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache *cache,
-                                                       QVector<QVector2D> &buffered_uvs)
-{
-    ObjectHelper *dotObj = cache->object();
-    const int uvsCount = dotObj->indexedUVs().count();
-    const ScatterRenderItemArray &renderArray = cache->renderArray();
-    const bool updateAll = (cache->updateIndices().size() == 0);
-    const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
-    const float yAdjustment = 0.1f;
-    const float flippedYAdjustment = 0.9f;
-
-    QVector2D uv;
-    uv.setX(0.0f);
-    uint pos = 0;
-    for (int i = 0; i < updateSize; i++) {
-        int index = updateAll ? i : cache->updateIndices().at(i);
-        const ScatterRenderItem &item = renderArray.at(index);
+    for (int i = 0; i < renderArraySize; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
         if (!item.isVisible())
             continue;
 
-        float y = ((item.translation().y() + m_scaleY) * 0.5f) / m_scaleY;
-
-        // Avoid values near gradient texel boundary, as this causes artifacts
-        // with some graphics cards.
-        const float floorY = float(qFloor(y * gradientTextureHeight));
-        const float diff = (y * gradientTextureHeight) - floorY;
-        if (diff < yAdjustment)
-            y += yAdjustment / gradientTextureHeight;
-        else if (diff > flippedYAdjustment)
-            y -= yAdjustment / gradientTextureHeight;
-        uv.setY(y);
-
-        int offset = pos * uvsCount;
-        for (int j = 0; j < uvsCount; j++)
-            buffered_uvs[j + offset] = uv;
-
-        pos++;
+        gradientUVs(cache->colorStyle(), vertices, item.translation().y(),
+                    buffered_uvs.data() + itemCount * uvsCount, uvsCount);
+        itemCount++;
     }
 
-    return pos;
+    if (itemCount) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
+        m_uploader.bufferData(GL_ARRAY_BUFFER, uvsCount * itemCount * sizeof(QVector2D),
+                              &buffered_uvs.at(0), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 }
 
-uint ScatterObjectBufferHelper::createObjectGradientUVs(ScatterSeriesRenderCache *cache,
-                                                        QVector<QVector2D> &buffered_uvs,
-                                                        const QVector<QVector3D> &indexed_vertices)
+// Buffer positions of the visible updated items. As buffer positions follow the item order,
+// sorted update indices give sorted positions.
+QVector<int> ScatterObjectBufferHelper::visibleBufferPositions(ScatterSeriesRenderCache *cache)
 {
-    ObjectHelper *dotObj = cache->object();
-    const int uvsCount = dotObj->indexedUVs().count();
     const ScatterRenderItemArray &renderArray = cache->renderArray();
-    const uint renderArraySize = renderArray.size();
-
-    QVector2D uv;
-    uv.setX(0.0f);
-    uint pos = 0;
-    for (uint i = 0; i < renderArraySize; i++) {
-        const ScatterRenderItem &item = renderArray.at(i);
-        if (!item.isVisible())
-            continue;
-
-        int offset = pos * uvsCount;
-        for (int j = 0; j < uvsCount; j++) {
-            uv.setY((indexed_vertices.at(j).y() + 1.0f) / 2.0f);
-            buffered_uvs[j + offset] = uv;
-        }
+    const QVector<int> &updateIndices = cache->updateIndices();
+    const int updateSize = updateIndices.size();
 
-        pos++;
+    QVector<int> positions;
+    positions.reserve(updateSize);
+    for (int i = 0; i < updateSize; i++) {
+        int index = updateIndices.at(i);
+        if (renderArray.at(index).isVisible())
+            positions.append(cache->bufferIndices().at(index));
     }
-
-    return pos;
+    return positions;
 }
 
 void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal dotScale)
 {
-    ObjectHelper *dotObj = cache->object();
+    ObjectHelper *dotObj = cache->seriesLodObject();
     const ScatterRenderItemArray &renderArray = cache->renderArray();
     const bool updateAll = (cache->updateIndices().size() == 0);
     const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
@@ -339,6 +373,12 @@ void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal do
     QVector<QVector3D> buffered_vertices;
     buffered_vertices.resize(verticeCount * updateSize);
 
+    // Range gradient UVs follow the item Y-coordinate
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+    const int uvsCount = rangeGradient ? dotObj->indexedUVs().count() : 0;
+    QVector<QVector2D> buffered_uvs;
+    buffered_uvs.resize(uvsCount * updateSize);
+
     int itemCount = 0;
     for (int i = 0; i < updateSize; i++) {
         int index = updateAll ? i : cache->updateIndices().at(i);
@@ -360,25 +400,39 @@ void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal do
                 buffered_vertices[j + offset] = indexed_vertices[j] * modelMatrix
                         + item.translation();
         }
+        if (rangeGradient) {
+            gradientUVs(Q3DTheme::ColorStyleRangeGradient, 0, item.translation().y(),
+                        buffered_uvs.data() + itemCount * uvsCount, uvsCount);
+        }
         itemCount++;
     }
 
+    QVector<int> positions;
+    if (!updateAll)
+        positions = visibleBufferPositions(cache);
+
     glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
     int sizeOfItem = verticeCount * sizeof(QVector3D);
     if (updateAll) {
         if (itemCount) {
-            glBufferData(GL_ARRAY_BUFFER, itemCount * sizeOfItem,
-                         &buffered_vertices.at(0), GL_STATIC_DRAW);
+            m_uploader.bufferData(GL_ARRAY_BUFFER, itemCount * sizeOfItem,
+                                  &buffered_vertices.at(0), GL_STATIC_DRAW);
         }
     } else {
-        itemCount = 0;
-        for (int i = 0; i < updateSize; i++) {
-            int index = updateAll ? i : cache->updateIndices().at(i);
-            if (renderArray.at(index).isVisible()) {
-                glBufferSubData(GL_ARRAY_BUFFER, cache->bufferIndices().at(index) * sizeOfItem,
-                                sizeOfItem, &buffered_vertices.at(itemCount * verticeCount));
-                itemCount++;
+        m_uploader.uploadPackedItems(GL_ARRAY_BUFFER, buffered_vertices.constData(), sizeOfItem,
+                                     positions);
+    }
+    if (rangeGradient) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
+        int sizeOfItemUVs = uvsCount * sizeof(QVector2D);
+        if (updateAll) {
+            if (itemCount) {
+                m_uploader.bufferData(GL_ARRAY_BUFFER, itemCount * sizeOfItemUVs,
+                                      &buffered_uvs.at(0), GL_STATIC_DRAW);
             }
+        } else {
+            m_uploader.uploadPackedItems(GL_ARRAY_BUFFER, buffered_uvs.constData(),
+                                         sizeOfItemUVs, positions);
         }
     }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
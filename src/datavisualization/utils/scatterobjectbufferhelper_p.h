@@ -43,6 +43,7 @@
 #include "datavisualizationglobal_p.h"
 #include "abstractobjecthelper_p.h"
 #include "scatterseriesrendercache_p.h"
+#include "bufferuploadhelper_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -55,16 +56,11 @@ public:
     void fullLoad(ScatterSeriesRenderCache *cache, qreal dotScale);
     void update(ScatterSeriesRenderCache *cache, qreal dotScale);
     void updateUVs(ScatterSeriesRenderCache *cache);
-    void setScaleY(float scale) { m_scaleY = scale; }
+    void setUploadStats(BufferUploadStats *stats) { m_uploader.setStats(stats); }
 
 private:
-    uint createRangeGradientUVs(ScatterSeriesRenderCache *cache,
-                                QVector<QVector2D> &buffered_uvs);
-    uint createObjectGradientUVs(ScatterSeriesRenderCache *cache,
-                                 QVector<QVector2D> &buffered_uvs,
-                                 const QVector<QVector3D> &indexed_vertices);
-
-    float m_scaleY;
+    QVector<int> visibleBufferPositions(ScatterSeriesRenderCache *cache);
+    BufferUploadHelper m_uploader;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
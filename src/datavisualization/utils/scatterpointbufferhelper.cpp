@@ -28,7 +28,8 @@
 ****************************************************************************/
 
 #include "scatterpointbufferhelper_p.h"
-#include <QtGui/QVector2D>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -93,10 +94,8 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
     if (m_meshDataLoaded) {
         // Delete old data
         glDeleteBuffers(1, &m_pointbuffer);
-        glDeleteBuffers(1, &m_uvbuffer);
         m_bufferedPoints.clear();
         m_pointbuffer = 0;
-        m_uvbuffer = 0;
     }
 
     bool itemsVisible = false;
@@ -111,27 +110,14 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
         }
     }
 
-    QVector<QVector2D> buffered_uvs;
     if (itemsVisible)
         m_indexCount = renderArraySize;
 
     if (m_indexCount > 0) {
-        if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-            createRangeGradientUVs(cache, buffered_uvs);
-
         glGenBuffers(1, &m_pointbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
-        glBufferData(GL_ARRAY_BUFFER, m_bufferedPoints.size() * sizeof(QVector3D),
-                     &m_bufferedPoints.at(0),
-                     GL_DYNAMIC_DRAW);
-
-        if (buffered_uvs.size()) {
-            glGenBuffers(1, &m_uvbuffer);
-            glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
-            glBufferData(GL_ARRAY_BUFFER, buffered_uvs.size() * sizeof(QVector2D),
-                         &buffered_uvs.at(0), GL_STATIC_DRAW);
-        }
-
+        m_uploader.bufferData(GL_ARRAY_BUFFER, m_bufferedPoints.size() * sizeof(QVector3D),
+                              &m_bufferedPoints.at(0), GL_DYNAMIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         m_meshDataLoaded = true;
@@ -142,76 +128,40 @@ void ScatterPointBufferHelper::update(ScatterSeriesRenderCache *cache)
 {
     // It may be that the buffer hasn't yet been initialized, in case the entire series was
     // hidden items. No need to update in that case.
+    // Update indices are expected sorted, empty indices update all points.
     if (m_indexCount > 0) {
         const ScatterRenderItemArray &renderArray = cache->renderArray();
-        const int updateSize = cache->updateIndices().size();
+        const QVector<int> &updateIndices = cache->updateIndices();
+        const bool updateAll = updateIndices.isEmpty();
+        const int updateSize = updateAll ? renderArray.size() : updateIndices.size();
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
         for (int i = 0; i < updateSize; i++) {
-            int index = cache->updateIndices().at(i);
+            int index = updateAll ? i : updateIndices.at(i);
             const ScatterRenderItem &item = renderArray.at(index);
             if (!item.isVisible())
                 m_bufferedPoints[index] = hiddenPos;
             else
                 m_bufferedPoints[index] = item.translation();
-
-            if (index != m_oldRemoveIndex) {
-                glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector3D),
-                                sizeof(QVector3D), &m_bufferedPoints.at(index));
-            }
         }
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
-}
 
-void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
-{
-    // It may be that the buffer hasn't yet been initialized, in case the entire series was
-    // hidden items. No need to update in that case.
-    if (m_indexCount > 0) {
-        QVector<QVector2D> buffered_uvs;
-        createRangeGradientUVs(cache, buffered_uvs);
-
-        if (buffered_uvs.size()) {
-            if (!m_uvbuffer)
-                glGenBuffers(1, &m_uvbuffer);
-
-            int updateSize = cache->updateIndices().size();
-            glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
-            if (updateSize) {
-                for (int i = 0; i < updateSize; i++) {
-                    int index = cache->updateIndices().at(i);
-                    glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector2D),
-                                    sizeof(QVector2D), &buffered_uvs.at(i));
-
-                }
-            } else {
-                glBufferData(GL_ARRAY_BUFFER, buffered_uvs.size() * sizeof(QVector2D),
-                             &buffered_uvs.at(0), GL_STATIC_DRAW);
-            }
-
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
+        if (updateAll) {
+            m_uploader.bufferData(GL_ARRAY_BUFFER, m_bufferedPoints.size() * sizeof(QVector3D),
+                                  &m_bufferedPoints.at(0), GL_DYNAMIC_DRAW);
+        } else {
+            m_uploader.uploadItems(GL_ARRAY_BUFFER, m_bufferedPoints.constData(),
+                                   sizeof(QVector3D), updateIndices);
         }
-    }
-}
 
-void ScatterPointBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache *cache,
-                                                      QVector<QVector2D> &buffered_uvs)
-{
-    const ScatterRenderItemArray &renderArray = cache->renderArray();
-    const bool updateAll = (cache->updateIndices().size() == 0);
-    const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
-    buffered_uvs.resize(updateSize);
-
-    QVector2D uv;
-    uv.setX(0.0f);
-    for (int i = 0; i < updateSize; i++) {
-        int index = updateAll ? i : cache->updateIndices().at(i);
-        const ScatterRenderItem &item = renderArray.at(index);
-
-        float y = ((item.translation().y() + m_scaleY) * 0.5f) / m_scaleY;
-        uv.setY(y);
-        buffered_uvs[i] = uv;
+        // Keep the pushed point hidden
+        if (m_oldRemoveIndex >= 0
+                && (updateAll || std::binary_search(updateIndices.constBegin(),
+                                                    updateIndices.constEnd(),
+                                                    m_oldRemoveIndex))) {
+            glBufferSubData(GL_ARRAY_BUFFER, m_oldRemoveIndex * sizeof(QVector3D),
+                            sizeof(QVector3D), &hiddenPos);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 }
 
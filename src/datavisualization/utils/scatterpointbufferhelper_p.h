@@ -43,6 +43,7 @@
 #include "datavisualizationglobal_p.h"
 #include "abstractobjecthelper_p.h"
 #include "scatterseriesrendercache_p.h"
+#include "bufferuploadhelper_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -58,20 +59,15 @@ public:
     void popPoint();
     void load(ScatterSeriesRenderCache *cache);
     void update(ScatterSeriesRenderCache *cache);
-    void setScaleY(float scale) { m_scaleY = scale; }
-    void updateUVs(ScatterSeriesRenderCache *cache);
+    void setUploadStats(BufferUploadStats *stats) { m_uploader.setStats(stats); }
 
 public:
     GLuint m_pointbuffer;
 
-private:
-    void createRangeGradientUVs(ScatterSeriesRenderCache *cache,
-                                QVector<QVector2D> &buffered_uvs);
-
 private:
     QVector<QVector3D> m_bufferedPoints;
     int m_oldRemoveIndex;
-    float m_scaleY;
+    BufferUploadHelper m_uploader;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatterspatialindex_p.h"
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Special values of m_itemCells
+const int hiddenCell = -1;
+const int movedCell = -2;
+
+// Average number of items per cell the grid is sized for
+const int itemsPerCell = 32;
+const int maxGridSize = 32;
+
+// Fraction of moved items at which the grid is rebuilt
+const int movedItemDivisor = 8;
+
+ScatterSpatialIndex::ScatterSpatialIndex()
+    : m_dirty(true)
+{
+    m_gridSize[0] = m_gridSize[1] = m_gridSize[2] = 0;
+}
+
+void ScatterSpatialIndex::build(const ScatterRenderItemArray &renderArray)
+{
+    const int itemCount = renderArray.size();
+
+    m_dirty = false;
+    m_movedItems.clear();
+    m_itemCells.fill(hiddenCell, itemCount);
+
+    // Resolve the bounds of visible items
+    QVector3D minBounds;
+    QVector3D maxBounds;
+    int visibleCount = 0;
+    for (int i = 0; i < itemCount; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
+        if (!item.isVisible())
+            continue;
+        const QVector3D &translation = item.translation();
+        if (visibleCount++) {
+            for (int axis = 0; axis < 3; axis++) {
+                minBounds[axis] = qMin(minBounds[axis], translation[axis]);
+                maxBounds[axis] = qMax(maxBounds[axis], translation[axis]);
+            }
+        } else {
+            minBounds = translation;
+            maxBounds = translation;
+        }
+    }
+
+    const int gridSize = qBound(1, int(qPow(qreal(visibleCount / itemsPerCell), 1.0 / 3.0)),
+                                maxGridSize);
+    const QVector3D extents = maxBounds - minBounds;
+    int cellCount = 1;
+    for (int axis = 0; axis < 3; axis++) {
+        // Flat dimensions get a single cell
+        m_gridSize[axis] = (extents[axis] > 0.0f) ? gridSize : 1;
+        m_cellSize[axis] = (extents[axis] > 0.0f) ? extents[axis] / float(gridSize) : 1.0f;
+        cellCount *= m_gridSize[axis];
+    }
+    m_minBounds = minBounds;
+
+    // Count the items of each cell, then place the items in ascending order within the cells
+    m_cellStart.fill(0, cellCount + 1);
+    for (int i = 0; i < itemCount; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
+        if (item.isVisible()) {
+            const int cell = cellIndex(item.translation());
+            m_itemCells[i] = cell;
+            m_cellStart[cell + 1]++;
+        }
+    }
+    for (int cell = 0; cell < cellCount; cell++)
+        m_cellStart[cell + 1] += m_cellStart[cell];
+
+    m_cellItems.resize(visibleCount);
+    QVector<int> cellFill(m_cellStart);
+    for (int i = 0; i < itemCount; i++) {
+        const int cell = m_itemCells.at(i);
+        if (cell != hiddenCell)
+            m_cellItems[cellFill[cell]++] = i;
+    }
+}
+
+void ScatterSpatialIndex::updateItem(int index, const ScatterRenderItem &item)
+{
+    // Hidden items are skipped by the callers, so they can keep their cells
+    if (m_dirty || !item.isVisible())
+        return;
+
+    int &currentCell = m_itemCells[index];
+    const int cell = cellIndex(item.translation());
+    if (cell >= 0 && cell == currentCell)
+        return;
+
+    if (currentCell != movedCell) {
+        currentCell = movedCell;
+        m_movedItems.append(index);
+        if (m_movedItems.size() > m_itemCells.size() / movedItemDivisor)
+            m_dirty = true;
+    }
+}
+
+void ScatterSpatialIndex::findVisibleItems(const ScatterRenderItemArray &renderArray,
+                                           const QMatrix4x4 &projectionViewMatrix, float margin,
+                                           int includedIndex, QVector<int> &indices) const
+{
+    indices.clear();
+
+    // Frustum planes as (a, b, c, d), where points inside have a * x + b * y + c * z + d >= 0
+    QVector4D planes[6];
+    const QVector4D row3 = projectionViewMatrix.row(3);
+    for (int i = 0; i < 3; i++) {
+        const QVector4D row = projectionViewMatrix.row(i);
+        planes[i * 2] = row3 + row;
+        planes[i * 2 + 1] = row3 - row;
+    }
+
+    const QVector3D marginVector(margin, margin, margin);
+    int cell = 0;
+    for (int z = 0; z < m_gridSize[2]; z++) {
+        for (int y = 0; y < m_gridSize[1]; y++) {
+            for (int x = 0; x < m_gridSize[0]; x++, cell++) {
+                const int cellBegin = m_cellStart.at(cell);
+                const int cellEnd = m_cellStart.at(cell + 1);
+                if (cellBegin == cellEnd)
+                    continue;
+
+                const QVector3D cellMin = m_minBounds + m_cellSize * QVector3D(x, y, z)
+                        - marginVector;
+                const QVector3D cellMax = cellMin + m_cellSize + 2.0f * marginVector;
+                bool outside = false;
+                for (int i = 0; i < 6 && !outside; i++) {
+                    // Test the corner furthest along the plane normal
+                    const QVector4D &plane = planes[i];
+                    const float distance =
+                            plane.x() * (plane.x() > 0.0f ? cellMax.x() : cellMin.x())
+                            + plane.y() * (plane.y() > 0.0f ? cellMax.y() : cellMin.y())
+                            + plane.z() * (plane.z() > 0.0f ? cellMax.z() : cellMin.z())
+                            + plane.w();
+                    outside = (distance < 0.0f);
+                }
+                if (outside)
+                    continue;
+
+                for (int i = cellBegin; i < cellEnd; i++) {
+                    const int index = m_cellItems.at(i);
+                    if (m_itemCells.at(index) == cell && index != includedIndex)
+                        indices.append(index);
+                }
+            }
+        }
+    }
+
+    // Moved items are tested individually as spheres with margin radius
+    float planeMargins[6];
+    for (int i = 0; i < 6; i++)
+        planeMargins[i] = -margin * planes[i].toVector3D().length();
+    for (int i = 0; i < m_movedItems.size(); i++) {
+        const int index = m_movedItems.at(i);
+        if (index == includedIndex)
+            continue;
+        const QVector4D position(renderArray.at(index).translation(), 1.0f);
+        bool outside = false;
+        for (int j = 0; j < 6 && !outside; j++)
+            outside = (QVector4D::dotProduct(planes[j], position) < planeMargins[j]);
+        if (!outside)
+            indices.append(index);
+    }
+
+    if (includedIndex >= 0 && includedIndex < m_itemCells.size())
+        indices.append(includedIndex);
+}
+
+int ScatterSpatialIndex::cellIndex(const QVector3D &translation) const
+{
+    int cell = 0;
+    int stride = 1;
+    for (int axis = 0; axis < 3; axis++) {
+        const float position = (translation[axis] - m_minBounds[axis]) / m_cellSize[axis];
+        if (position < 0.0f || position > float(m_gridSize[axis]))
+            return hiddenCell;
+        const int axisCell = qMin(int(position), m_gridSize[axis] - 1);
+        cell += axisCell * stride;
+        stride *= m_gridSize[axis];
+    }
+    return cell;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERSPATIALINDEX_P_H
+#define SCATTERSPATIALINDEX_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+#include <QtGui/QMatrix4x4>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Uniform grid over the render item translations of a scatter series, used for culling the
+// items outside the view frustum. Items that move to another cell after the grid is built are
+// kept in a separate list and tested individually, until there are enough of them to warrant
+// rebuilding the grid. Items outside the axis ranges are not visible, so they are not in any
+// cell.
+class ScatterSpatialIndex
+{
+public:
+    ScatterSpatialIndex();
+
+    void build(const ScatterRenderItemArray &renderArray);
+    void updateItem(int index, const ScatterRenderItem &item);
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+
+    // Collects the indices of the items that may intersect the frustum of the projectionView
+    // matrix, when expanded by margin. The item at includedIndex is collected regardless.
+    void findVisibleItems(const ScatterRenderItemArray &renderArray,
+                          const QMatrix4x4 &projectionViewMatrix, float margin, int includedIndex,
+                          QVector<int> &indices) const;
+
+private:
+    int cellIndex(const QVector3D &translation) const;
+
+    bool m_dirty;
+    int m_gridSize[3];
+    QVector3D m_minBounds;
+    QVector3D m_cellSize;
+    QVector<int> m_cellStart; // Start of each cell in m_cellItems, with an end marker
+    QVector<int> m_cellItems; // Item indices sorted by cell
+    QVector<int> m_itemCells; // Cell of each item in m_cellItems, or one of the special values
+    QVector<int> m_movedItems;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -55,6 +55,9 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_positionAttr(0),
       m_uvAttr(0),
       m_normalAttr(0),
+      m_instancePositionAttr(0),
+      m_instanceRotationAttr(0),
+      m_instanceGradientAttr(0),
       m_colorUniform(0),
       m_viewMatrixUniform(0),
       m_modelMatrixUniform(0),
@@ -81,6 +84,9 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_minBoundsUniform(0),
       m_maxBoundsUniform(0),
       m_sliceFrameWidthUniform(0),
+      m_heightSamplerUniform(0),
+      m_heightfieldRectUniform(0),
+      m_heightfieldSizeUniform(0),
       m_initialized(false)
 {
 }
@@ -118,6 +124,9 @@ void ShaderHelper::initialize()
     m_positionAttr = m_program->attributeLocation("vertexPosition_mdl");
     m_normalAttr = m_program->attributeLocation("vertexNormal_mdl");
     m_uvAttr = m_program->attributeLocation("vertexUV");
+    m_instancePositionAttr = m_program->attributeLocation("instancePosition_wrld");
+    m_instanceRotationAttr = m_program->attributeLocation("instanceRotation");
+    m_instanceGradientAttr = m_program->attributeLocation("instanceGradient");
 
     m_mvpMatrixUniform = m_program->uniformLocation("MVP");
     m_viewMatrixUniform = m_program->uniformLocation("V");
@@ -145,6 +154,9 @@ void ShaderHelper::initialize()
     m_minBoundsUniform = m_program->uniformLocation("minBounds");
     m_maxBoundsUniform = m_program->uniformLocation("maxBounds");
     m_sliceFrameWidthUniform = m_program->uniformLocation("sliceFrameWidth");
+    m_heightSamplerUniform = m_program->uniformLocation("heightSampler");
+    m_heightfieldRectUniform = m_program->uniformLocation("heightfieldRect");
+    m_heightfieldSizeUniform = m_program->uniformLocation("heightfieldSize");
     m_initialized = true;
 }
 
@@ -395,6 +407,27 @@ GLint ShaderHelper::sliceFrameWidth()
     return m_sliceFrameWidthUniform;
 }
 
+GLint ShaderHelper::heightSampler()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightSamplerUniform;
+}
+
+GLint ShaderHelper::heightfieldRect()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightfieldRectUniform;
+}
+
+GLint ShaderHelper::heightfieldSize()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightfieldSizeUniform;
+}
+
 GLint ShaderHelper::posAtt()
 {
     if (!m_initialized)
@@ -416,4 +449,25 @@ GLint ShaderHelper::normalAtt()
     return m_normalAttr;
 }
 
+GLint ShaderHelper::instancePosAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instancePositionAttr;
+}
+
+GLint ShaderHelper::instanceRotationAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceRotationAttr;
+}
+
+GLint ShaderHelper::instanceGradientAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceGradientAttr;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -97,10 +97,16 @@ class ShaderHelper
     GLint maxBounds();
     GLint minBounds();
     GLint sliceFrameWidth();
+    GLint heightSampler();
+    GLint heightfieldRect();
+    GLint heightfieldSize();
 
     GLint posAtt();
     GLint uvAtt();
     GLint normalAtt();
+    GLint instancePosAtt();
+    GLint instanceRotationAtt();
+    GLint instanceGradientAtt();
 
     private:
     QObject *m_caller;
@@ -115,6 +121,9 @@ class ShaderHelper
     GLint m_positionAttr;
     GLint m_uvAttr;
     GLint m_normalAttr;
+    GLint m_instancePositionAttr;
+    GLint m_instanceRotationAttr;
+    GLint m_instanceGradientAttr;
 
     GLint m_colorUniform;
     GLint m_viewMatrixUniform;
@@ -142,6 +151,9 @@ class ShaderHelper
     GLint m_minBoundsUniform;
     GLint m_maxBoundsUniform;
     GLint m_sliceFrameWidthUniform;
+    GLint m_heightSamplerUniform;
+    GLint m_heightfieldRectUniform;
+    GLint m_heightfieldSizeUniform;
 
     GLboolean m_initialized;
 };
@@ -29,11 +29,161 @@
 
 #include "surfaceobject_p.h"
 #include "surface3drenderer_p.h"
+#include "parallelrangejob_p.h"
 
 #include <QtGui/QVector2D>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+// Above this fraction of dirty rows the whole buffers are uploaded instead
+const float fullUploadFraction = 0.5f;
+// Level of detail blocks are this many quads wide, which must be a power of two.
+// Each level doubles the sample step, up to one quad covering the whole block.
+const int lodChunkSize = 64;
+const int lodLevelCount = 7;
+// Minimum number of samples set up as a single band. Surfaces with fewer than two bands are
+// set up on the calling thread alone, as handing them over to the thread pool would cost more
+// than it saves.
+const int minSetUpBandSamples = 128 * 256;
+// Minimum number of rows set up as a single band
+const int minSetUpBandSize = 16;
+// Heightfield grid positions may differ from the uniform grid by this fraction of the extent
+const float heightfieldGridTolerance = 0.0001f;
+
+// Returns the positions from start to end with the given step. The last step is shorter
+// if the span is not divisible by the step.
+static inline void lodPositions(QVector<int> &positions, int start, int end, int step)
+{
+    positions.clear();
+    for (int i = start; i < end; i += step)
+        positions.append(i);
+    positions.append(end);
+}
+
+// Moves a position on a finer seam to the nearest position on a coarser seam
+static inline int lodSnap(int position, int start, int end, int step)
+{
+    int low = start + ((position - start) / step) * step;
+    int high = qMin(low + step, end);
+    return (position - low <= high - position) ? low : high;
+}
+
+// Collects the Y range of the vertices set up by the bands of a vertex pass
+class SurfaceVertexJob : public ParallelRangeJob
+{
+public:
+    SurfaceVertexJob(SurfaceObject *object, const QSurfaceDataArray &dataArray,
+                     QVector3D *vertices, QVector2D *uvs, bool polar, bool flipXZ)
+        : m_object(object),
+          m_dataArray(dataArray),
+          m_vertices(vertices),
+          m_uvs(uvs),
+          m_polar(polar),
+          m_flipXZ(flipXZ),
+          m_minY(10000000.0f),
+          m_maxY(-10000000.0f)
+    {
+    }
+
+    inline float minY() const { return m_minY; }
+    inline float maxY() const { return m_maxY; }
+
+protected:
+    void addBandRange(float minY, float maxY)
+    {
+        QMutexLocker locker(&m_rangeMutex);
+        m_minY = qMin(minY, m_minY);
+        m_maxY = qMax(maxY, m_maxY);
+    }
+
+    SurfaceObject *m_object;
+    const QSurfaceDataArray &m_dataArray;
+    QVector3D *m_vertices;
+    QVector2D *m_uvs;
+    bool m_polar;
+    bool m_flipXZ;
+
+private:
+    QMutex m_rangeMutex;
+    float m_minY;
+    float m_maxY;
+};
+
+class SurfaceSmoothVertexJob : public SurfaceVertexJob
+{
+public:
+    SurfaceSmoothVertexJob(SurfaceObject *object, const QSurfaceDataArray &dataArray,
+                           QVector3D *vertices, QVector2D *uvs, bool polar, bool flipXZ)
+        : SurfaceVertexJob(object, dataArray, vertices, uvs, polar, flipXZ)
+    {
+    }
+
+protected:
+    void processRange(int begin, int end)
+    {
+        float minY = 10000000.0f;
+        float maxY = -10000000.0f;
+        m_object->setUpSmoothVertexRows(m_dataArray, m_vertices, m_uvs, m_polar, m_flipXZ,
+                                        begin, end, minY, maxY);
+        addBandRange(minY, maxY);
+    }
+};
+
+class SurfaceFlatVertexJob : public SurfaceVertexJob
+{
+public:
+    SurfaceFlatVertexJob(SurfaceObject *object, const QSurfaceDataArray &dataArray,
+                         QVector3D *vertices, QVector2D *uvs, bool polar, bool flipXZ)
+        : SurfaceVertexJob(object, dataArray, vertices, uvs, polar, flipXZ)
+    {
+    }
+
+protected:
+    void processRange(int begin, int end)
+    {
+        float minY = 10000000.0f;
+        float maxY = -10000000.0f;
+        m_object->setUpFlatVertexRows(m_dataArray, m_vertices, m_uvs, m_polar, m_flipXZ,
+                                      begin, end, minY, maxY);
+        addBandRange(minY, maxY);
+    }
+};
+
+class SurfaceSmoothNormalJob : public ParallelRangeJob
+{
+public:
+    SurfaceSmoothNormalJob(SurfaceObject *object) : m_object(object) {}
+
+protected:
+    void processRange(int begin, int end)
+    {
+        m_object->createSmoothNormalRows(begin, end);
+    }
+
+private:
+    SurfaceObject *m_object;
+};
+
+class SurfaceFlatNormalJob : public ParallelRangeJob
+{
+public:
+    SurfaceFlatNormalJob(SurfaceObject *object, GLint *indices)
+        : m_object(object),
+          m_indices(indices)
+    {
+    }
+
+protected:
+    void processRange(int begin, int end)
+    {
+        m_object->createFlatNormalRows(m_indices, begin, end);
+    }
+
+private:
+    SurfaceObject *m_object;
+    GLint *m_indices;
+};
+
 SurfaceObject::SurfaceObject(Surface3DRenderer *renderer)
     : m_surfaceType(Undefined),
       m_columns(0),
@@ -45,7 +195,15 @@ SurfaceObject::SurfaceObject(Surface3DRenderer *renderer)
       m_renderer(renderer),
       m_returnTextureBuffer(false),
       m_dataDimension(0),
-      m_oldDataDimension(-1)
+      m_oldDataDimension(-1),
+      m_lodThreshold(0.0f),
+      m_lodChunkColumns(0),
+      m_lodChunkRows(0),
+      m_lodChunksDirty(true),
+      m_lodIndicesActive(false),
+      m_heightfieldEnabled(false),
+      m_heightfield(false),
+      m_heightTexture(0)
 {
     glGenBuffers(1, &m_vertexbuffer);
     glGenBuffers(1, &m_normalbuffer);
@@ -60,6 +218,7 @@ SurfaceObject::~SurfaceObject()
     if (QOpenGLContext::currentContext()) {
         glDeleteBuffers(1, &m_gridElementbuffer);
         glDeleteBuffers(1, &m_uvTextureBuffer);
+        deleteHeightTexture();
     }
 }
 
@@ -69,8 +228,6 @@ void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QR
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns;
-    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
-    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
 
     m_surfaceType = SurfaceSmooth;
 
@@ -87,56 +244,112 @@ void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QR
     QVector<QVector2D> uvs;
     if (changeGeometry)
         uvs.resize(totalSize);
-    int totalIndex = 0;
 
     // Init min and max to ridiculous values
     m_minY = 10000000.0;
     m_maxY = -10000000.0f;
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &p = *dataArray.at(i);
-        for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(p.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
-            totalIndex++;
-        }
-    }
+    setUpVertices(new SurfaceSmoothVertexJob(this, dataArray, m_vertices.data(),
+                                             changeGeometry ? uvs.data() : 0, polar, flipXZ));
 
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
-        }
+    // Surfaces on a uniform grid can generate their positions and normals from a height
+    // texture in the vertex shader, so only the heights need to be kept up to date.
+    m_heightfield = m_heightfieldEnabled && !polar && !flipXZ && updateHeightfieldRect();
+    if (m_heightfield) {
+        m_normals.clear();
+    } else {
+        deleteHeightTexture();
+        createSmoothNormals();
     }
 
-    // Create normals
     int rowLimit = m_rows - 1;
     int colLimit = m_columns - 1;
-    if (changeGeometry)
-        m_normals.resize(totalSize);
-
-    totalIndex = 0;
+    if (m_lodThreshold > 0.0f) {
+        // The indices are created from the level of detail blocks before the next draw
+        m_lodChunksDirty = true;
+        m_lodIndicesActive = true;
+    } else {
+        // Create indices table
+        if (changeGeometry || indicesDirty)
+            createSmoothIndices(0, 0, colLimit, rowLimit);
 
-    if ((m_dataDimension == BothAscending) || (m_dataDimension == XDescending)) {
-        for (int row = 0; row < rowLimit; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
-        createSmoothNormalUpperLine(totalIndex);
-    } else { // BothDescending || ZDescending
-        createSmoothNormalUpperLine(totalIndex);
-        for (int row = 1; row < m_rows; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
+        // Create line element indices
+        if (changeGeometry)
+            createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
     }
 
-    // Create indices table
-    if (changeGeometry || indicesDirty)
-        createSmoothIndices(0, 0, colLimit, rowLimit);
+    if (m_heightfield)
+        createHeightfieldBuffers(uvs);
+    else
+        createBuffers(m_vertices, uvs, m_normals, 0);
+}
 
-    // Create line element indices
-    if (changeGeometry)
-        createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
+void SurfaceObject::createSmoothNormals()
+{
+    m_normals.resize(m_rows * m_columns);
+    m_normals.detach(); // Bands write to the normals from several threads
+
+    QSharedPointer<ParallelRangeJob> job(new SurfaceSmoothNormalJob(this));
+    ParallelRangeJob::run(job, m_rows, setUpBandSize());
+}
+
+void SurfaceObject::setUpVertices(SurfaceVertexJob *vertexJob)
+{
+    QSharedPointer<ParallelRangeJob> job(vertexJob);
+
+    // Positions of custom axis formatters are resolved on this thread alone, as the formatters
+    // may not be reentrant. A single band makes the job process all rows here.
+    int bandSize = m_renderer->hasReentrantFormatters() ? setUpBandSize() : m_rows;
+    ParallelRangeJob::run(job, m_rows, bandSize);
+
+    m_minY = qMin(vertexJob->minY(), m_minY);
+    m_maxY = qMax(vertexJob->maxY(), m_maxY);
+}
+
+int SurfaceObject::setUpBandSize() const
+{
+    return qMax(minSetUpBandSize, minSetUpBandSamples / qMax(1, m_columns));
+}
+
+// Normalizes, flips and assigns the grid coordinates of the rows in a single pass
+void SurfaceObject::setUpSmoothVertexRows(const QSurfaceDataArray &dataArray,
+                                          QVector3D *vertices, QVector2D *uvs, bool polar,
+                                          bool flipXZ, int firstRow, int endRow,
+                                          float &minY, float &maxY)
+{
+    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
+    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
+    QVector3D *vertex = vertices + firstRow * m_columns;
+    QVector2D *uv = uvs ? uvs + firstRow * m_columns : 0;
+
+    for (int i = firstRow; i < endRow; i++) {
+        const QSurfaceDataRow &p = *dataArray.at(i);
+        for (int j = 0; j < m_columns; j++, vertex++) {
+            *vertex = normalizedVertex(p.at(j), polar, flipXZ);
+            if (flipXZ) {
+                vertex->setX(-vertex->x());
+                vertex->setZ(-vertex->z());
+            }
+            minY = qMin(vertex->y(), minY);
+            maxY = qMax(vertex->y(), maxY);
+            if (uv)
+                *uv++ = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+        }
+    }
+}
 
-    createBuffers(m_vertices, uvs, m_normals, 0);
+void SurfaceObject::createSmoothNormalRows(int firstRow, int endRow)
+{
+    // The normals of the last row are calculated towards the previous row, or the normals
+    // of the first row towards the next one if the rows are descending.
+    const bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
+    for (int row = firstRow; row < endRow; row++) {
+        int totalIndex = row * m_columns;
+        if (upwards ? (row == m_rows - 1) : (row == 0))
+            createSmoothNormalUpperLine(totalIndex);
+        else
+            createSmoothNormalBodyLine(totalIndex, row * m_columns);
+    }
 }
 
 void SurfaceObject::createSmoothNormalBodyLine(int &totalIndex, int column)
@@ -358,6 +571,15 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
     for (int j = 0; j < m_columns; j++)
         getNormalizedVertex(dataRow.at(j), m_vertices[p++], polar, false);
 
+    if (m_heightfield) {
+        // Only the heights are uploaded, unless the row moved off the grid
+        markRowsDirty(m_dirtyVertexRows, rowIndex, rowIndex + 1);
+        markLodChunksDirty(rowIndex, -1);
+        if (!isHeightfieldRow(rowIndex))
+            leaveHeightfield();
+        return;
+    }
+
     // Create normals
     bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
     int startRow = rowIndex;
@@ -369,6 +591,7 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
     if ((endRow == m_rows - 1) && upwards)
         endRow--;
     int totalIndex = startRow * m_columns;
+    const int normalStartRow = startRow;
 
     if ((startRow == 0) && !upwards) {
         createSmoothNormalUpperLine(totalIndex);
@@ -380,6 +603,10 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
 
     if ((rowIndex == m_rows - 1) && upwards)
         createSmoothNormalUpperLine(totalIndex);
+
+    markRowsDirty(m_dirtyVertexRows, rowIndex, rowIndex + 1);
+    markRowsDirty(m_dirtyNormalRows, normalStartRow, totalIndex / m_columns);
+    markLodChunksDirty(rowIndex, -1);
 }
 
 void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row, int column,
@@ -389,6 +616,14 @@ void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row
     getNormalizedVertex(dataArray.at(row)->at(column),
                         m_vertices[row * m_columns + column], polar, false);
 
+    if (m_heightfield) {
+        markRowsDirty(m_dirtyVertexRows, row, row + 1);
+        markLodChunksDirty(row, column);
+        if (!isHeightfieldRow(row))
+            leaveHeightfield();
+        return;
+    }
+
     // Create normals
     bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
     bool rightwards = (m_dataDimension == BothAscending) || (m_dataDimension == ZDescending);
@@ -418,6 +653,10 @@ void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row
                 m_normals[p] = createSmoothNormalBodyLineItem(j, i);
          }
     }
+
+    markRowsDirty(m_dirtyVertexRows, row, row + 1);
+    markRowsDirty(m_dirtyNormalRows, startRow, endRow + 1);
+    markLodChunksDirty(row, column);
 }
 
 
@@ -526,8 +765,6 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns * 2;
-    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
-    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
 
     checkDirections(dataArray);
     bool indicesDirty = false;
@@ -536,6 +773,11 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     m_oldDataDimension = m_dataDimension;
 
     m_surfaceType = SurfaceFlat;
+    m_heightfield = false;
+    deleteHeightTexture();
+    m_lodChunks.clear();
+    m_lodChunksDirty = true;
+    m_lodIndicesActive = false;
 
     // Create vertix table
     if (changeGeometry)
@@ -545,40 +787,15 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     if (changeGeometry)
         uvs.resize(totalSize);
 
-    int totalIndex = 0;
     int rowLimit = m_rows - 1;
     int colLimit = m_columns - 1;
-    int doubleColumns = m_columns * 2 - 2;
-    int rowColLimit = rowLimit * doubleColumns;
 
     // Init min and max to ridiculous values
     m_minY = 10000000.0;
     m_maxY = -10000000.0f;
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &row = *dataArray.at(i);
-        for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(row.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
-
-            totalIndex++;
-
-            if (j > 0 && j < colLimit) {
-                m_vertices[totalIndex] = m_vertices[totalIndex - 1];
-                if (changeGeometry)
-                    uvs[totalIndex] = uvs[totalIndex - 1];
-                totalIndex++;
-            }
-        }
-    }
-
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
-        }
-    }
+    setUpVertices(new SurfaceFlatVertexJob(this, dataArray, m_vertices.data(),
+                                           changeGeometry ? uvs.data() : 0, polar, flipXZ));
 
     // Create normals & indices table
     GLint *indices = 0;
@@ -588,20 +805,10 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
         indices = new GLint[m_indexCount];
         m_normals.resize(normalCount);
     }
+    m_normals.detach(); // Bands write to the normals from several threads
 
-    int p = 0;
-    totalIndex = 0;
-    for (int row = 0, upperRow = doubleColumns;
-         row < rowColLimit;
-         row += doubleColumns, upperRow += doubleColumns) {
-        for (int j = 0; j < doubleColumns; j += 2) {
-            createNormals(totalIndex, row, upperRow, j);
-
-            if (changeGeometry || indicesDirty) {
-                createCoarseIndices(indices, p, row, upperRow, j);
-            }
-        }
-    }
+    QSharedPointer<ParallelRangeJob> job(new SurfaceFlatNormalJob(this, indices));
+    ParallelRangeJob::run(job, rowLimit, setUpBandSize());
 
     // Create grid line element indices
     if (changeGeometry)
@@ -612,6 +819,64 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     delete[] indices;
 }
 
+// Normalizes, flips and assigns the grid coordinates of the rows in a single pass. The inner
+// vertices of a row are doubled, so that each quad has vertices of its own.
+void SurfaceObject::setUpFlatVertexRows(const QSurfaceDataArray &dataArray,
+                                        QVector3D *vertices, QVector2D *uvs, bool polar,
+                                        bool flipXZ, int firstRow, int endRow,
+                                        float &minY, float &maxY)
+{
+    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
+    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
+    int colLimit = m_columns - 1;
+    int totalIndex = firstRow * (m_columns * 2 - 2);
+
+    for (int i = firstRow; i < endRow; i++) {
+        const QSurfaceDataRow &row = *dataArray.at(i);
+        for (int j = 0; j < m_columns; j++) {
+            QVector3D vertex = normalizedVertex(row.at(j), polar, flipXZ);
+            if (flipXZ) {
+                vertex.setX(-vertex.x());
+                vertex.setZ(-vertex.z());
+            }
+            minY = qMin(vertex.y(), minY);
+            maxY = qMax(vertex.y(), maxY);
+            QVector2D uv(GLfloat(j) * uvX, GLfloat(i) * uvY);
+
+            vertices[totalIndex] = vertex;
+            if (uvs)
+                uvs[totalIndex] = uv;
+            totalIndex++;
+
+            if (j > 0 && j < colLimit) {
+                vertices[totalIndex] = vertex;
+                if (uvs)
+                    uvs[totalIndex] = uv;
+                totalIndex++;
+            }
+        }
+    }
+}
+
+// Creates the normals, and the indices if given, of the quad rows
+void SurfaceObject::createFlatNormalRows(GLint *indices, int firstRow, int endRow)
+{
+    int doubleColumns = m_columns * 2 - 2;
+    int totalIndex = firstRow * doubleColumns;
+    int p = 3 * totalIndex;
+    for (int row = firstRow * doubleColumns, upperRow = row + doubleColumns,
+         rowEnd = endRow * doubleColumns;
+         row < rowEnd;
+         row += doubleColumns, upperRow += doubleColumns) {
+        for (int j = 0; j < doubleColumns; j += 2) {
+            createNormals(totalIndex, row, upperRow, j);
+
+            if (indices)
+                createCoarseIndices(indices, p, row, upperRow, j);
+        }
+    }
+}
+
 void SurfaceObject::coarseUVs(const QSurfaceDataArray &dataArray,
                               const QSurfaceDataArray &modelArray)
 {
@@ -682,12 +947,16 @@ void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowI
     int rowLimit = (rowIndex + 1) * doubleColumns;
     if (rowIndex == m_rows - 1)
         rowLimit = rowIndex * doubleColumns; //Topmost row, no normals
+    const int normalStartRow = p / doubleColumns;
     for (int row = p, upperRow = p + doubleColumns;
          row < rowLimit;
          row += doubleColumns, upperRow += doubleColumns) {
         for (int j = 0; j < doubleColumns; j += 2)
             createNormals(p, row, upperRow, j);
     }
+
+    markRowsDirty(m_dirtyVertexRows, rowIndex, rowIndex + 1);
+    markRowsDirty(m_dirtyNormalRows, normalStartRow, rowLimit / doubleColumns);
 }
 
 void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row, int column,
@@ -702,6 +971,7 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
 
     if (column > 0 && column < colLimit)
         m_vertices[p] = m_vertices[p - 1];
+    markRowsDirty(m_dirtyVertexRows, row, row + 1);
 
     // Create normals
     int startRow = row;
@@ -721,6 +991,63 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
             createNormals(p, i * doubleColumns, (i + 1) * doubleColumns, j * 2);
         }
     }
+    markRowsDirty(m_dirtyNormalRows, startRow, row + 1);
+}
+
+bool SurfaceObject::shiftRows(const QSurfaceDataArray &dataArray, int count, bool polar)
+{
+    // Returns false if the surface needs to be set up again instead
+    if (m_surfaceType == Undefined || dataArray.size() != m_rows || count >= m_rows - 1)
+        return false;
+
+    checkDirections(dataArray);
+    if (m_dataDimension != m_oldDataDimension)
+        return false;
+
+    const bool smooth = (m_surfaceType == SurfaceSmooth);
+    const int rowStride = smooth ? m_columns : m_columns * 2 - 2;
+    const int normalRows = smooth ? m_rows : m_rows - 1;
+    const int shiftSize = count * rowStride;
+
+    if (m_heightfield) {
+        // Every row of the height texture moves, so only the new rows need to be converted
+        QVector3D *vertices = m_vertices.data();
+        memmove(vertices, vertices + shiftSize,
+                (m_rows * rowStride - shiftSize) * sizeof(QVector3D));
+        for (int row = m_rows - count; row < m_rows; row++) {
+            const QSurfaceDataRow &dataRow = *dataArray.at(row);
+            QVector3D *vertex = vertices + row * rowStride;
+            for (int j = 0; j < m_columns; j++)
+                getNormalizedVertex(dataRow.at(j), *vertex++, polar, false);
+        }
+        if (!updateHeightfieldRect())
+            return false;
+        markRowsDirty(m_dirtyVertexRows, 0, m_rows);
+        m_lodChunksDirty = true;
+        return true;
+    }
+
+    // Move the retained rows to the beginning. Their vertices and normals stay valid, except
+    // for the normals next to the new rows, and the normals of the first row if those were
+    // calculated from the row that dropped out.
+    QVector3D *vertices = m_vertices.data();
+    memmove(vertices, vertices + shiftSize,
+            (m_rows * rowStride - shiftSize) * sizeof(QVector3D));
+    QVector3D *normals = m_normals.data();
+    memmove(normals, normals + shiftSize,
+            (normalRows * rowStride - shiftSize) * sizeof(QVector3D));
+
+    for (int row = m_rows - count; row < m_rows; row++) {
+        if (smooth)
+            updateSmoothRow(dataArray, row, polar);
+        else
+            updateCoarseRow(dataArray, row, polar);
+    }
+    if (smooth && m_dataDimension.testFlag(ZDescending))
+        updateSmoothRow(dataArray, 0, polar);
+    m_lodChunksDirty = true;
+
+    return true;
 }
 
 void SurfaceObject::createCoarseSubSection(int x, int y, int columns, int rows)
@@ -810,7 +1137,66 @@ void SurfaceObject::createCoarseGridlineIndices(int x, int y, int endX, int endY
 void SurfaceObject::uploadBuffers()
 {
     QVector<QVector2D> uvs; // Empty dummy
-    createBuffers(m_vertices, uvs, m_normals, 0);
+    if (m_heightfield)
+        createHeightfieldBuffers(uvs);
+    else
+        createBuffers(m_vertices, uvs, m_normals, 0);
+}
+
+// Uploads only the vertex and normal rows changed since the last upload. Row and item
+// updates just mark their rows dirty, so all changes of a frame are flushed together.
+void SurfaceObject::uploadDirtyBuffers()
+{
+    if (!buffersDirty())
+        return;
+
+    if (m_surfaceType == Undefined) {
+        clearDirtyRows();
+        return;
+    }
+
+    BufferUploadHelper::sortIndices(m_dirtyVertexRows);
+    BufferUploadHelper::sortIndices(m_dirtyNormalRows);
+
+    if (m_heightfield) {
+        if (!m_meshDataLoaded
+                || BufferUploadHelper::isFullUploadPreferred(m_dirtyVertexRows.size(), m_rows,
+                                                             fullUploadFraction)) {
+            uploadBuffers();
+            return;
+        }
+        // One upload per run of consecutive rows
+        int start = 0;
+        for (int i = 1; i <= m_dirtyVertexRows.size(); i++) {
+            if (i == m_dirtyVertexRows.size()
+                    || m_dirtyVertexRows.at(i) != m_dirtyVertexRows.at(i - 1) + 1) {
+                uploadHeightRows(m_dirtyVertexRows.at(start), i - start);
+                start = i;
+            }
+        }
+        clearDirtyRows();
+        return;
+    }
+
+    const int rowStride = (m_surfaceType == SurfaceSmooth) ? m_columns : m_columns * 2 - 2;
+    const int normalRows = m_normals.size() / rowStride;
+    if (!m_meshDataLoaded
+            || BufferUploadHelper::isFullUploadPreferred(m_dirtyVertexRows.size(), m_rows,
+                                                         fullUploadFraction)
+            || BufferUploadHelper::isFullUploadPreferred(m_dirtyNormalRows.size(), normalRows,
+                                                         fullUploadFraction)) {
+        uploadBuffers();
+        return;
+    }
+
+    const int rowSize = rowStride * sizeof(QVector3D);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    m_uploader.uploadItems(GL_ARRAY_BUFFER, m_vertices.constData(), rowSize, m_dirtyVertexRows);
+    glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
+    m_uploader.uploadItems(GL_ARRAY_BUFFER, m_normals.constData(), rowSize, m_dirtyNormalRows);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    clearDirtyRows();
 }
 
 void SurfaceObject::createBuffers(const QVector<QVector3D> &vertices, const QVector<QVector2D> &uvs,
@@ -840,9 +1226,135 @@ void SurfaceObject::createBuffers(const QVector<QVector3D> &vertices, const QVec
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    // Everything pending was uploaded with the rest of the buffers
+    clearDirtyRows();
+
     m_meshDataLoaded = true;
 }
 
+void SurfaceObject::createHeightfieldBuffers(const QVector<QVector2D> &uvs)
+{
+    // The uniform grid coordinates are the only vertex attribute of a heightfield
+    if (uvs.size()) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
+        glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(QVector2D),
+                     &uvs.at(0), GL_STATIC_DRAW);
+    }
+
+    // Positions and normals are generated in the vertex shader, so release their storage
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+#if !defined(QT_OPENGL_ES_2)
+    if (!m_heightTexture)
+        glGenTextures(1, &m_heightTexture);
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_columns, m_rows, 0, GL_RED, GL_FLOAT, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+#endif
+    uploadHeightRows(0, m_rows);
+
+    // Everything pending was uploaded with the rest of the buffers
+    clearDirtyRows();
+
+    m_meshDataLoaded = true;
+}
+
+void SurfaceObject::uploadHeightRows(int startRow, int rowCount)
+{
+#if !defined(QT_OPENGL_ES_2)
+    QVector<float> heights(rowCount * m_columns);
+    const QVector3D *vertex = m_vertices.constData() + startRow * m_columns;
+    for (int i = 0; i < heights.size(); i++)
+        heights[i] = vertex[i].y();
+
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, startRow, m_columns, rowCount, GL_RED, GL_FLOAT,
+                    heights.constData());
+    glBindTexture(GL_TEXTURE_2D, 0);
+#else
+    Q_UNUSED(startRow)
+    Q_UNUSED(rowCount)
+#endif
+}
+
+void SurfaceObject::deleteHeightTexture()
+{
+    if (m_heightTexture) {
+        glDeleteTextures(1, &m_heightTexture);
+        m_heightTexture = 0;
+    }
+}
+
+// Takes the heightfield extents from the corner vertices and returns true if all vertices lie
+// on the uniform grid they span
+bool SurfaceObject::updateHeightfieldRect()
+{
+    if (m_columns < 2 || m_rows < 2)
+        return false;
+
+    const QVector3D &first = m_vertices.at(0);
+    const QVector3D &last = m_vertices.at(m_rows * m_columns - 1);
+    m_heightfieldRect = QVector4D(first.x(), first.z(), last.x() - first.x(),
+                                  last.z() - first.z());
+    if (qFuzzyIsNull(m_heightfieldRect.z()) || qFuzzyIsNull(m_heightfieldRect.w()))
+        return false;
+
+    for (int row = 0; row < m_rows; row++) {
+        if (!isHeightfieldRow(row))
+            return false;
+    }
+    return true;
+}
+
+bool SurfaceObject::isHeightfieldRow(int row) const
+{
+    const float tolerance = heightfieldGridTolerance
+            * qMax(qAbs(m_heightfieldRect.z()), qAbs(m_heightfieldRect.w()));
+    const float z = m_heightfieldRect.y() + m_heightfieldRect.w() * float(row) / float(m_rows - 1);
+    const float xStep = m_heightfieldRect.z() / float(m_columns - 1);
+    const QVector3D *vertex = m_vertices.constData() + row * m_columns;
+    for (int j = 0; j < m_columns; j++) {
+        if (qAbs(vertex[j].x() - (m_heightfieldRect.x() + xStep * float(j))) > tolerance
+                || qAbs(vertex[j].z() - z) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Switches back to uploaded positions and normals when the data no longer fits a heightfield
+void SurfaceObject::leaveHeightfield()
+{
+    m_heightfield = false;
+    deleteHeightTexture();
+    createSmoothNormals();
+    uploadBuffers();
+}
+
+void SurfaceObject::markRowsDirty(QVector<int> &dirtyRows, int startRow, int endRow)
+{
+    // Duplicates are dropped when the rows are sorted for upload, but consecutive updates
+    // often hit the same row, so skip those right away.
+    for (int row = startRow; row < endRow; row++) {
+        if (dirtyRows.isEmpty() || dirtyRows.last() != row)
+            dirtyRows.append(row);
+    }
+}
+
+void SurfaceObject::clearDirtyRows()
+{
+    m_dirtyVertexRows.clear();
+    m_dirtyNormalRows.clear();
+}
+
 void SurfaceObject::checkDirections(const QSurfaceDataArray &array)
 {
     m_dataDimension = BothAscending;
@@ -860,6 +1372,15 @@ void SurfaceObject::checkDirections(const QSurfaceDataArray &array)
 
 void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex,
                                         bool polar, bool flipXZ)
+{
+    vertex = normalizedVertex(data, polar, flipXZ);
+    m_minY = qMin(vertex.y(), m_minY);
+    m_maxY = qMax(vertex.y(), m_maxY);
+}
+
+// Doesn't modify the object, so the set up bands can call this from several threads
+QVector3D SurfaceObject::normalizedVertex(const QSurfaceDataItem &data, bool polar,
+                                          bool flipXZ) const
 {
     float normalizedX;
     float normalizedZ;
@@ -876,11 +1397,7 @@ void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D
         }
     }
     float normalizedY = m_axisCacheY.positionAt(data.y());
-    m_minY = qMin(normalizedY, m_minY);
-    m_maxY = qMax(normalizedY, m_maxY);
-    vertex.setX(normalizedX);
-    vertex.setY(normalizedY);
-    vertex.setZ(normalizedZ);
+    return QVector3D(normalizedX, normalizedY, normalizedZ);
 }
 
 GLuint SurfaceObject::gridElementBuf()
@@ -901,6 +1418,13 @@ GLuint SurfaceObject::uvBuf()
         return m_uvbuffer;
 }
 
+GLuint SurfaceObject::heightfieldGridBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_uvbuffer;
+}
+
 GLuint SurfaceObject::gridIndexCount()
 {
     return m_gridIndexCount;
@@ -924,8 +1448,13 @@ void SurfaceObject::clear()
     m_gridIndexCount = 0;
     m_indexCount = 0;
     m_surfaceType = Undefined;
+    m_heightfield = false;
     m_vertices.clear();
     m_normals.clear();
+    clearDirtyRows();
+    m_lodChunks.clear();
+    m_lodChunksDirty = true;
+    m_lodIndicesActive = false;
 }
 
 void SurfaceObject::createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j)
@@ -999,4 +1528,315 @@ QVector3D SurfaceObject::normal(const QVector3D &a, const QVector3D &b, const QV
     return normal;
 }
 
+void SurfaceObject::setLodThreshold(float pixels)
+{
+    if ((pixels > 0.0f) != (m_lodThreshold > 0.0f))
+        m_lodChunksDirty = true;
+    m_lodThreshold = pixels;
+}
+
+// Picks the tessellation level of each block for the current camera and recreates the index
+// buffers if any of the levels changed. The camera position is in the same space as the
+// vertices, and pixelScale converts a geometric error at unit distance to pixels.
+void SurfaceObject::updateLevelOfDetail(const QVector3D &cameraPosition, float pixelScale,
+                                        bool perspective)
+{
+    if (m_surfaceType != SurfaceSmooth || m_rows < 2 || m_columns < 2)
+        return;
+
+    if (m_lodThreshold <= 0.0f) {
+        if (m_lodIndicesActive) {
+            // Go back to the full tessellation
+            createSmoothIndices(0, 0, m_columns - 1, m_rows - 1);
+            createSmoothGridlineIndices(0, 0, m_columns - 1, m_rows - 1);
+            m_lodChunks.clear();
+            m_lodChunksDirty = true;
+            m_lodIndicesActive = false;
+        }
+        return;
+    }
+
+    if (m_lodChunksDirty)
+        createLodChunks();
+
+    // The largest geometric error allowed at unit distance from the camera
+    const float errorScale = m_lodThreshold / pixelScale;
+    bool levelsChanged = false;
+    for (int i = 0; i < m_lodChunks.size(); i++) {
+        LodChunk &chunk = m_lodChunks[i];
+        if (chunk.dirty)
+            updateLodChunk(chunk);
+
+        float maxError = errorScale;
+        if (perspective) {
+            // Distance to the nearest point of the block bounds
+            QVector3D offset(
+                        qMax(qMax(chunk.minBounds.x() - cameraPosition.x(), 0.0f),
+                             cameraPosition.x() - chunk.maxBounds.x()),
+                        qMax(qMax(chunk.minBounds.y() - cameraPosition.y(), 0.0f),
+                             cameraPosition.y() - chunk.maxBounds.y()),
+                        qMax(qMax(chunk.minBounds.z() - cameraPosition.z(), 0.0f),
+                             cameraPosition.z() - chunk.maxBounds.z()));
+            maxError *= offset.length();
+        }
+
+        int level = 0;
+        while (level < lodLevelCount - 1 && chunk.errors.at(level + 1) <= maxError)
+            level++;
+        if (level != chunk.level) {
+            chunk.level = level;
+            levelsChanged = true;
+        }
+    }
+
+    if (levelsChanged) {
+        createLodIndices();
+        m_lodIndicesActive = true;
+    }
+}
+
+void SurfaceObject::createLodChunks()
+{
+    m_lodChunkColumns = (m_columns - 2) / lodChunkSize + 1;
+    m_lodChunkRows = (m_rows - 2) / lodChunkSize + 1;
+    m_lodChunks.resize(m_lodChunkColumns * m_lodChunkRows);
+
+    int i = 0;
+    for (int chunkRow = 0; chunkRow < m_lodChunkRows; chunkRow++) {
+        for (int chunkColumn = 0; chunkColumn < m_lodChunkColumns; chunkColumn++) {
+            LodChunk &chunk = m_lodChunks[i++];
+            chunk.x = chunkColumn * lodChunkSize;
+            chunk.y = chunkRow * lodChunkSize;
+            chunk.endX = qMin(chunk.x + lodChunkSize, m_columns - 1);
+            chunk.endY = qMin(chunk.y + lodChunkSize, m_rows - 1);
+            chunk.level = -1;
+            chunk.dirty = true;
+            chunk.errors.resize(lodLevelCount);
+        }
+    }
+
+    m_lodChunksDirty = false;
+}
+
+// Calculates the bounds of the block and the geometric error of each of its levels. The error
+// of a level is the largest distance of the samples of the previous level from the surface
+// interpolated over the cells of this level, accumulated over the finer levels.
+void SurfaceObject::updateLodChunk(LodChunk &chunk)
+{
+    chunk.minBounds = m_vertices.at(chunk.y * m_columns + chunk.x);
+    chunk.maxBounds = chunk.minBounds;
+    for (int row = chunk.y; row <= chunk.endY; row++) {
+        const QVector3D *vertex = m_vertices.constData() + row * m_columns + chunk.x;
+        for (int column = chunk.x; column <= chunk.endX; column++, vertex++) {
+            chunk.minBounds.setX(qMin(chunk.minBounds.x(), vertex->x()));
+            chunk.minBounds.setY(qMin(chunk.minBounds.y(), vertex->y()));
+            chunk.minBounds.setZ(qMin(chunk.minBounds.z(), vertex->z()));
+            chunk.maxBounds.setX(qMax(chunk.maxBounds.x(), vertex->x()));
+            chunk.maxBounds.setY(qMax(chunk.maxBounds.y(), vertex->y()));
+            chunk.maxBounds.setZ(qMax(chunk.maxBounds.z(), vertex->z()));
+        }
+    }
+
+    QVector<int> columns;
+    QVector<int> rows;
+    chunk.errors[0] = 0.0f;
+    for (int level = 1; level < lodLevelCount; level++) {
+        const int step = 1 << level;
+        float error = chunk.errors.at(level - 1);
+        lodPositions(columns, chunk.x, chunk.endX, step >> 1);
+        lodPositions(rows, chunk.y, chunk.endY, step >> 1);
+        foreach (int row, rows) {
+            int lowRow = chunk.y + ((row - chunk.y) / step) * step;
+            int highRow = qMin(lowRow + step, chunk.endY);
+            float rowFactor = (highRow > lowRow) ? float(row - lowRow) / float(highRow - lowRow)
+                                                 : 0.0f;
+            foreach (int column, columns) {
+                int lowColumn = chunk.x + ((column - chunk.x) / step) * step;
+                if (row == lowRow && column == lowColumn)
+                    continue;
+                int highColumn = qMin(lowColumn + step, chunk.endX);
+                float columnFactor = (highColumn > lowColumn)
+                        ? float(column - lowColumn) / float(highColumn - lowColumn) : 0.0f;
+
+                const QVector3D &lowLeft = m_vertices.at(lowRow * m_columns + lowColumn);
+                const QVector3D &lowRight = m_vertices.at(lowRow * m_columns + highColumn);
+                const QVector3D &highLeft = m_vertices.at(highRow * m_columns + lowColumn);
+                const QVector3D &highRight = m_vertices.at(highRow * m_columns + highColumn);
+                QVector3D low = lowLeft + (lowRight - lowLeft) * columnFactor;
+                QVector3D high = highLeft + (highRight - highLeft) * columnFactor;
+                QVector3D interpolated = low + (high - low) * rowFactor;
+                error = qMax(error, (m_vertices.at(row * m_columns + column)
+                                     - interpolated).length());
+            }
+        }
+        chunk.errors[level] = error;
+    }
+
+    chunk.dirty = false;
+}
+
+// Marks the blocks containing the sample for recalculation. A negative column marks
+// the whole row.
+void SurfaceObject::markLodChunksDirty(int row, int column)
+{
+    if (m_lodThreshold <= 0.0f || m_lodChunksDirty || m_lodChunks.isEmpty())
+        return;
+
+    // Samples on block edges belong to the blocks on both sides
+    const int firstRow = qMax(0, (row - 1) / lodChunkSize);
+    const int lastRow = qMin(m_lodChunkRows - 1, row / lodChunkSize);
+    int firstColumn = 0;
+    int lastColumn = m_lodChunkColumns - 1;
+    if (column >= 0) {
+        firstColumn = qMax(0, (column - 1) / lodChunkSize);
+        lastColumn = qMin(m_lodChunkColumns - 1, column / lodChunkSize);
+    }
+
+    for (int i = firstRow; i <= lastRow; i++) {
+        for (int j = firstColumn; j <= lastColumn; j++)
+            m_lodChunks[i * m_lodChunkColumns + j].dirty = true;
+    }
+}
+
+// Creates the triangle and grid line indices of all the blocks at their current levels.
+// A seam between two blocks uses the coarser step of the two. The finer block snaps its
+// seam samples to the coarser ones, so that its seam triangles fan out to the same edges
+// the coarser block has and no gaps open between them.
+void SurfaceObject::createLodIndices()
+{
+    QVector<GLint> indices;
+    QVector<GLint> gridIndices;
+    QVector<int> columns;
+    QVector<int> rows;
+    QVector<int> linePositions;
+
+    for (int chunkRow = 0; chunkRow < m_lodChunkRows; chunkRow++) {
+        for (int chunkColumn = 0; chunkColumn < m_lodChunkColumns; chunkColumn++) {
+            const LodChunk &chunk = m_lodChunks.at(chunkRow * m_lodChunkColumns + chunkColumn);
+            const int step = 1 << chunk.level;
+
+            // Left, right, bottom and top seam steps
+            int seamSteps[4] = { step, step, step, step };
+            if (chunkColumn > 0) {
+                seamSteps[0] = qMax(step, 1 << m_lodChunks.at(chunkRow * m_lodChunkColumns
+                                                              + chunkColumn - 1).level);
+            }
+            if (chunkColumn < m_lodChunkColumns - 1) {
+                seamSteps[1] = qMax(step, 1 << m_lodChunks.at(chunkRow * m_lodChunkColumns
+                                                              + chunkColumn + 1).level);
+            }
+            if (chunkRow > 0) {
+                seamSteps[2] = qMax(step, 1 << m_lodChunks.at((chunkRow - 1) * m_lodChunkColumns
+                                                              + chunkColumn).level);
+            }
+            if (chunkRow < m_lodChunkRows - 1) {
+                seamSteps[3] = qMax(step, 1 << m_lodChunks.at((chunkRow + 1) * m_lodChunkColumns
+                                                              + chunkColumn).level);
+            }
+
+            lodPositions(columns, chunk.x, chunk.endX, step);
+            lodPositions(rows, chunk.y, chunk.endY, step);
+            for (int i = 0; i < rows.size() - 1; i++) {
+                for (int j = 0; j < columns.size() - 1; j++) {
+                    appendSmoothQuad(indices,
+                                     lodVertexIndex(chunk, seamSteps, columns.at(j), rows.at(i)),
+                                     lodVertexIndex(chunk, seamSteps, columns.at(j + 1),
+                                                    rows.at(i)),
+                                     lodVertexIndex(chunk, seamSteps, columns.at(j),
+                                                    rows.at(i + 1)),
+                                     lodVertexIndex(chunk, seamSteps, columns.at(j + 1),
+                                                    rows.at(i + 1)));
+                }
+            }
+
+            // Grid lines follow the snapped triangle edges. The lines on the top and right
+            // seams belong to the next blocks.
+            const int lastRow = (chunkRow < m_lodChunkRows - 1) ? rows.size() - 1 : rows.size();
+            for (int i = 0; i < lastRow; i++) {
+                int row = rows.at(i);
+                int lineStep = (i == 0) ? seamSteps[2] : step;
+                lodPositions(linePositions, chunk.x, chunk.endX, lineStep);
+                for (int j = 0; j < linePositions.size() - 1; j++) {
+                    gridIndices.append(lodVertexIndex(chunk, seamSteps, linePositions.at(j),
+                                                      row));
+                    gridIndices.append(lodVertexIndex(chunk, seamSteps, linePositions.at(j + 1),
+                                                      row));
+                }
+            }
+            const int lastColumn = (chunkColumn < m_lodChunkColumns - 1) ? columns.size() - 1
+                                                                          : columns.size();
+            for (int j = 0; j < lastColumn; j++) {
+                int column = columns.at(j);
+                int lineStep = (j == 0) ? seamSteps[0] : step;
+                lodPositions(linePositions, chunk.y, chunk.endY, lineStep);
+                for (int i = 0; i < linePositions.size() - 1; i++) {
+                    gridIndices.append(lodVertexIndex(chunk, seamSteps, column,
+                                                      linePositions.at(i)));
+                    gridIndices.append(lodVertexIndex(chunk, seamSteps, column,
+                                                      linePositions.at(i + 1)));
+                }
+            }
+        }
+    }
+
+    m_indexCount = indices.size();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLint),
+                 indices.constData(), GL_DYNAMIC_DRAW);
+
+    m_gridIndexCount = gridIndices.size();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridElementbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_gridIndexCount * sizeof(GLint),
+                 gridIndices.constData(), GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+int SurfaceObject::lodVertexIndex(const LodChunk &chunk, const int *seamSteps, int column,
+                                  int row) const
+{
+    const int step = 1 << chunk.level;
+    if (row == chunk.y && seamSteps[2] > step)
+        column = lodSnap(column, chunk.x, chunk.endX, seamSteps[2]);
+    else if (row == chunk.endY && seamSteps[3] > step)
+        column = lodSnap(column, chunk.x, chunk.endX, seamSteps[3]);
+    if (column == chunk.x && seamSteps[0] > step)
+        row = lodSnap(row, chunk.y, chunk.endY, seamSteps[0]);
+    else if (column == chunk.endX && seamSteps[1] > step)
+        row = lodSnap(row, chunk.y, chunk.endY, seamSteps[1]);
+    return row * m_columns + column;
+}
+
+// Appends the two triangles of a quad the same way createSmoothIndices does, skipping
+// triangles collapsed by seam snapping
+void SurfaceObject::appendSmoothQuad(QVector<GLint> &indices, int bottomLeft, int bottomRight,
+                                     int topLeft, int topRight) const
+{
+    int triangles[6];
+    if ((m_dataDimension == BothAscending) || (m_dataDimension == BothDescending)) {
+        triangles[0] = bottomRight;
+        triangles[1] = topLeft;
+        triangles[2] = bottomLeft;
+        triangles[3] = topRight;
+        triangles[4] = topLeft;
+        triangles[5] = bottomRight;
+    } else {
+        triangles[0] = topLeft;
+        triangles[1] = topRight;
+        triangles[2] = bottomLeft;
+        triangles[3] = bottomLeft;
+        triangles[4] = topRight;
+        triangles[5] = bottomRight;
+    }
+
+    for (int i = 0; i < 6; i += 3) {
+        if (triangles[i] != triangles[i + 1] && triangles[i] != triangles[i + 2]
+                && triangles[i + 1] != triangles[i + 2]) {
+            indices.append(triangles[i]);
+            indices.append(triangles[i + 1]);
+            indices.append(triangles[i + 2]);
+        }
+    }
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -42,14 +42,18 @@
 
 #include "datavisualizationglobal_p.h"
 #include "abstractobjecthelper_p.h"
+#include "bufferuploadhelper_p.h"
 #include "qsurfacedataproxy.h"
 
 #include <QtCore/QRect>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector4D>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 class Surface3DRenderer;
 class AxisRenderCache;
+class SurfaceVertexJob;
 
 class SurfaceObject : public AbstractObjectHelper
 {
@@ -82,11 +86,17 @@ public:
     void updateSmoothRow(const QSurfaceDataArray &dataArray, int startRow, bool polar);
     void updateSmoothItem(const QSurfaceDataArray &dataArray, int row, int column, bool polar);
     void updateCoarseItem(const QSurfaceDataArray &dataArray, int row, int column, bool polar);
+    bool shiftRows(const QSurfaceDataArray &dataArray, int count, bool polar);
     void createSmoothIndices(int x, int y, int endX, int endY);
     void createCoarseSubSection(int x, int y, int columns, int rows);
     void createSmoothGridlineIndices(int x, int y, int endX, int endY);
     void createCoarseGridlineIndices(int x, int y, int endX, int endY);
     void uploadBuffers();
+    void uploadDirtyBuffers();
+    inline bool buffersDirty() const
+    {
+        return !m_dirtyVertexRows.isEmpty() || !m_dirtyNormalRows.isEmpty();
+    }
     GLuint gridElementBuf();
     GLuint uvBuf();
     GLuint gridIndexCount();
@@ -95,10 +105,44 @@ public:
     float minYValue() const { return m_minY; }
     float maxYValue() const { return m_maxY; }
     inline void activateSurfaceTexture(bool value) { m_returnTextureBuffer = value; }
+    void setLodThreshold(float pixels);
+    void updateLevelOfDetail(const QVector3D &cameraPosition, float pixelScale,
+                             bool perspective);
+    inline void setHeightfieldEnabled(bool enable) { m_heightfieldEnabled = enable; }
+    inline bool isHeightfieldEnabled() const { return m_heightfieldEnabled; }
+    inline bool isHeightfield() const { return m_heightfield; }
+    inline GLuint heightTexture() const { return m_heightTexture; }
+    inline const QVector4D &heightfieldRect() const { return m_heightfieldRect; }
+    inline QVector2D heightfieldSize() const { return QVector2D(m_columns, m_rows); }
+    GLuint heightfieldGridBuf();
 
 private:
+    // A square block of the smooth surface grid, drawn with its own tessellation level
+    struct LodChunk {
+        int x;
+        int y;
+        int endX;
+        int endY;
+        int level;
+        bool dirty;
+        QVector3D minBounds;
+        QVector3D maxBounds;
+        QVector<float> errors;
+    };
+
     void createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j);
     void createNormals(int &p, int row, int upperRow, int j);
+    void setUpVertices(SurfaceVertexJob *vertexJob);
+    int setUpBandSize() const;
+    void setUpSmoothVertexRows(const QSurfaceDataArray &dataArray, QVector3D *vertices,
+                               QVector2D *uvs, bool polar, bool flipXZ, int firstRow, int endRow,
+                               float &minY, float &maxY);
+    void setUpFlatVertexRows(const QSurfaceDataArray &dataArray, QVector3D *vertices,
+                             QVector2D *uvs, bool polar, bool flipXZ, int firstRow, int endRow,
+                             float &minY, float &maxY);
+    void createSmoothNormalRows(int firstRow, int endRow);
+    void createFlatNormalRows(GLint *indices, int firstRow, int endRow);
+    void createSmoothNormals();
     void createSmoothNormalBodyLine(int &totalIndex, int column);
     void createSmoothNormalUpperLine(int &totalIndex);
     QVector3D createSmoothNormalBodyLineItem(int x, int y);
@@ -106,9 +150,26 @@ private:
     QVector3D normal(const QVector3D &a, const QVector3D &b, const QVector3D &c);
     void createBuffers(const QVector<QVector3D> &vertices, const QVector<QVector2D> &uvs,
                        const QVector<QVector3D> &normals, const GLint *indices);
+    void createHeightfieldBuffers(const QVector<QVector2D> &uvs);
+    void uploadHeightRows(int startRow, int rowCount);
+    void deleteHeightTexture();
+    bool updateHeightfieldRect();
+    bool isHeightfieldRow(int row) const;
+    void leaveHeightfield();
     void checkDirections(const QSurfaceDataArray &array);
+    void markRowsDirty(QVector<int> &dirtyRows, int startRow, int endRow);
+    void clearDirtyRows();
+    void createLodChunks();
+    void updateLodChunk(LodChunk &chunk);
+    void markLodChunksDirty(int row, int column);
+    void createLodIndices();
+    int lodVertexIndex(const LodChunk &chunk, const int *seamSteps, int column, int row) const;
+    void appendSmoothQuad(QVector<GLint> &indices, int bottomLeft, int bottomRight,
+                          int topLeft, int topRight) const;
     inline void getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex, bool polar,
                                     bool flipXZ);
+    inline QVector3D normalizedVertex(const QSurfaceDataItem &data, bool polar,
+                                      bool flipXZ) const;
 
 private:
     SurfaceType m_surfaceType;
@@ -129,6 +190,24 @@ private:
     bool m_returnTextureBuffer;
     SurfaceObject::DataDimensions m_dataDimension;
     SurfaceObject::DataDimensions m_oldDataDimension;
+    QVector<int> m_dirtyVertexRows;
+    QVector<int> m_dirtyNormalRows;
+    BufferUploadHelper m_uploader;
+    float m_lodThreshold;
+    QVector<LodChunk> m_lodChunks;
+    int m_lodChunkColumns;
+    int m_lodChunkRows;
+    bool m_lodChunksDirty;
+    bool m_lodIndicesActive;
+    bool m_heightfieldEnabled;
+    bool m_heightfield;
+    GLuint m_heightTexture;
+    QVector4D m_heightfieldRect;
+
+    friend class SurfaceSmoothVertexJob;
+    friend class SurfaceFlatVertexJob;
+    friend class SurfaceSmoothNormalJob;
+    friend class SurfaceFlatNormalJob;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
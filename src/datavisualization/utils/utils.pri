@@ -9,7 +9,12 @@ HEADERS += $$PWD/meshloader_p.h \
            $$PWD/surfaceobject_p.h \
            $$PWD/qutils.h \
            $$PWD/scatterobjectbufferhelper_p.h \
-           $$PWD/scatterpointbufferhelper_p.h
+           $$PWD/scatterpointbufferhelper_p.h \
+           $$PWD/scatterinstancebufferhelper_p.h \
+           $$PWD/bufferuploadhelper_p.h \
+           $$PWD/parallelrangejob_p.h \
+           $$PWD/scatterspatialindex_p.h \
+           $$PWD/scatterdensitygrid_p.h
 
 SOURCES += $$PWD/meshloader.cpp \
            $$PWD/vertexindexer.cpp \
@@ -21,6 +26,11 @@ SOURCES += $$PWD/meshloader.cpp \
            $$PWD/abstractobjecthelper.cpp \
            $$PWD/surfaceobject.cpp \
            $$PWD/scatterobjectbufferhelper.cpp \
-           $$PWD/scatterpointbufferhelper.cpp
+           $$PWD/scatterpointbufferhelper.cpp \
+           $$PWD/scatterinstancebufferhelper.cpp \
+           $$PWD/bufferuploadhelper.cpp \
+           $$PWD/parallelrangejob.cpp \
+           $$PWD/scatterspatialindex.cpp \
+           $$PWD/scatterdensitygrid.cpp
 
 INCLUDEPATH += $$PWD
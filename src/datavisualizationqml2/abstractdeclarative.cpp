@@ -348,6 +348,8 @@ void AbstractDeclarative::setSharedController(Abstract3DController *controller)
                      &AbstractDeclarative::queriedGraphPositionChanged);
     QObject::connect(m_controller.data(), &Abstract3DController::marginChanged, this,
                      &AbstractDeclarative::marginChanged);
+    QObject::connect(m_controller.data(), &Abstract3DController::progressiveFrameBudgetChanged,
+                     this, &AbstractDeclarative::progressiveFrameBudgetChanged);
 }
 
 void AbstractDeclarative::activateOpenGLContext(QQuickWindow *window)
@@ -840,6 +842,16 @@ qreal AbstractDeclarative::margin() const
     return m_controller->margin();
 }
 
+void AbstractDeclarative::setProgressiveFrameBudget(int budget)
+{
+    m_controller->setProgressiveFrameBudget(budget);
+}
+
+int AbstractDeclarative::progressiveFrameBudget() const
+{
+    return m_controller->progressiveFrameBudget();
+}
+
 void AbstractDeclarative::windowDestroyed(QObject *obj)
 {
     // Remove destroyed window from window lists
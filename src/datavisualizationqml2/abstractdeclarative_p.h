@@ -91,6 +91,7 @@ class AbstractDeclarative : public QQuickItem
     Q_PROPERTY(QLocale locale READ locale WRITE setLocale NOTIFY localeChanged REVISION 2)
     Q_PROPERTY(QVector3D queriedGraphPosition READ queriedGraphPosition NOTIFY queriedGraphPositionChanged REVISION 2)
     Q_PROPERTY(qreal margin READ margin WRITE setMargin NOTIFY marginChanged REVISION 2)
+    Q_PROPERTY(int progressiveFrameBudget READ progressiveFrameBudget WRITE setProgressiveFrameBudget NOTIFY progressiveFrameBudgetChanged REVISION 3)
 
 public:
     enum SelectionFlag {
@@ -134,7 +135,8 @@ public:
 
     enum OptimizationHint {
         OptimizationDefault = 0,
-        OptimizationStatic  = 1
+        OptimizationStatic  = 1,
+        OptimizationInstanced = 2
     };
     Q_DECLARE_FLAGS(OptimizationHints, OptimizationHint)
 
@@ -235,6 +237,9 @@ public:
     void setMargin(qreal margin);
     qreal margin() const;
 
+    void setProgressiveFrameBudget(int budget);
+    int progressiveFrameBudget() const;
+
     QMutex *mutex() { return &m_mutex; }
 
 public Q_SLOTS:
@@ -285,6 +290,7 @@ Q_SIGNALS:
     Q_REVISION(2) void localeChanged(const QLocale &locale);
     Q_REVISION(2) void queriedGraphPositionChanged(const QVector3D &data);
     Q_REVISION(2) void marginChanged(qreal margin);
+    Q_REVISION(3) void progressiveFrameBudgetChanged(int budget);
 
 protected:
     QSharedPointer<QMutex> m_nodeMutex;
@@ -141,7 +141,16 @@ void QtDataVisualizationQml2Plugin::registerTypes(const char *uri)
     // QtDataVisualization 1.3
 
     // New revisions
+    qmlRegisterUncreatableType<AbstractDeclarative, 3>(uri, 1, 3, "AbstractGraph3D",
+                                                       QLatin1String("Trying to create uncreatable: AbstractGraph3D."));
     qmlRegisterType<Q3DLight, 1>(uri, 1, 3, "Light3D");
+    qmlRegisterUncreatableType<QScatter3DSeries, 1>(uri, 1, 3, "QScatter3DSeries",
+                                                    QLatin1String("Trying to create uncreatable: QScatter3DSeries, use Scatter3DSeries instead."));
+    qmlRegisterUncreatableType<QSurface3DSeries, 1>(uri, 1, 3, "QSurface3DSeries",
+                                                    QLatin1String("Trying to create uncreatable: QSurface3DSeries, use Surface3DSeries instead."));
+    qmlRegisterType<QItemModelBarDataProxy, 2>(uri, 1, 3, "ItemModelBarDataProxy");
+    qmlRegisterType<QItemModelSurfaceDataProxy, 2>(uri, 1, 3, "ItemModelSurfaceDataProxy");
+    qmlRegisterType<QItemModelScatterDataProxy, 2>(uri, 1, 3, "ItemModelScatterDataProxy");
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -32,6 +32,7 @@
 #include <QtDataVisualization/QItemModelBarDataProxy>
 #include <QtDataVisualization/Q3DBars>
 #include <QtWidgets/QTableWidget>
+#include <QtGui/QStandardItemModel>
 
 using namespace QtDataVisualization;
 
@@ -51,6 +52,8 @@ private slots:
     void initializeProperties();
 
     void multiMatch();
+    void asynchronous();
+    void incrementalUpdates();
 
 private:
     QItemModelBarDataProxy *m_proxy;
@@ -162,6 +165,7 @@ void tst_proxy::initialProperties()
     QCOMPARE(m_proxy->valueRole(), QString());
     QCOMPARE(m_proxy->valueRolePattern(), QRegExp());
     QCOMPARE(m_proxy->valueRoleReplace(), QString());
+    QCOMPARE(m_proxy->isAsynchronous(), false);
 
     QCOMPARE(m_proxy->columnLabels().count(), 0);
     QCOMPARE(m_proxy->rowCount(), 0);
@@ -276,5 +280,100 @@ void tst_proxy::multiMatch()
     m_proxy = 0; // Proxy gets deleted as graph gets deleted
 }
 
+void tst_proxy::asynchronous()
+{
+    QTableWidget table;
+    table.setRowCount(2);
+    table.setColumnCount(3);
+    for (int row = 0; row < 2; row++) {
+        for (int col = 0; col < 3; col++) {
+            QModelIndex index = table.model()->index(row, col);
+            table.model()->setData(index, QString::number(row * 3 + col));
+        }
+    }
+
+    QSignalSpy asyncSpy(m_proxy, &QItemModelBarDataProxy::asynchronousChanged);
+    m_proxy->setAsynchronous(true);
+    QCOMPARE(asyncSpy.size(), 1);
+    QCOMPARE(m_proxy->isAsynchronous(), true);
+
+    QSignalSpy resetSpy(m_proxy, &QBarDataProxy::arrayReset);
+    m_proxy->setUseModelCategories(true);
+    m_proxy->setItemModel(table.model());
+
+    QVERIFY(resetSpy.wait());
+    QCOMPARE(resetSpy.size(), 1);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->columnLabels().count(), 3);
+    QCOMPARE(m_proxy->itemAt(1, 2)->value(), 5.0f);
+
+    // A model change while resolving cancels the resolve in progress, and only the
+    // resolve of the latest data ends up in the proxy
+    table.setColumnCount(4);
+    QCoreApplication::processEvents();
+    table.setRowCount(3);
+
+    QTRY_COMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->columnLabels().count(), 4);
+}
+
+void tst_proxy::incrementalUpdates()
+{
+    QStandardItemModel model;
+    model.appendRow(new QStandardItem(QStringLiteral("0/0/1/0")));
+    model.appendRow(new QStandardItem(QStringLiteral("1/0/2/0")));
+    model.appendRow(new QStandardItem(QStringLiteral("0/1/3/0")));
+    model.appendRow(new QStandardItem(QStringLiteral("1/1/4/0")));
+
+    m_proxy->setItemModel(&model);
+    m_proxy->setRowRole(model.roleNames().value(Qt::DisplayRole));
+    m_proxy->setColumnRole(model.roleNames().value(Qt::DisplayRole));
+    m_proxy->setRowRolePattern(QRegExp(QStringLiteral("^(\\d*)\\/(\\d*)\\/\\d*[\\.\\,]?\\d*\\/\\d*[\\.\\,]?\\d*$")));
+    m_proxy->setRowRoleReplace(QStringLiteral("\\2"));
+    m_proxy->setValueRolePattern(QRegExp(QStringLiteral("^\\d*(\\/)(\\d*)\\/(\\d*[\\.\\,]?\\d*)\\/\\d*[\\.\\,]?\\d*$")));
+    m_proxy->setValueRoleReplace(QStringLiteral("\\3"));
+    m_proxy->setColumnRolePattern(QRegExp(QStringLiteral("^(\\d*)(\\/)(\\d*)\\/\\d*[\\.\\,]?\\d*\\/\\d*[\\.\\,]?\\d*$")));
+    m_proxy->setColumnRoleReplace(QStringLiteral("\\1"));
+
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->columnLabels().count(), 2);
+    QCOMPARE(m_proxy->itemAt(1, 1)->value(), 4.0f);
+
+    QSignalSpy resetSpy(m_proxy, &QBarDataProxy::arrayReset);
+    QSignalSpy itemSpy(m_proxy, &QBarDataProxy::itemChanged);
+
+    // Changes that keep the categories are applied to the affected bars only
+    model.item(3)->setText(QStringLiteral("1/1/8/0"));
+    QCOMPARE(itemSpy.size(), 1);
+    QCOMPARE(m_proxy->itemAt(1, 1)->value(), 8.0f);
+
+    model.appendRow(new QStandardItem(QStringLiteral("0/0/5/0")));
+    QCOMPARE(m_proxy->itemAt(0, 0)->value(), 5.0f);
+    model.removeRow(4);
+    QCOMPARE(m_proxy->itemAt(0, 0)->value(), 1.0f);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(resetSpy.size(), 0);
+
+    // New categories need the whole model to be resolved again
+    model.item(0)->setText(QStringLiteral("2/0/1/0"));
+    QCoreApplication::processEvents();
+    QCOMPARE(resetSpy.size(), 1);
+    QCOMPARE(m_proxy->columnLabels().count(), 3);
+
+    // So do changes to the order in which the categories first appear
+    model.item(1)->setText(QStringLiteral("0/0/2/0"));
+    QCoreApplication::processEvents();
+    QCOMPARE(resetSpy.size(), 2);
+    QCOMPARE(m_proxy->columnLabels().at(1), QStringLiteral("0"));
+
+    // And removing the last item of a category
+    model.removeRow(0);
+    QCoreApplication::processEvents();
+    QCOMPARE(resetSpy.size(), 3);
+    QCOMPARE(m_proxy->columnLabels().count(), 2);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
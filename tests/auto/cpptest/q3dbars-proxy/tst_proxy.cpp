@@ -47,6 +47,7 @@ private slots:
 
     void initialProperties();
     void initializeProperties();
+    void shiftRows();
 
 private:
     QBarDataProxy *m_proxy;
@@ -104,5 +105,42 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->rowLabels().count(), 1);
 }
 
+void tst_proxy::shiftRows()
+{
+    QVERIFY(m_proxy);
+
+    for (int i = 0; i < 3; i++) {
+        QBarDataRow *data = new QBarDataRow;
+        *data << float(i) << float(i);
+        m_proxy->addRow(data, QString::number(i));
+    }
+
+    QSignalSpy shiftSpy(m_proxy, &QBarDataProxy::rowsShifted);
+    QSignalSpy resetSpy(m_proxy, &QBarDataProxy::arrayReset);
+
+    QBarDataRow *data = new QBarDataRow;
+    *data << 3.0f << 3.0f;
+    m_proxy->shiftRow(data, QStringLiteral("3"));
+
+    QCOMPARE(shiftSpy.size(), 1);
+    QCOMPARE(shiftSpy.at(0).at(0).toInt(), 1);
+    QCOMPARE(resetSpy.size(), 0);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->value(), 1.0f);
+    QCOMPARE(m_proxy->itemAt(2, 0)->value(), 3.0f);
+    QCOMPARE(m_proxy->rowLabels(), QStringList() << "1" << "2" << "3");
+
+    // Shifting in at least as many rows as there are replaces the whole array
+    QBarDataArray rows;
+    for (int i = 0; i < 3; i++)
+        rows << new QBarDataRow(2, QBarDataItem(float(i + 4)));
+    m_proxy->shiftRows(rows);
+
+    QCOMPARE(shiftSpy.size(), 1);
+    QCOMPARE(resetSpy.size(), 1);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->value(), 4.0f);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -58,6 +58,8 @@ private slots:
     void removeSeries();
     void removeMultipleSeries();
 
+    void autoAdjustRanges();
+
     // The following tests are not required for scatter or surface, as they are handled identically
     void addInputHandler();
     void removeInputHandler();
@@ -146,6 +148,7 @@ void tst_bars::initialProperties()
     QCOMPARE(m_graph->locale(), QLocale("C"));
     QCOMPARE(m_graph->queriedGraphPosition(), QVector3D(0, 0, 0));
     QCOMPARE(m_graph->margin(), -1.0);
+    QCOMPARE(m_graph->progressiveFrameBudget(), 0);
 }
 
 void tst_bars::initializeProperties()
@@ -180,6 +183,7 @@ void tst_bars::initializeProperties()
     m_graph->setReflectivity(0.1);
     m_graph->setLocale(QLocale("FI"));
     m_graph->setMargin(1.0);
+    m_graph->setProgressiveFrameBudget(16);
 
     QCOMPARE(m_graph->activeTheme()->type(), Q3DTheme::ThemeDigia);
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionItem | QAbstract3DGraph::SelectionRow | QAbstract3DGraph::SelectionSlice);
@@ -195,6 +199,7 @@ void tst_bars::initializeProperties()
     QCOMPARE(m_graph->reflectivity(), 0.1);
     QCOMPARE(m_graph->locale(), QLocale("FI"));
     QCOMPARE(m_graph->margin(), 1.0);
+    QCOMPARE(m_graph->progressiveFrameBudget(), 16);
 }
 
 void tst_bars::invalidProperties()
@@ -204,12 +209,15 @@ void tst_bars::invalidProperties()
     m_graph->setHorizontalAspectRatio(-1.0);
     m_graph->setReflectivity(-1.0);
     m_graph->setLocale(QLocale("XX"));
+    QTest::ignoreMessage(QtWarningMsg, "Invalid budget. progressiveFrameBudget cannot be negative");
+    m_graph->setProgressiveFrameBudget(-1);
 
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionItem);
     QCOMPARE(m_graph->aspectRatio(), -1.0/*2.0*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->horizontalAspectRatio(), -1.0/*0.0*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->reflectivity(), -1.0/*0.5*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->locale(), QLocale("C"));
+    QCOMPARE(m_graph->progressiveFrameBudget(), 0);
 }
 
 void tst_bars::addSeries()
@@ -295,6 +303,43 @@ void tst_bars::removeMultipleSeries()
     delete series3;
 }
 
+void tst_bars::autoAdjustRanges()
+{
+    QBar3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+
+    QCOMPARE(m_graph->valueAxis()->min(), -1.0f);
+    QCOMPARE(m_graph->valueAxis()->max(), 7.5f);
+
+    // Replacing the row that holds both extremes shrinks the range back to zero
+    QBarDataRow *row = new QBarDataRow;
+    *row << 1.0f << 3.0f << 4.0f << 5.0f << 2.2f;
+    series->dataProxy()->setRow(0, row);
+    QCOMPARE(m_graph->valueAxis()->min(), 0.0f);
+    QCOMPARE(m_graph->valueAxis()->max(), 5.0f);
+
+    row = new QBarDataRow;
+    *row << -2.5f << 9.0f;
+    series->dataProxy()->addRow(row);
+    QCOMPARE(m_graph->valueAxis()->min(), -2.5f);
+    QCOMPARE(m_graph->valueAxis()->max(), 9.0f);
+
+    series->dataProxy()->setItem(0, 3, QBarDataItem(11.0f));
+    QCOMPARE(m_graph->valueAxis()->max(), 11.0f);
+
+    // Removing the rows of the extremes
+    series->dataProxy()->removeRows(1, 1);
+    QCOMPARE(m_graph->valueAxis()->min(), 0.0f);
+    QCOMPARE(m_graph->valueAxis()->max(), 11.0f);
+    series->dataProxy()->setItem(0, 3, QBarDataItem(5.0f));
+    QCOMPARE(m_graph->valueAxis()->max(), 5.0f);
+
+    // An empty array defaults to a unit range from zero
+    series->dataProxy()->removeRows(0, 1);
+    QCOMPARE(m_graph->valueAxis()->min(), 0.0f);
+    QCOMPARE(m_graph->valueAxis()->max(), 1.0f);
+}
+
 // The following tests are not required for scatter or surface, as they are handled identically
 void tst_bars::addInputHandler()
 {
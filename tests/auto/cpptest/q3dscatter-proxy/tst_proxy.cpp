@@ -48,6 +48,8 @@ private slots:
     void initialProperties();
     void initializeProperties();
 
+    void externalBuffers();
+
 private:
     QScatterDataProxy *m_proxy;
 };
@@ -98,5 +100,34 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->itemCount(), 2);
 }
 
+void tst_proxy::externalBuffers()
+{
+    QVERIFY(m_proxy);
+
+    const float xValues[] = { 0.5f, -0.3f, 1.0f };
+    const float yValues[] = { 0.5f, -0.5f, 2.0f };
+    const float zValues[] = { 0.5f, -0.4f, 3.0f };
+    m_proxy->resetArray(xValues, yValues, zValues, 3);
+
+    QCOMPARE(m_proxy->itemCount(), 3);
+
+    // Reading the items doesn't copy the buffers
+    QCOMPARE(m_proxy->itemValueAt(2).position(), QVector3D(1.0f, 2.0f, 3.0f));
+    QCOMPARE(m_proxy->itemValueAt(1).position(), QVector3D(-0.3f, -0.5f, -0.4f));
+    QVERIFY(m_proxy->itemValueAt(1).rotation().isIdentity());
+    QVERIFY(!m_proxy->itemAt(1));
+    QCOMPARE(m_proxy->array()->size(), 0);
+
+    // Modifying the data copies the buffers into the array
+    m_proxy->addItem(QScatterDataItem(QVector3D(4.0f, 5.0f, 6.0f)));
+    QCOMPARE(m_proxy->itemCount(), 4);
+    QCOMPARE(m_proxy->array()->size(), 4);
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(-0.3f, -0.5f, -0.4f));
+    QCOMPARE(m_proxy->itemAt(3)->position(), QVector3D(4.0f, 5.0f, 6.0f));
+
+    m_proxy->resetArray(xValues, yValues, zValues, 0);
+    QCOMPARE(m_proxy->itemCount(), 0);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -91,6 +91,10 @@ void tst_series::initialProperties()
     QVERIFY(m_series->dataProxy());
     QCOMPARE(m_series->itemSize(), 0.0f);
     QCOMPARE(m_series->selectedItem(), m_series->invalidSelectionIndex());
+    QCOMPARE(m_series->lodThreshold(), 0.0f);
+    QCOMPARE(m_series->lodPointThreshold(), 0.0f);
+    QCOMPARE(m_series->renderingMode(), QScatter3DSeries::RenderingModeItems);
+    QCOMPARE(m_series->densityResolution(), 64);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     QCOMPARE(m_series->itemLabelFormat(), QString("@xLabel, @yLabel, @zLabel"));
@@ -109,6 +113,27 @@ void tst_series::initializeProperties()
     QCOMPARE(m_series->itemSize(), 0.5f);
     QCOMPARE(m_series->selectedItem(), 0);
 
+    QSignalSpy lodSpy(m_series, &QScatter3DSeries::lodThresholdChanged);
+    m_series->setLodThreshold(20.0f);
+    m_series->setLodPointThreshold(4.0f);
+    m_series->setLodThreshold(20.0f);
+    QCOMPARE(m_series->lodThreshold(), 20.0f);
+    QCOMPARE(m_series->lodPointThreshold(), 4.0f);
+    QCOMPARE(lodSpy.count(), 1);
+
+    QTest::ignoreMessage(QtWarningMsg, "Invalid threshold. lodThreshold cannot be negative");
+    m_series->setLodThreshold(-1.0f);
+    QCOMPARE(m_series->lodThreshold(), 20.0f);
+
+    m_series->setRenderingMode(QScatter3DSeries::RenderingModeDensity);
+    m_series->setDensityResolution(128);
+    QCOMPARE(m_series->renderingMode(), QScatter3DSeries::RenderingModeDensity);
+    QCOMPARE(m_series->densityResolution(), 128);
+
+    QTest::ignoreMessage(QtWarningMsg, "Invalid resolution. densityResolution must be between 4 and 256");
+    m_series->setDensityResolution(512);
+    QCOMPARE(m_series->densityResolution(), 128);
+
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     m_series->setMesh(QAbstract3DSeries::MeshPoint);
     m_series->setMeshRotation(QQuaternion(1, 1, 10, 20));
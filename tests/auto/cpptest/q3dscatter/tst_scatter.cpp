@@ -48,6 +48,7 @@ private slots:
     void initialProperties();
     void initializeProperties();
     void invalidProperties();
+    void instancedOptimization();
 
     void addSeries();
     void addMultipleSeries();
@@ -55,6 +56,8 @@ private slots:
     void removeSeries();
     void removeMultipleSeries();
 
+    void autoAdjustRanges();
+
 private:
     Q3DScatter *m_graph;
 };
@@ -125,6 +128,7 @@ void tst_scatter::initialProperties()
     QCOMPARE(m_graph->locale(), QLocale("C"));
     QCOMPARE(m_graph->queriedGraphPosition(), QVector3D(0, 0, 0));
     QCOMPARE(m_graph->margin(), -1.0);
+    QCOMPARE(m_graph->progressiveFrameBudget(), 0);
 }
 
 void tst_scatter::initializeProperties()
@@ -145,6 +149,7 @@ void tst_scatter::initializeProperties()
     m_graph->setReflectivity(0.1);
     m_graph->setLocale(QLocale("FI"));
     m_graph->setMargin(1.0);
+    m_graph->setProgressiveFrameBudget(16);
 
     QCOMPARE(m_graph->activeTheme()->type(), Q3DTheme::ThemeDigia);
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionNone);
@@ -160,6 +165,7 @@ void tst_scatter::initializeProperties()
     QCOMPARE(m_graph->reflectivity(), 0.1);
     QCOMPARE(m_graph->locale(), QLocale("FI"));
     QCOMPARE(m_graph->margin(), 1.0);
+    QCOMPARE(m_graph->progressiveFrameBudget(), 16);
 }
 
 void tst_scatter::invalidProperties()
@@ -169,12 +175,37 @@ void tst_scatter::invalidProperties()
     m_graph->setHorizontalAspectRatio(-1.0);
     m_graph->setReflectivity(-1.0);
     m_graph->setLocale(QLocale("XX"));
+    QTest::ignoreMessage(QtWarningMsg, "Invalid budget. progressiveFrameBudget cannot be negative");
+    m_graph->setProgressiveFrameBudget(-1);
 
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionItem);
     QCOMPARE(m_graph->aspectRatio(), -1.0/*2.0*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->horizontalAspectRatio(), -1.0/*0.0*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->reflectivity(), -1.0/*0.5*/); // TODO: Fix once QTRD-3367 is done
     QCOMPARE(m_graph->locale(), QLocale("C"));
+    QCOMPARE(m_graph->progressiveFrameBudget(), 0);
+}
+
+void tst_scatter::instancedOptimization()
+{
+    QSignalSpy spy(m_graph, &QAbstract3DGraph::optimizationHintsChanged);
+
+    m_graph->setOptimizationHints(QAbstract3DGraph::OptimizationInstanced);
+    QCOMPARE(m_graph->optimizationHints(), QAbstract3DGraph::OptimizationInstanced);
+    QCOMPARE(spy.count(), 1);
+
+    // Instanced rendering is independent of the data, items can be added and changed freely
+    QScatter3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    series->dataProxy()->setItem(0, QScatterDataItem(QVector3D(1.0f, 1.0f, 1.0f)));
+    series->setMeshRotation(QQuaternion::fromAxisAndAngle(0.0f, 1.0f, 0.0f, 45.0f));
+    QCOMPARE(m_graph->seriesList().length(), 1);
+
+    QAbstract3DGraph::OptimizationHints hints(QAbstract3DGraph::OptimizationInstanced
+                                              | QAbstract3DGraph::OptimizationStatic);
+    m_graph->setOptimizationHints(hints);
+    QCOMPARE(m_graph->optimizationHints(), hints);
+    QCOMPARE(spy.count(), 2);
 }
 
 void tst_scatter::addSeries()
@@ -251,5 +282,36 @@ void tst_scatter::removeMultipleSeries()
     delete series3;
 }
 
+void tst_scatter::autoAdjustRanges()
+{
+    QScatter3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+
+    QCOMPARE(m_graph->axisX()->min(), -0.3f);
+    QCOMPARE(m_graph->axisX()->max(), 0.5f);
+    QCOMPARE(m_graph->axisY()->min(), -0.5f);
+    QCOMPARE(m_graph->axisY()->max(), 0.5f);
+
+    series->dataProxy()->setItem(1, QScatterDataItem(QVector3D(-2.0f, -3.0f, -0.4f)));
+    QCOMPARE(m_graph->axisX()->min(), -2.0f);
+    QCOMPARE(m_graph->axisY()->min(), -3.0f);
+
+    // Overwriting the extremes shrinks the range back
+    series->dataProxy()->setItem(1, QScatterDataItem(QVector3D(-0.3f, -0.5f, -0.4f)));
+    QCOMPARE(m_graph->axisX()->min(), -0.3f);
+    QCOMPARE(m_graph->axisY()->min(), -0.5f);
+
+    // Removing the item that holds the maximums
+    series->dataProxy()->removeItems(0, 1);
+    QCOMPARE(m_graph->axisX()->max(), 0.0f);
+    QCOMPARE(m_graph->axisY()->max(), -0.3f);
+    QCOMPARE(m_graph->axisZ()->max(), 0.2f);
+
+    // An empty array defaults to a unit range around zero
+    series->dataProxy()->removeItems(0, 2);
+    QCOMPARE(m_graph->axisY()->min(), -1.0f);
+    QCOMPARE(m_graph->axisY()->max(), 1.0f);
+}
+
 QTEST_MAIN(tst_scatter)
 #include "tst_scatter.moc"
@@ -48,6 +48,8 @@ private slots:
     void initialProperties();
     void initializeProperties();
     void invalidProperties();
+    void resolveLargeHeightMap();
+    void rawHeightMapFile();
 
 private:
     QHeightMapSurfaceDataProxy *m_proxy;
@@ -165,5 +167,58 @@ void tst_proxy::invalidProperties()
     QCOMPARE(m_proxy->minZValue(), 10.0f);
 }
 
+void tst_proxy::resolveLargeHeightMap()
+{
+    // Large enough to be resolved in the background, over several bands
+    QImage image(QSize(600, 600), QImage::Format_Grayscale8);
+    image.fill(0);
+    for (int i = 0; i < image.height(); i++)
+        image.scanLine(i)[0] = uchar(i % 256);
+
+    QSignalSpy spy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    m_proxy->setHeightMap(image);
+
+    QVERIFY(spy.wait());
+    QCOMPARE(m_proxy->columnCount(), 600);
+    QCOMPARE(m_proxy->rowCount(), 600);
+
+    // Data rows run from the bottom of the image upwards
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), float(599 % 256));
+    QCOMPARE(m_proxy->itemAt(599, 0)->y(), 0.0f);
+    QCOMPARE(m_proxy->itemAt(0, 599)->x(), m_proxy->maxXValue());
+    QCOMPARE(m_proxy->itemAt(599, 0)->z(), m_proxy->maxZValue());
+}
+
+void tst_proxy::rawHeightMapFile()
+{
+    // Two lines of three little-endian 16-bit samples after a four byte header
+    const uchar rawData[] = { 0xde, 0xad, 0xbe, 0xef,
+                              0x01, 0x00, 0x02, 0x00, 0x00, 0x80,
+                              0x04, 0x00, 0x05, 0x00, 0xff, 0xff };
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(reinterpret_cast<const char *>(rawData), sizeof(rawData));
+    file.flush();
+
+    QVERIFY(!m_proxy->setRawHeightMapFile(file.fileName(), 3, 3,
+                                           QHeightMapSurfaceDataProxy::RawDataInt16, 4));
+    QVERIFY(m_proxy->setRawHeightMapFile(file.fileName(), 3, 2,
+                                          QHeightMapSurfaceDataProxy::RawDataInt16, 4,
+                                          0.5f, -32768.0f));
+
+    QCoreApplication::processEvents();
+
+    QCOMPARE(m_proxy->columnCount(), 3);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QVERIFY(m_proxy->heightMap().isNull());
+
+    // First line of the file is the last data row
+    QCOMPARE(m_proxy->itemAt(1, 0)->y(), 0.5f);
+    QCOMPARE(m_proxy->itemAt(1, 1)->y(), 1.0f);
+    QCOMPARE(m_proxy->itemAt(1, 2)->y(), 0.0f);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 2.0f);
+    QCOMPARE(m_proxy->itemAt(0, 2)->y(), -0.5f);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -48,6 +48,8 @@ private slots:
     void initialProperties();
     void initializeProperties();
 
+    void shiftRows();
+
 private:
     QSurfaceDataProxy *m_proxy;
 };
@@ -105,5 +107,46 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->rowCount(), 2);
 }
 
+void tst_proxy::shiftRows()
+{
+    QVERIFY(m_proxy);
+
+    QSurfaceDataArray *data = new QSurfaceDataArray;
+    for (int i = 0; i < 3; i++) {
+        QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+        *dataRow << QVector3D(0.0f, float(i), float(i)) << QVector3D(1.0f, float(i), float(i));
+        *data << dataRow;
+    }
+    m_proxy->resetArray(data);
+
+    QSignalSpy shiftSpy(m_proxy, &QSurfaceDataProxy::rowsShifted);
+    QSignalSpy resetSpy(m_proxy, &QSurfaceDataProxy::arrayReset);
+
+    QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+    *dataRow << QVector3D(0.0f, 3.0f, 3.0f) << QVector3D(1.0f, 3.0f, 3.0f);
+    m_proxy->shiftRow(dataRow);
+
+    QCOMPARE(shiftSpy.size(), 1);
+    QCOMPARE(shiftSpy.at(0).at(0).toInt(), 1);
+    QCOMPARE(resetSpy.size(), 0);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->z(), 1.0f);
+    QCOMPARE(m_proxy->itemAt(2, 1)->y(), 3.0f);
+
+    // Shifting in as many rows as the array holds resets it
+    QSurfaceDataArray rows;
+    for (int i = 0; i < 3; i++) {
+        QSurfaceDataRow *newRow = new QSurfaceDataRow;
+        *newRow << QVector3D(0.0f, 5.0f, float(i)) << QVector3D(1.0f, 5.0f, float(i));
+        rows << newRow;
+    }
+    m_proxy->shiftRows(rows);
+
+    QCOMPARE(shiftSpy.size(), 1);
+    QCOMPARE(resetSpy.size(), 1);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 5.0f);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -94,6 +94,8 @@ void tst_series::initialProperties()
     QCOMPARE(m_series->isFlatShadingEnabled(), true);
     QCOMPARE(m_series->isFlatShadingSupported(), true);
     QCOMPARE(m_series->selectedPoint(), m_series->invalidSelectionPosition());
+    QCOMPARE(m_series->lodThreshold(), 0.0f);
+    QCOMPARE(m_series->isHeightfieldRenderingEnabled(), false);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     QCOMPARE(m_series->itemLabelFormat(), QString("@xLabel, @yLabel, @zLabel"));
@@ -109,10 +111,14 @@ void tst_series::initializeProperties()
     m_series->setDrawMode(QSurface3DSeries::DrawWireframe);
     m_series->setFlatShadingEnabled(false);
     m_series->setSelectedPoint(QPoint(0, 0));
+    m_series->setLodThreshold(2.0f);
+    m_series->setHeightfieldRenderingEnabled(true);
 
     QCOMPARE(m_series->drawMode(), QSurface3DSeries::DrawWireframe);
     QCOMPARE(m_series->isFlatShadingEnabled(), false);
     QCOMPARE(m_series->selectedPoint(), QPoint(0, 0));
+    QCOMPARE(m_series->lodThreshold(), 2.0f);
+    QCOMPARE(m_series->isHeightfieldRenderingEnabled(), true);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     m_series->setMesh(QAbstract3DSeries::MeshPyramid);
@@ -123,8 +129,10 @@ void tst_series::initializeProperties()
 void tst_series::invalidProperties()
 {
     m_series->setMesh(QAbstract3DSeries::MeshPoint);
+    m_series->setLodThreshold(-1.0f);
 
     QCOMPARE(m_series->mesh(), QAbstract3DSeries::MeshSphere);
+    QCOMPARE(m_series->lodThreshold(), 0.0f);
 }
 
 QTEST_MAIN(tst_series)
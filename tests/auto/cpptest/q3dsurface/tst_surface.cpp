@@ -55,6 +55,8 @@ private slots:
     void removeSeries();
     void removeMultipleSeries();
 
+    void autoAdjustRanges();
+
 private:
     Q3DSurface *m_graph;
 };
@@ -261,5 +263,44 @@ void tst_surface::removeMultipleSeries()
     delete series3;
 }
 
+void tst_surface::autoAdjustRanges()
+{
+    QSurface3DSeries *series = new QSurface3DSeries;
+    QSurfaceDataArray *data = new QSurfaceDataArray;
+    QSurfaceDataRow *dataRow1 = new QSurfaceDataRow;
+    QSurfaceDataRow *dataRow2 = new QSurfaceDataRow;
+    QSurfaceDataRow *dataRow3 = new QSurfaceDataRow;
+    *dataRow1 << QVector3D(0.0f, 1.0f, 0.0f) << QVector3D(1.0f, 2.0f, 0.0f);
+    *dataRow2 << QVector3D(0.0f, 3.0f, 1.0f) << QVector3D(1.0f, 0.5f, 1.0f);
+    *dataRow3 << QVector3D(0.0f, -1.0f, 2.0f) << QVector3D(1.0f, 4.0f, 2.0f);
+    *data << dataRow1 << dataRow2 << dataRow3;
+    series->dataProxy()->resetArray(data);
+    m_graph->addSeries(series);
+
+    QCOMPARE(m_graph->axisY()->min(), -1.0f);
+    QCOMPARE(m_graph->axisY()->max(), 4.0f);
+
+    // Replacing the row that holds both extremes shrinks the range
+    QSurfaceDataRow *newRow = new QSurfaceDataRow;
+    *newRow << QVector3D(0.0f, 1.5f, 2.0f) << QVector3D(1.0f, 2.5f, 2.0f);
+    series->dataProxy()->setRow(2, newRow);
+    QCOMPARE(m_graph->axisY()->min(), 0.5f);
+    QCOMPARE(m_graph->axisY()->max(), 3.0f);
+
+    series->dataProxy()->setItem(0, 0, QSurfaceDataItem(QVector3D(0.0f, -2.0f, 0.0f)));
+    QCOMPARE(m_graph->axisY()->min(), -2.0f);
+    QCOMPARE(m_graph->axisY()->max(), 3.0f);
+
+    // Removing the rows of the extremes
+    series->dataProxy()->removeRows(0, 2);
+    QCOMPARE(m_graph->axisY()->min(), 1.5f);
+    QCOMPARE(m_graph->axisY()->max(), 2.5f);
+
+    // An empty array defaults to a unit range around zero
+    series->dataProxy()->removeRows(0, 1);
+    QCOMPARE(m_graph->axisY()->min(), -1.0f);
+    QCOMPARE(m_graph->axisY()->max(), 1.0f);
+}
+
 QTEST_MAIN(tst_surface)
 #include "tst_surface.moc"